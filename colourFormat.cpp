@@ -0,0 +1,116 @@
+#include "colourFormat.h"
+
+#include <stdint.h>
+
+struct ColourTables {
+	wxByte _up[8][256];
+	wxByte _down[8][256];
+	wxByte _shift[8][256];
+
+	ColourTables() {
+		for (int d = 1; d <= 8; d++) {
+			int max = (1 << d) - 1;
+			for (int v = 0; v < 256; v++) {
+				// Both directions round to the nearest value, the same as adding a half and truncating
+				int raw = v & max;
+				_up[d - 1][v] = ((raw * 255 * 2) + max) / (max * 2);
+				_down[d - 1][v] = ((v * max * 2) + 255) / (255 * 2);
+				_shift[d - 1][v] = raw << (8 - d);
+			}
+		}
+	}
+};
+
+static const ColourTables tables;
+
+static inline int clampDepth(int bitDepth) {
+	return (bitDepth < 1) ? 1 : ((bitDepth > 8) ? 8 : bitDepth);
+}
+
+wxByte colourUp(int bitDepth, int value) {
+	return tables._up[clampDepth(bitDepth) - 1][value & 0xFF];
+}
+
+wxByte colourDown(int bitDepth, int value) {
+	return tables._down[clampDepth(bitDepth) - 1][value & 0xFF];
+}
+
+wxByte colourShift(int bitDepth, int value) {
+	return tables._shift[clampDepth(bitDepth) - 1][value & 0xFF];
+}
+
+// A colour is at most 24 bits, so all of it fits in one value
+void decodeColours(const ColourFormat &format, const wxByte *data, int count, wxByte *raw) {
+	int depth = clampDepth(format._bitDepth);
+	int size = format.byteSize();
+	uint32_t mask = (1 << depth) - 1;
+	int first = (format._order == kColourRGB) ? 0 : 2;
+
+	for (int i = 0; i < count; i++) {
+		const wxByte *colour = &data[i * size];
+		uint32_t value = colour[0];
+		if (size > 1) {
+			value |= (uint32_t) colour[1] << 8;
+		}
+		if (size > 2) {
+			value |= (uint32_t) colour[2] << 16;
+		}
+
+		raw[(i * 3) + first]     = value & mask;
+		raw[(i * 3) + 1]         = (value >> depth) & mask;
+		raw[(i * 3) + 2 - first] = (value >> (depth * 2)) & mask;
+	}
+}
+
+void encodeColours(const ColourFormat &format, const wxByte *raw, int count, wxByte *data) {
+	int depth = clampDepth(format._bitDepth);
+	int size = format.byteSize();
+	uint32_t mask = (1 << depth) - 1;
+	int first = (format._order == kColourRGB) ? 0 : 2;
+
+	for (int i = 0; i < count; i++) {
+		uint32_t value = (raw[(i * 3) + first] & mask)
+					   | ((raw[(i * 3) + 1] & mask) << depth)
+					   | ((raw[(i * 3) + 2 - first] & mask) << (depth * 2));
+
+		wxByte *colour = &data[i * size];
+		for (int b = 0; b < size; b++) {
+			colour[b] = (value >> (b * 8)) & 0xFF;
+		}
+	}
+}
+
+void expandColours(const ColourFormat &format, const wxByte *raw, int count, wxByte *rgb) {
+	const wxByte *up = tables._up[clampDepth(format._bitDepth) - 1];
+	for (int i = 0; i < (count * 3); i++) {
+		rgb[i] = up[raw[i]];
+	}
+}
+
+void reduceColours(const ColourFormat &format, const wxByte *rgb, int count, wxByte *raw) {
+	const wxByte *down = tables._down[clampDepth(format._bitDepth) - 1];
+	for (int i = 0; i < (count * 3); i++) {
+		raw[i] = down[rgb[i]];
+	}
+}
+
+void shiftColours(const ColourFormat &format, const wxByte *raw, int count, wxByte *rgb) {
+	const wxByte *shift = tables._shift[clampDepth(format._bitDepth) - 1];
+	for (int i = 0; i < (count * 3); i++) {
+		rgb[i] = shift[raw[i]];
+	}
+}
+
+void blendColours(wxByte *rgb, int count, const wxByte *target, int fromPercent, int toPercent) {
+	for (int i = 0; i < count; i++) {
+		int percent = fromPercent;
+		if (count > 1) {
+			percent += ((toPercent - fromPercent) * i) / (count - 1);
+		}
+
+		for (int c = 0; c < 3; c++) {
+			int value = rgb[(i * 3) + c];
+			rgb[(i * 3) + c] = value + ((((int) target[c] - value) * percent) / 100);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#ifndef HEXER_COLOURFORMAT_H
+#define HEXER_COLOURFORMAT_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+// Which channel is in the lowest bits of a colour
+enum ColourOrder {
+	kColourRGB,								// Red first, the way the palette view has always read colours
+	kColourBGR
+};
+
+/* A colour is bitDepth bits each of three channels, packed little endian starting
+ * from the lowest bit of the first byte, in whichever order the format says.
+ * Any bits left over in the last byte are left as 0 when a colour is written
+ */
+struct ColourFormat {
+	int _bitDepth = 5;
+	int _order = kColourRGB;
+
+	ColourFormat() {}
+	ColourFormat(int bitDepth, int order) {
+		_bitDepth = bitDepth;
+		_order = order;
+	}
+
+	int byteSize() const { return ((_bitDepth * 3) + 7) / 8; }
+
+	bool operator==(const ColourFormat &other) const {
+		return (_bitDepth == other._bitDepth) && (_order == other._order);
+	}
+};
+
+/* Hexer Colour Format
+ * Converting a channel between a bit depth and 8 bits is done with tables made once
+ * for every depth from 1 to 8, so nothing has to use floats or go bit by bit.
+ * Up and down are scaled and rounded (so the brightest value of any depth is FF),
+ * while shifted just moves the bits up, which is how the palette view draws colours.
+ * The bulk functions work on whole runs of colours, as RGB triples of raw channels or 24bit channels
+ */
+wxByte colourUp(int bitDepth, int value);
+wxByte colourDown(int bitDepth, int value);
+wxByte colourShift(int bitDepth, int value);
+
+void decodeColours(const ColourFormat &format, const wxByte *data, int count, wxByte *raw);
+void encodeColours(const ColourFormat &format, const wxByte *raw, int count, wxByte *data);
+void expandColours(const ColourFormat &format, const wxByte *raw, int count, wxByte *rgb);
+void reduceColours(const ColourFormat &format, const wxByte *rgb, int count, wxByte *raw);
+void shiftColours(const ColourFormat &format, const wxByte *raw, int count, wxByte *rgb);
+
+// Blends 24bit colours towards target, by an amount (in percent) that goes from fromPercent at the first colour to toPercent at the last
+void blendColours(wxByte *rgb, int count, const wxByte *target, int fromPercent, int toPercent);
+
+#endif
@@ -271,28 +271,40 @@ void HexerFrame::onAddEntryApply(wxCommandEvent &event) {
 	wxButton *button = (wxButton *) event.GetEventObject();
 	wxDialog *dialog = (wxDialog *) button->GetParent();
 
-	Entry *e;
 	ViewData *data;
-
-	int curGridRow = _curRow;
+	EntryLog *log;
+	int book;
 
 	if (_editOrDoc) {
 		data = _editData;
+		log = _editLog;
+		book = kSearchPatches;
 	} else {
 		data = _docsData;
-		curGridRow++;
+		log = _docsLog;
+		book = kSearchDocs;
 	}
 
-	if (_addOrEdit) {
-		e = new Entry();
-	} else {
+	// An edited entry is on the page that was showing when the dialog was opened
+	int entryPage = data->_noteBook->GetSelection();
+
+	// The Bitflags page is a diagram that the grid holds itself, so it can't take entries like the other docs can
+	if (!_editOrDoc && (((wxTextCtrl *) dialog->FindWindow(ID_DCat))->GetValue() == "Bitflags")) {
+		wxMessageBox("Bitflags is a diagram rather than a list of docs, so please use a different category", "Entry can't go in Bitflags", wxICON_WARNING);
+		return;
+	}
+
+	// Everything is read into a copy first, so the entry only changes once all of it is known to be valid
+	Entry edited;
+	if (!_addOrEdit) {
 		debug("editing...");
 		if (_editOrDoc) {
-			e = &_editPatches[_editData->_noteBook->GetSelection()][_curRow];
+			edited = _editPatches[entryPage][_curRow];
 		} else {
-			e = &_docsEntries[_docsData->_noteBook->GetSelection()][_curRow];
+			edited = _docsEntries[entryPage][_curRow];
 		}
 	}
+	Entry *e = &edited;
 
 	e->_name = ((wxTextCtrl *) dialog->FindWindow(ID_DTitle))->GetValue();
 	e->_size = ((wxTextCtrl *) dialog->FindWindow(ID_DSize))->GetValue();
@@ -303,6 +315,7 @@ void HexerFrame::onAddEntryApply(wxCommandEvent &event) {
 
 	// We don't want the user to have to care about adding "" to their long strings, so we do it here	
 	e->_desc = ((wxTextCtrl *) dialog->FindWindow(ID_DDesc))->GetValue();
+	e->_descAt = -1;
 	
 	// In case the user somehow enters a real double quote (heh) character, we want it removed before it gets written to the file
 	for (int i = 0; i < e->_desc.Len(); i++) {
@@ -319,86 +332,31 @@ void HexerFrame::onAddEntryApply(wxCommandEvent &event) {
 
 	if (e->_name == "") {
 		wxMessageBox("Please input a name for this entry", "Entry must have a title", wxICON_WARNING);
-		delete e;
 		return;
 	}
 
 	if (_editOrDoc) {
 		if ((e->_addr == "") || (oldBytes == "") || (newBytes == "")) {
 			wxMessageBox("Please make sure the patch has at least one offset and at least one pair of old and new bytes", "A patch requires an address and byte changes", wxICON_WARNING);
-			delete e;
 			return;
 		}
 	}
 
-	wxString sCat = ((wxTextCtrl *) dialog->FindWindow(ID_DCat))->GetValue();
-
-	wxVector<wxString> s = data->_catNames;
-
-	int cat = -1;
-	for (int i = 0; i < s.size(); i++) {
-		if (s[i].Cmp(sCat) == 0) {
-			cat = i;
-			break;
-		}
-	}
-
-	// * Needs functionality for moving an entry from one category to another by simply renaming the category on the edit *
-
-	if (cat == -1) {
-		e->_cat = s.size();
-		if (_editOrDoc) {
-			createPage(data, sCat, 0, 5);
-			_editPatches.resize(_editPatches.size() + 1);
-			// For the edit view, we need a checkbox inside the grid
-			wxGridCellAttr* checkBoxAttr = new wxGridCellAttr();
-			checkBoxAttr->SetReadOnly(false);
-			checkBoxAttr->SetEditor(new ThreeStateBoolEditor());
-			checkBoxAttr->SetRenderer(new ThreeStateBoolRenderer());
-			checkBoxAttr->SetAlignment(wxALIGN_CENTER, wxALIGN_CENTER);
-			data->_grids[e->_cat]->SetColAttr(3, checkBoxAttr);
-		} else {
-			createPage(data, sCat, 1, 7);
-			_docsEntries.resize(_docsEntries.size() + 1);
-			data->_grids[e->_cat]->SetCellValue(0, 3, "Address");
-			data->_grids[e->_cat]->SetCellValue(0, 4, "Size (b)");
-			data->_grids[e->_cat]->SetCellValue(0, 5, "Type");
-			data->_grids[e->_cat]->SetCellValue(0, 6, "Description");
-		}
-		data->_noteBook->SetSelection(e->_cat);
-
-	} else {
-		e->_cat = cat;
-	}
-
-	int row = curGridRow;
-
-	if (_addOrEdit) {
-		row = data->_grids[e->_cat]->GetNumberRows();
-		data->_grids[e->_cat]->InsertRows(row, 1, true);
-		if (_editOrDoc) {
-			_editData->_grids[e->_cat]->SetCellValue(row, 3, "1");
-		}
-	}
-
-	wxString oldBytesString = ((wxTextCtrl *) dialog->FindWindow(ID_DOldBytes))->GetValue();
-	wxString newBytesString = ((wxTextCtrl *) dialog->FindWindow(ID_DNewBytes))->GetValue();
-
 	debug(e->_addr);
-	debug(oldBytesString);
-	debug(newBytesString);
+	debug(oldBytes);
+	debug(newBytes);
 
 	wxStringTokenizer offsetTokenizer(e->_addr, ",");
-	wxStringTokenizer oldByteTokenizer(oldBytesString, ",");
-	wxStringTokenizer newByteTokenizer(newBytesString, ",");
+	wxStringTokenizer oldByteTokenizer(oldBytes, ",");
+	wxStringTokenizer newByteTokenizer(newBytes, ",");
 
 	e->_bytes.clear();
+	e->_state = kPatchOn;
 
 	while (offsetTokenizer.HasMoreTokens()) {
 
 		// We need another struct for the bytes to keep everything organized
 		PatchBytes offsetBytes;
-		wxVector<wxByte> crb;
 		
 		// This is a little weird looking, but it's how we can grab a hex offset in C++
 		// Can this use printf instead? Probably...
@@ -419,61 +377,117 @@ void HexerFrame::onAddEntryApply(wxCommandEvent &event) {
 
 			if ((newByte == -1) || (oldByte == -1)) {
 				wxMessageBox("Please input only Hexadecimal bytes", "Bytes must be Hexadecimal", wxICON_WARNING);
-				data->_grids[e->_cat]->DeleteRows(row, 1);
-				delete e;
 				return;
 			}
-			if (_editOrDoc) {
-				// Current bytes are what are in the rom when loaded, and we need them so we can know whether the patch will be useable or not
-				int currentByte = _rom->getByte(offsetBytes._offset + (i / 2));
-				crb.push_back(currentByte);
-
-				// If the current bytes in the rom are not the new bytes, we want it to be set to off,
-				// and if none of the bytes match, we want it to be set to a third state to warn the user
-				if ((currentByte != newByte) && (currentByte != oldByte)) {
-					// Since the checkbox is being rendered by the grid, there's no third option currently
-					_editData->_grids[e->_cat]->SetCellValue(row, 3, "2");
-
-				} else if (currentByte != newByte) {
-					_editData->_grids[e->_cat]->SetCellValue(row, 3, "0");
-				}
-			}
 		}
 
 		// Now that we have the bytes, we can add them to patch for this line
 		e->_bytes.push_back(offsetBytes);
 	}
 
-	if (e->_desc != "") {
-			data->_grids[e->_cat]->SetCellValue(row, 2, "?");
-	
-	} else {
-			data->_grids[e->_cat]->SetCellValue(row, 2, "");
+	// Now that the entry is valid, the category it goes in can be found (or made)
+	wxString sCat = ((wxTextCtrl *) dialog->FindWindow(ID_DCat))->GetValue();
+
+	wxVector<wxString> s = data->_catNames;
+
+	int cat = -1;
+	for (int i = 0; i < s.size(); i++) {
+		if (s[i].Cmp(sCat) == 0) {
+			cat = i;
+			break;
+		}
 	}
 
-	if (_editOrDoc) {
-		data->_grids[e->_cat]->SetCellValue(row, 4, e->_name);
+	if (cat == -1) {
+		e->_cat = s.size();
+		if (_editOrDoc) {
+			createPage(data, sCat, 0, 5);
+			_editPatches.resize(_editPatches.size() + 1);
+			// For the edit view, we need a checkbox inside the grid
+			wxGridCellAttr* checkBoxAttr = new wxGridCellAttr();
+			checkBoxAttr->SetReadOnly(false);
+			checkBoxAttr->SetEditor(new ThreeStateBoolEditor());
+			checkBoxAttr->SetRenderer(new ThreeStateBoolRenderer());
+			checkBoxAttr->SetAlignment(wxALIGN_CENTER, wxALIGN_CENTER);
+			data->_grids[e->_cat]->SetColAttr(3, checkBoxAttr);
+		} else {
+			createPage(data, sCat, 1, 7);
+			_docsEntries.resize(_docsEntries.size() + 1);
+		}
+		log->addCategory(sCat);
+		_search.addCategory(book, sCat);
+		data->_noteBook->SetSelection(e->_cat);
 
 	} else {
-		data->_grids[e->_cat]->SetCellValue(row, 3, e->_addr);
-		data->_grids[e->_cat]->SetCellValue(row, 4, e->_size);
-		data->_grids[e->_cat]->SetCellValue(row, 5, e->_type);
-		data->_grids[e->_cat]->SetCellValue(row, 6, e->_name);
+		e->_cat = cat;
 	}
 
-	data->_grids[e->_cat]->AutoSize();
-	data->_grids[e->_cat]->ForceRefresh();
-	_mainSizer->Layout();
+	/* The grid reads the entry straight from the vector, so a new one just has to be added and the grid told about it.
+	 * An entry that changes category is taken out of the old one and added to the end of the new one
+	 */
+	int entryCat = e->_cat;
+	bool moved = !_addOrEdit && (entryCat != entryPage);
+	if (moved) {
+		if (_editOrDoc) {
+			_patchStates->remove(entryPage, _curRow);
+			_editPatches[entryPage].erase(_editPatches[entryPage].begin() + _curRow);
+		} else {
+			_docsEntries[entryPage].erase(_docsEntries[entryPage].begin() + _curRow);
+		}
+		log->remove(entryPage, _curRow);
+		_search.remove(book, entryPage, _curRow);
+	}
 
-	if (_addOrEdit) {
+	if (_addOrEdit || moved) {
+		log->add(*e);
+		_search.add(book, entryCat, *e);
 		if (_editOrDoc) {
-			_editPatches[e->_cat].push_back(*e);
+			_editPatches[entryCat].push_back(*e);
 			
 		} else {
-			_docsEntries[e->_cat].push_back(*e);
-		}		
+			_docsEntries[entryCat].push_back(*e);
+		}
+
+	} else {
+		if (_editOrDoc) {
+			_editPatches[entryCat][_curRow] = *e;
+		} else {
+			_docsEntries[entryCat][_curRow] = *e;
+		}
+		log->edit(entryPage, _curRow, *e);
+		_search.update(book, entryPage, _curRow, *e);
+	}
+
+	// A doc might have a new address or size, which the page has to know about before it is sorted and filtered again
+	if (!_editOrDoc) {
+		_docsMap.rebuild(_docsEntries);
+		_hoverDoc = nullptr;
+	}
+
+	((EntryTable *) data->_grids[entryCat]->GetTable())->syncRows();
+	if (moved) {
+		((EntryTable *) data->_grids[entryPage]->GetTable())->syncRows();
 	}
 
+	// Only the patch that was added or edited needs its state (and what it conflicts with) worked out again
+	if (_editOrDoc) {
+		if (_addOrEdit || moved) {
+			_patchStates->add(entryCat, _editPatches[entryCat].size() - 1);
+		} else {
+			_patchStates->update(entryCat, _curRow);
+		}
+	}
+
+	// The page being shown is refreshed, as well as the one the entry went into if that is a different page
+	int shownPage = data->_noteBook->GetSelection();
+	data->_grids[shownPage]->AutoSize();
+	data->_grids[shownPage]->ForceRefresh();
+	if (entryCat != shownPage) {
+		data->_grids[entryCat]->AutoSize();
+		data->_grids[entryCat]->ForceRefresh();
+	}
+	_mainSizer->Layout();
+
 	if (_editOrDoc) {
 		saveLocalEdit();
 	} else {
@@ -483,16 +497,224 @@ void HexerFrame::onAddEntryApply(wxCommandEvent &event) {
 	delete dialog;
 }
 
+/* Script layout dialog
+ * -> ScriptDialog 			 [Dialog]
+ *  \-> ScriptDialogSizer 	 [BoxSizer]
+ *    \-> Mode				 [Choice]
+ *    \-> PointerSizer 		 [StaticBoxSizer]
+ *		\-> PointerGrid		 [FlexGridSizer]
+ *		  \-> Table, Count, Size, Adjust, Bank	[StaticText + TextCtrl]
+ *    \-> RangeSizer 		 [StaticBoxSizer]
+ *		\-> RangeGrid		 [FlexGridSizer]
+ *		  \-> Start, End	 [StaticText + TextCtrl]
+ *    \-> ButtonSizer 		 [Sizer]
+ */
+bool HexerFrame::scriptLayoutDialog(ScriptLayout &layout) {
+	// Dumping a script needs to know where the strings are, which is either a pointer table or a range
+	wxDialog *scriptDialog = new wxDialog(this, wxID_ANY, "Dump Script", wxDefaultPosition, wxDefaultSize, wxCLOSE_BOX, wxEmptyString);
+	wxBoxSizer *scriptDialogSizer = new wxBoxSizer(wxVERTICAL);
+
+	wxString modeChoices[2] = {"Pointer Table", "Range"};
+	wxChoice *mode = new wxChoice(scriptDialog, ID_DScriptMode, wxDefaultPosition, wxDefaultSize, 2, modeChoices, 0, wxDefaultValidator, wxEmptyString);
+	mode->SetSelection(0);
+
+	// The pointer table details
+	wxStaticBoxSizer *pointerSizer = new wxStaticBoxSizer(wxVERTICAL, scriptDialog, "Pointer Table");
+	wxStaticText *strTable  = new wxStaticText(pointerSizer->GetStaticBox(), wxID_ANY, "Table Offset: ");
+	  wxTextCtrl *table     = new wxTextCtrl(pointerSizer->GetStaticBox(), ID_DScriptTable, "0");
+	wxStaticText *strCount  = new wxStaticText(pointerSizer->GetStaticBox(), wxID_ANY, "Pointers: ");
+	  wxTextCtrl *count     = new wxTextCtrl(pointerSizer->GetStaticBox(), ID_DScriptCount, "1");
+	wxStaticText *strSize   = new wxStaticText(pointerSizer->GetStaticBox(), wxID_ANY, "Pointer Size: ");
+	  wxTextCtrl *size      = new wxTextCtrl(pointerSizer->GetStaticBox(), ID_DScriptSize, "2");
+	wxStaticText *strAdjust = new wxStaticText(pointerSizer->GetStaticBox(), wxID_ANY, "Offset Adjust: ");
+	  wxTextCtrl *adjust    = new wxTextCtrl(pointerSizer->GetStaticBox(), ID_DScriptAdjust, "0");
+	wxStaticText *strBank   = new wxStaticText(pointerSizer->GetStaticBox(), wxID_ANY, "Bank Size: ");
+	  wxTextCtrl *bank      = new wxTextCtrl(pointerSizer->GetStaticBox(), ID_DScriptBank, "0");
+
+	wxFlexGridSizer *pointerGrid = new wxFlexGridSizer(2, 5, 5);
+	pointerGrid->AddGrowableCol(1);
+	pointerGrid->Add(strTable);
+	pointerGrid->Add(table, 0, wxGROW);
+	pointerGrid->Add(strCount);
+	pointerGrid->Add(count, 0, wxGROW);
+	pointerGrid->Add(strSize);
+	pointerGrid->Add(size, 0, wxGROW);
+	pointerGrid->Add(strAdjust);
+	pointerGrid->Add(adjust, 0, wxGROW);
+	pointerGrid->Add(strBank);
+	pointerGrid->Add(bank, 0, wxGROW);
+	pointerSizer->Add(pointerGrid, 0, wxGROW);
+
+	// And the range details
+	wxStaticBoxSizer *rangeSizer = new wxStaticBoxSizer(wxVERTICAL, scriptDialog, "Range");
+	wxStaticText *strStart = new wxStaticText(rangeSizer->GetStaticBox(), wxID_ANY, "Start: ");
+	  wxTextCtrl *start    = new wxTextCtrl(rangeSizer->GetStaticBox(), ID_DScriptStart, wxString::Format("%X", _hexTable->_offset));
+	wxStaticText *strEnd   = new wxStaticText(rangeSizer->GetStaticBox(), wxID_ANY, "End: ");
+	  wxTextCtrl *end      = new wxTextCtrl(rangeSizer->GetStaticBox(), ID_DScriptEnd, wxString::Format("%X", _hexTable->_offset + 0x100));
+
+	wxFlexGridSizer *rangeGrid = new wxFlexGridSizer(2, 5, 5);
+	rangeGrid->AddGrowableCol(1);
+	rangeGrid->Add(strStart);
+	rangeGrid->Add(start, 0, wxGROW);
+	rangeGrid->Add(strEnd);
+	rangeGrid->Add(end, 0, wxGROW);
+	rangeSizer->Add(rangeGrid, 0, wxGROW);
+
+	wxSizer *buttonSizer = scriptDialog->CreateButtonSizer(wxOK | wxCANCEL);
+
+	scriptDialogSizer->Add(mode, 0, wxGROW | wxALL, 15);
+	scriptDialogSizer->Add(pointerSizer, 0, wxGROW | wxLEFT | wxRIGHT | wxBOTTOM, 15);
+	scriptDialogSizer->Add(rangeSizer, 0, wxGROW | wxLEFT | wxRIGHT | wxBOTTOM, 15);
+	scriptDialogSizer->Add(buttonSizer, 0, wxALIGN_CENTER | wxBOTTOM, 10);
+	scriptDialog->SetSizerAndFit(scriptDialogSizer);
+
+	if (scriptDialog->ShowModal() != wxID_OK) {
+		scriptDialog->Destroy();
+		return false;
+	}
 
+	// All of the offsets are hexadecimal, but the count and size are regular numbers
+	layout._pointers = (mode->GetSelection() == 0);
+	sscanf(table->GetValue().c_str(), "%x", &layout._table);
+	layout._count = wxAtoi(count->GetValue());
+	layout._pointerSize = wxAtoi(size->GetValue());
+	adjust->GetValue().ToLong(&layout._adjust, 16);
+	sscanf(bank->GetValue().c_str(), "%x", &layout._bankSize);
+	sscanf(start->GetValue().c_str(), "%x", &layout._start);
+	sscanf(end->GetValue().c_str(), "%x", &layout._end);
+
+	scriptDialog->Destroy();
+
+	if (layout._pointers && ((layout._pointerSize < 1) || (layout._pointerSize > 4) || (layout._count < 1) || (layout._bankSize < 0))) {
+		wxMessageBox("Please use a pointer size from 1 to 4 bytes, at least one pointer, and a bank size of 0 or more", "Pointer table is not valid", wxICON_WARNING);
+		return false;
+	}
 
+	if (!layout._pointers && (layout._end <= layout._start)) {
+		wxMessageBox("Please make sure the end of the range is after the start", "Range is not valid", wxICON_WARNING);
+		return false;
+	}
 
+	return true;
+}
 
+/* Free space dialog
+ * -> FreeDialog 			 [Dialog]
+ *  \-> FreeDialogSizer 	 [BoxSizer]
+ *    \-> FreeGrid			 [FlexGridSizer]
+ *      \-> Filler, Min, Size, Bank		[StaticText + TextCtrl]
+ *    \-> ButtonSizer 		 [Sizer]
+ */
+bool HexerFrame::freeSpaceDialog(int &filler, int &minLength, int &length, int &bankSize) {
+	wxDialog *freeDialog = new wxDialog(this, wxID_ANY, "Find Free Space", wxDefaultPosition, wxDefaultSize, wxCLOSE_BOX, wxEmptyString);
+	wxBoxSizer *freeDialogSizer = new wxBoxSizer(wxVERTICAL);
+
+	// The filler and bank size are hexadecimal, the lengths are regular numbers
+	wxStaticText *strFiller = new wxStaticText(freeDialog, wxID_ANY, "Filler Byte: ");
+	  wxTextCtrl *fill      = new wxTextCtrl(freeDialog, ID_DFreeFiller, wxString::Format("%02X", filler));
+	wxStaticText *strMin    = new wxStaticText(freeDialog, wxID_ANY, "Shortest Run: ");
+	  wxTextCtrl *min       = new wxTextCtrl(freeDialog, ID_DFreeMin, wxString::Format("%d", minLength));
+	wxStaticText *strSize   = new wxStaticText(freeDialog, wxID_ANY, "Bytes Needed: ");
+	  wxTextCtrl *size      = new wxTextCtrl(freeDialog, ID_DFreeSize, wxString::Format("%d", length));
+	wxStaticText *strBank   = new wxStaticText(freeDialog, wxID_ANY, "Bank Size (0 for none): ");
+	  wxTextCtrl *bank      = new wxTextCtrl(freeDialog, ID_DFreeBank, wxString::Format("%X", bankSize));
+
+	wxFlexGridSizer *freeGrid = new wxFlexGridSizer(2, 5, 5);
+	freeGrid->AddGrowableCol(1);
+	freeGrid->Add(strFiller);
+	freeGrid->Add(fill, 0, wxGROW);
+	freeGrid->Add(strMin);
+	freeGrid->Add(min, 0, wxGROW);
+	freeGrid->Add(strSize);
+	freeGrid->Add(size, 0, wxGROW);
+	freeGrid->Add(strBank);
+	freeGrid->Add(bank, 0, wxGROW);
+
+	wxSizer *buttonSizer = freeDialog->CreateButtonSizer(wxOK | wxCANCEL);
+
+	freeDialogSizer->Add(freeGrid, 0, wxGROW | wxALL, 15);
+	freeDialogSizer->Add(buttonSizer, 0, wxALIGN_CENTER | wxBOTTOM, 10);
+	freeDialog->SetSizerAndFit(freeDialogSizer);
+
+	if (freeDialog->ShowModal() != wxID_OK) {
+		freeDialog->Destroy();
+		return false;
+	}
 
+	sscanf(fill->GetValue().c_str(), "%x", &filler);
+	minLength = wxAtoi(min->GetValue());
+	length = wxAtoi(size->GetValue());
+	sscanf(bank->GetValue().c_str(), "%x", &bankSize);
 
+	freeDialog->Destroy();
 
+	if ((filler < 0) || (filler > 0xFF) || (minLength < 1) || (length < 1) || (bankSize < 0)) {
+		wxMessageBox("Please use a filler byte from 00 to FF, and lengths of at least 1 byte", "Free space search is not valid", wxICON_WARNING);
+		return false;
+	}
 
+	return true;
+}
 
+/* Palette adjust dialog
+ * -> PalDialog 			 [Dialog]
+ *  \-> PalDialogSizer 		 [BoxSizer]
+ *    \-> PalGrid			 [FlexGridSizer]
+ *      \-> Operation, Order	[StaticText + Choice]
+ *      \-> Colour				[StaticText + ColourPickerCtrl]
+ *      \-> Amount, Depth		[StaticText + SpinCtrl]
+ *    \-> ButtonSizer 		 [Sizer]
+ */
+bool HexerFrame::paletteAdjustDialog(int &operation, wxColour &colour, int &amount, int &bitDepth, int &order) {
+	wxDialog *palDialog = new wxDialog(this, wxID_ANY, "Adjust Colours", wxDefaultPosition, wxDefaultSize, wxCLOSE_BOX, wxEmptyString);
+	wxBoxSizer *palDialogSizer = new wxBoxSizer(wxVERTICAL);
+
+	// The colour and amount are used by tint and fade, the depth and order by re-encode
+	wxString operations[3] = {"Tint", "Fade Ramp", "Re-encode"};
+	wxString orders[2] = {"RGB", "BGR"};
+	wxStaticText *strOperation = new wxStaticText(palDialog, wxID_ANY, "Operation: ");
+	    wxChoice *op           = new wxChoice(palDialog, ID_DPalOperation, wxDefaultPosition, wxDefaultSize, 3, operations);
+	wxStaticText *strColour    = new wxStaticText(palDialog, wxID_ANY, "Towards Colour: ");
+	wxColourPickerCtrl *clr    = new wxColourPickerCtrl(palDialog, ID_DPalColour, colour);
+	wxStaticText *strAmount    = new wxStaticText(palDialog, wxID_ANY, "Amount (%): ");
+	  wxSpinCtrl *amt          = new wxSpinCtrl(palDialog, ID_DPalAmount, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 100, amount);
+	wxStaticText *strDepth     = new wxStaticText(palDialog, wxID_ANY, "Bits Per Colour: ");
+	  wxSpinCtrl *depth        = new wxSpinCtrl(palDialog, ID_DPalDepth, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 1, 8, bitDepth);
+	wxStaticText *strOrder     = new wxStaticText(palDialog, wxID_ANY, "Channel Order: ");
+	    wxChoice *ord          = new wxChoice(palDialog, ID_DPalOrder, wxDefaultPosition, wxDefaultSize, 2, orders);
+	op->SetSelection(operation);
+	ord->SetSelection(order);
+
+	wxFlexGridSizer *palGrid = new wxFlexGridSizer(2, 5, 5);
+	palGrid->AddGrowableCol(1);
+	palGrid->Add(strOperation);
+	palGrid->Add(op, 0, wxGROW);
+	palGrid->Add(strColour);
+	palGrid->Add(clr, 0, wxGROW);
+	palGrid->Add(strAmount);
+	palGrid->Add(amt, 0, wxGROW);
+	palGrid->Add(strDepth);
+	palGrid->Add(depth, 0, wxGROW);
+	palGrid->Add(strOrder);
+	palGrid->Add(ord, 0, wxGROW);
+
+	wxSizer *buttonSizer = palDialog->CreateButtonSizer(wxOK | wxCANCEL);
+
+	palDialogSizer->Add(palGrid, 0, wxGROW | wxALL, 15);
+	palDialogSizer->Add(buttonSizer, 0, wxALIGN_CENTER | wxBOTTOM, 10);
+	palDialog->SetSizerAndFit(palDialogSizer);
+
+	if (palDialog->ShowModal() != wxID_OK) {
+		palDialog->Destroy();
+		return false;
+	}
 
+	operation = op->GetSelection();
+	colour = clr->GetColour();
+	amount = amt->GetValue();
+	bitDepth = depth->GetValue();
+	order = ord->GetSelection();
 
-
-
+	palDialog->Destroy();
+	return true;
+}
@@ -0,0 +1,82 @@
+#include "docsFile.h"
+
+#include <wx/textfile.h>
+#include <wx/tokenzr.h>
+
+bool DocsFile::read(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries) {
+	_error = "";
+	wxTextFile file(path);
+	if (!file.Open()) {
+		_error = "Could not load " + path;
+		return false;
+	}
+
+	cats.clear();
+	wxStringTokenizer catTokenizer(file.GetFirstLine(), "|");
+	while (catTokenizer.HasMoreTokens()) {
+		cats.push_back(catTokenizer.GetNextToken());
+	}
+
+	entries.clear();
+	entries.resize(cats.size());
+	for (wxString line = file.GetNextLine(); !file.Eof(); line = file.GetNextLine()) {
+		Entry e;
+		wxStringTokenizer lineTokenizer(line, "|");
+
+		// The category is an int, so we have to convert it, the rest of the components are all strings
+		e._cat = wxAtoi(lineTokenizer.GetNextToken());
+		e._name = lineTokenizer.GetNextToken();
+		e._addr = lineTokenizer.GetNextToken();
+		e._size = lineTokenizer.GetNextToken();
+		e._type = lineTokenizer.GetNextToken();
+		e._desc = lineTokenizer.GetNextToken();
+
+		// To properly capture multi-line descriptions, the whole string is contained in "" instead of always being one line per entry
+		if (!e._desc.IsEmpty() && (e._desc[0] == '\"')) {
+			wxString longLine = line;
+			while (longLine[longLine.size() - 1] != '\"') {
+				longLine = file.GetNextLine();
+				e._desc << '\n' << longLine;
+			}
+		}
+
+		if ((e._cat < 0) || (e._cat >= entries.size())) {
+			continue;
+		}
+		entries[e._cat].push_back(e);
+	}
+	return true;
+}
+
+bool DocsFile::write(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries) {
+	_error = "";
+	wxTextFile file(path);
+	if (file.Exists() ? !file.Open() : !file.Create()) {
+		_error = "Could not write to " + path;
+		return false;
+	}
+
+	file.Clear();
+	wxString catLine = "";
+	for (int i = 0; i < cats.size(); i++) {
+		catLine << cats[i];
+		if (i != cats.size() - 1) {
+			catLine << "|";
+		}
+	}
+	file.AddLine(catLine);
+
+	for (int i = 0; i < entries.size(); i++) {
+		for (int j = 0; j < entries[i].size(); j++) {
+			wxString docsLine = "";
+			docsLine << i << "|";
+			docsLine << entries[i][j]._name << "|";
+			docsLine << entries[i][j]._addr << "|";
+			docsLine << entries[i][j]._size << "|";
+			docsLine << entries[i][j]._type << "|";
+			docsLine << entries[i][j]._desc;
+			file.AddLine(docsLine);
+		}
+	}
+	return file.Write();
+}
@@ -0,0 +1,28 @@
+#ifndef HEXER_DOCSFILE_H
+#define HEXER_DOCSFILE_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+
+#include "entryTable.h"
+
+/* Hexer Docs File
+ * The documents are kept as text, with the category names on the first line and then one entry
+ * on each line after that, as: category|title|address|size|type|description
+ * A description in quotes can go over several lines.
+ */
+class DocsFile {
+public:
+	bool read(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries);
+	bool write(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries);
+
+	wxString _error;						// Why the last read or write failed
+};
+
+#endif
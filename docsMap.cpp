@@ -0,0 +1,71 @@
+#include "docsMap.h"
+
+#include <algorithm>
+
+/* An address is hex, with or without a $ or 0x in front, and only the first one counts if
+ * there is a list of them. The size is in bytes, and a doc without one covers just its address
+ */
+static void parseAddress(Entry &e) {
+	e._offset = -1;
+	e._length = 0;
+
+	wxString address = e._addr.BeforeFirst(',').Strip(wxString::both);
+	if (address.StartsWith("$")) {
+		address = address.Mid(1);
+
+	} else if (address.Lower().StartsWith("0x")) {
+		address = address.Mid(2);
+	}
+
+	unsigned long offset = 0;
+	if (address.IsEmpty() || !address.ToULong(&offset, 16)) {
+		return;
+	}
+
+	e._offset = offset;
+	e._length = std::max(1, wxAtoi(e._size));
+}
+
+void DocsMap::rebuild(wxVector< wxVector<Entry> > &docs) {
+	_docs = &docs;
+	_index.clear();
+	_list.clear();
+	_generation++;
+
+	for (int c = 0; c < docs.size(); c++) {
+		for (int i = 0; i < docs[c].size(); i++) {
+			Entry &e = docs[c][i];
+			parseAddress(e);
+			if (e._offset >= 0) {
+				_index.add(e._offset, e._offset + e._length, _list.size());
+				_list.push_back(std::make_pair(c, i));
+			}
+		}
+	}
+	_index.build();
+}
+
+// A doc inside another (like one field of a table) says more about the byte than the one around it
+Entry *DocsMap::at(int offset) {
+	wxVector<int> ids;
+	_index.find(offset, offset + 1, ids);
+
+	Entry *smallest = nullptr;
+	for (int i = 0; i < ids.size(); i++) {
+		Entry *e = &(*_docs)[_list[ids[i]].first][_list[ids[i]].second];
+		if ((smallest == nullptr) || (e->_length < smallest->_length)) {
+			smallest = e;
+		}
+	}
+	return smallest;
+}
+
+void DocsMap::spans(int start, int end, wxVector< std::pair<int, int> > &spans) {
+	wxVector<int> ids;
+	_index.find(start, end, ids);
+
+	for (int i = 0; i < ids.size(); i++) {
+		const Entry &e = (*_docs)[_list[ids[i]].first][_list[ids[i]].second];
+		spans.push_back(std::make_pair(std::max(start, e._offset), std::min(end, e._offset + e._length)));
+	}
+}
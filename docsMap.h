@@ -0,0 +1,39 @@
+#ifndef HEXER_DOCSMAP_H
+#define HEXER_DOCSMAP_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+
+#include "entryTable.h"
+#include "intervalIndex.h"
+
+/* Hexer Docs Map
+ * The docs as a map of the rom. The address and size of every doc are worked out as numbers
+ * when the map is built, and each doc with an address is kept in an interval index over the
+ * bytes it covers. That way the hex view can find the docs over a row, or under the mouse,
+ * with one lookup instead of going through every doc. Anything that changes the docs builds
+ * the map again, which also lets anything keeping lookups from it know they are out of date.
+ */
+class DocsMap {
+public:
+	void rebuild(wxVector< wxVector<Entry> > &docs);
+
+	Entry *at(int offset);												// The smallest doc over the offset, or nullptr if there isn't one
+	void spans(int start, int end, wxVector< std::pair<int, int> > &spans);	// The part of [start, end) each doc over it covers
+
+	unsigned int generation() { return _generation; }
+
+private:
+	wxVector< wxVector<Entry> > *_docs = nullptr;
+	IntervalIndex _index;							// Every doc with an address, with the position of the doc in _list as its id
+	wxVector< std::pair<int, int> > _list;			// (category, index) of every doc with an address
+	unsigned int _generation = 0;
+};
+
+#endif
@@ -1,5 +1,16 @@
 #include "hexer.h"
 
+// The log reads and writes the whole notebook with these
+static bool readDocs(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries) {
+	DocsFile docsFile;
+	return docsFile.read(path, cats, entries);
+}
+
+static bool writeDocs(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries) {
+	DocsFile docsFile;
+	return docsFile.write(path, cats, entries);
+}
+
 // ------------------------------------------------------------------
 /* ****               	  ****
  * **** The Document View ****
@@ -23,16 +34,24 @@ void HexerFrame::populateDocsView() {
 	// Since we can load a new documentation file after one is already loaded, we need to clear everything from the docs view panel first
 	_docsView->DestroyChildren();
 
-	// We need to load the tweaks file before populating the panel in case the file can't be loaded
-	wxTextFile _docsFile(wxString("local/docsLocal"));
-	if (!_docsFile.Open()) {
+	// We need to load the docs file before populating the panel in case the file can't be loaded, and then replay its log over it
+	delete _docsLog;
+	_docsLog = new EntryLog("local/docsLocal", readDocs, writeDocs);
+	_docsLog->recover();
+	_search.invalidate(kSearchDocs);
+
+	DocsFile docsFile;
+	wxVector<wxString> categories;
+	wxVector2D<Entry> entries;
+	if (!docsFile.read("local/docsLocal", categories, entries) || !_docsLog->replay(categories, entries)) {
 		wxLogError(wxString("Could not load local docs file"));
 		_docsView->Show(false);
 		return;
 	}
 
-	// We are starting a new ViewData
+	// We are starting a new ViewData, and the new controls start out showing every entry in file order
 	_docsData = new ViewData();
+	_docsOrder = EntryView();
 
 	// Primary sizer for the panel
 	wxBoxSizer *docsViewSizer = new wxBoxSizer(wxVERTICAL);
@@ -58,8 +77,40 @@ void HexerFrame::populateDocsView() {
 	docsOptionsExport->Add(exportPage, 0, wxGROW | wxBOTTOM, 15);
 	docsOptionsExport->Add(exportAll, 0, wxGROW | wxBOTTOM, 5);
 
+	// Every page (other than bitflags) can be sorted, and filtered by text or an address range
+	wxStaticBoxSizer *docsOptionsView = new wxStaticBoxSizer(wxVERTICAL, _docsData->_sidePanel->GetStaticBox(), "Sort and Filter");
+	wxBoxSizer *rangeSizer = new wxBoxSizer(wxHORIZONTAL);
+
+	wxString sortChoices[] = {"File order", "Address", "Size", "Type", "Name"};
+	wxChoice *sortChoice = new wxChoice(docsOptionsView->GetStaticBox(), ID_DocsSort, wxDefaultPosition, wxDefaultSize, 5, sortChoices);
+	sortChoice->SetSelection(kSortNone);
+	wxCheckBox *descending = new wxCheckBox(docsOptionsView->GetStaticBox(), ID_DocsDescending, "Descending");
+	wxTextCtrl *filterText = new wxTextCtrl(docsOptionsView->GetStaticBox(), ID_DocsFilter, "");
+	filterText->SetHint("Filter");
+	wxStaticText *strFrom = new wxStaticText(docsOptionsView->GetStaticBox(), wxID_ANY, "$");
+	wxTextCtrl *from = new wxTextCtrl(docsOptionsView->GetStaticBox(), ID_DocsFrom, "", wxDefaultPosition, wxSize(60, -1));
+	wxStaticText *strTo = new wxStaticText(docsOptionsView->GetStaticBox(), wxID_ANY, " to $");
+	wxTextCtrl *to = new wxTextCtrl(docsOptionsView->GetStaticBox(), ID_DocsTo, "", wxDefaultPosition, wxSize(60, -1));
+
+	rangeSizer->Add(strFrom, 0, wxALIGN_CENTER_VERTICAL);
+	rangeSizer->Add(from, 1, wxGROW);
+	rangeSizer->Add(strTo, 0, wxALIGN_CENTER_VERTICAL);
+	rangeSizer->Add(to, 1, wxGROW);
+
+	docsOptionsView->Add(sortChoice, 0, wxGROW | wxBOTTOM, 5);
+	docsOptionsView->Add(descending, 0, wxGROW | wxBOTTOM, 15);
+	docsOptionsView->Add(filterText, 0, wxGROW | wxBOTTOM, 5);
+	docsOptionsView->Add(rangeSizer, 0, wxGROW | wxBOTTOM, 5);
+
+	sortChoice->Bind(wxEVT_CHOICE, &HexerFrame::onDocsViewChanged, this);
+	descending->Bind(wxEVT_CHECKBOX, &HexerFrame::onDocsViewChanged, this);
+	filterText->Bind(wxEVT_TEXT, &HexerFrame::onDocsViewChanged, this);
+	from->Bind(wxEVT_TEXT, &HexerFrame::onDocsViewChanged, this);
+	to->Bind(wxEVT_TEXT, &HexerFrame::onDocsViewChanged, this);
+
 	_docsData->_sidePanel->Insert(0, addToNB, 0, wxGROW | wxBOTTOM, 15);
-	_docsData->_sidePanel->Add(docsOptionsExport, 0, wxGROW | wxBOTTOM, 5);
+	_docsData->_sidePanel->Add(docsOptionsExport, 0, wxGROW | wxBOTTOM, 15);
+	_docsData->_sidePanel->Add(docsOptionsView, 0, wxGROW | wxBOTTOM, 5);
 
 	// On the lower sizer we just have two buttons
 	wxButton *loadNewDocs = new wxButton(_docsView, wxID_ANY, "New docs file...", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, "New Entry");
@@ -77,17 +128,9 @@ void HexerFrame::populateDocsView() {
 	/* 
 	 * ---- Part 1 ----
 	 */
-	// The first line in the local files define the categories
-	wxString categories = _docsFile.GetFirstLine();
-	debug(categories);
-
-	// In C++, to break up a string we need a tokenizer
-	wxStringTokenizer catTokenizer(categories, "|");
-	int i = 0;
-	while (catTokenizer.HasMoreTokens()) {
+	for (int i = 0; i < categories.size(); i++) {
 		// The page names are the category names
-		createPage(_docsData, catTokenizer.GetNextToken(), 1, 7);
-		i++;
+		createPage(_docsData, categories[i], 1, 7);
 	}
 
 	// Now that the grids are created, we can make the category text control use the default category label
@@ -97,20 +140,11 @@ void HexerFrame::populateDocsView() {
 	 * ---- Part 2 ----
 	 */
 
-	// Okay, now we can start to iterate over the entire file line by line
+	// The entries go straight to the tables, and only the bitflags have to be drawn
 	int numPages = _docsData->_pages.size();
-	wxVector<int> lineID(numPages);
-	_docsEntries = wxVector2D<Entry>(numPages);
-
-	// Now we need to fill in the 0 line, which is the header
-	for (int i = 0; i < _docsData->_grids.size(); i++) {
-		if (_docsData->_catNames[i] != "Bitflags") {
-			_docsData->_grids[i]->SetCellValue(0, 3, "Address");
-			_docsData->_grids[i]->SetCellValue(0, 4, "Size (b)");
-			_docsData->_grids[i]->SetCellValue(0, 5, "Type");
-			_docsData->_grids[i]->SetCellValue(0, 6, "Description");
-		}
-	}
+	_docsEntries.swap(entries);
+	_docsMap.rebuild(_docsEntries);
+	_hoverDoc = nullptr;
 
 	// For the bitflags page, we need a monotype font
 	wxFont fontBitFlags = _docsData->_grids[0]->GetDefaultCellFont();
@@ -118,65 +152,33 @@ void HexerFrame::populateDocsView() {
 	fontBitFlags.SetStyle(wxFONTSTYLE_NORMAL);
 	fontBitFlags.SetWeight(wxFONTWEIGHT_NORMAL);
 
-	for (wxString line = _docsFile.GetNextLine(); !_docsFile.Eof(); line = _docsFile.GetNextLine()) {
-		// Each line is stored in the 2d Vector within a struct
-		Entry lineDocEntry;
-
-		// Each line is defined as: category|title|description|offsets|new bytes|old bytes
-		wxStringTokenizer lineTokenizer(line, "|");
-
-		// The category is an int, so we have to convert it
-		int lineCat = wxAtoi(lineTokenizer.GetNextToken());
-	
-		// The rest of the components are all strings
-		lineDocEntry._cat = lineCat;
-		lineDocEntry._name = lineTokenizer.GetNextToken();
-		lineDocEntry._addr = lineTokenizer.GetNextToken();
-		lineDocEntry._size = lineTokenizer.GetNextToken();
-		lineDocEntry._type = lineTokenizer.GetNextToken();
-		lineDocEntry._desc = lineTokenizer.GetNextToken();
-
-		// To properly capture multi-line descriptions, we will use the system newline chars
-		// Which means the whole string is contained in "" instead of always being one line per entry
-		if (lineDocEntry._desc[0] == '\"') {
-			wxString longLine = line;
-			while (longLine[longLine.size() - 1] != '\"') {
-				longLine = _docsFile.GetNextLine();
-				lineDocEntry._desc << '\n' << longLine;
-			}
+	for (int cat = 0; cat < numPages; cat++) {
+		/* Bitflags is a special category that displays it's information very differently.
+		 * The rest of the categories are read straight from the entries by the grid's table (along with the header row)
+		 */
+		if (_docsData->_catNames[cat] != "Bitflags") {
+			continue;
 		}
 
-		// Finally we can add the document line to the vector
-		_docsEntries[lineCat].push_back(lineDocEntry);
+		int lineID = 0;
+		for (int i = 0; i < _docsEntries[cat].size(); i++) {
+			Entry &e = _docsEntries[cat][i];
+			lineID++;
 
-		lineID[lineCat]++;
-
-		/* Bitflags is a special category that displays it's information very differently
-		 */
-		if (_docsData->_catNames[lineCat] == "Bitflags") {
 			wxString addrLine = "";
 			wxString zeroLine = "";
-			int size = wxAtoi(lineDocEntry._size) * 4;	// 4 bits in a byte, size is number of bytes
-			prepBitflagDraw(size, lineDocEntry._type, lineDocEntry._addr, addrLine, zeroLine);
-			drawBitflagDiagram(size, lineDocEntry._desc, lineCat, lineID[lineCat], fontBitFlags, addrLine, zeroLine, lineDocEntry._name);
-			lineID[lineCat] += 3 + size;
-
-		/* The rest of the categories just get added like normal
-		 */
-		} else {
-			_docsData->_grids[lineCat]->InsertRows(lineID[lineCat], 1, true);
-			if (lineDocEntry._desc != "") {
-				_docsData->_grids[lineCat]->SetCellValue(lineID[lineCat], 2, "?");
-			}
-			_docsData->_grids[lineCat]->SetCellValue(lineID[lineCat], 3, lineDocEntry._addr);
-			_docsData->_grids[lineCat]->SetCellValue(lineID[lineCat], 4, lineDocEntry._size);
-			_docsData->_grids[lineCat]->SetCellValue(lineID[lineCat], 5, lineDocEntry._type);
-			_docsData->_grids[lineCat]->SetCellValue(lineID[lineCat], 6, lineDocEntry._name);
+			int size = wxAtoi(e._size) * 4;	// 4 bits in a byte, size is number of bytes
+			prepBitflagDraw(size, e._type, e._addr, addrLine, zeroLine);
+			drawBitflagDiagram(size, e._desc, cat, lineID, fontBitFlags, addrLine, zeroLine, e._name);
+			lineID += 3 + size;
 		}
 	}
 
-	// And now just shrink everything to fit the contents
+	// And now just tell the tables how many entries they have, and shrink everything to fit the contents
 	for (int i = 0; i < _docsData->_grids.size(); i++) {
+		if (_docsData->_catNames[i] != "Bitflags") {
+			((EntryTable *) _docsData->_grids[i]->GetTable())->syncRows();
+		}
 		_docsData->_grids[i]->AutoSize();
 	}
 
@@ -210,41 +212,27 @@ void HexerFrame::onMouseInDocsGrid(wxMouseEvent& event) {
 void HexerFrame::onDocsGridDoubleClick(wxGridEvent &event) {
 	if ((event.GetCol() == 3) && (_rom != nullptr)) {
 		int cat = _docsData->_noteBook->GetSelection();
-		_curRow = event.GetRow();
-
-		if (_curRow == 0) {
-			return;
-		
-		} else {
-			_curRow--;
-		}
 
 		wxGrid *grid = (wxGrid *) event.GetEventObject();
 		if (_docsData->_catNames[cat] != "Bitflags") {
-			wxString address = _docsEntries[cat][_curRow]._addr;
-			if (address.Find('$') != wxNOT_FOUND) {
-				address = address.Mid(1);
-				debug(address);
+			// The rows might be sorted or filtered, so the table says which entry the row is
+			_curRow = ((EntryTable *) grid->GetTable())->entryIndex(event.GetRow());
+			if (_curRow == -1) {
+				return;
+			}
+
+			// The address was already worked out as a number when the docs map was built
+			int offset = _docsEntries[cat][_curRow]._offset;
+			if (offset < 0) {
+				return;
 			}
-			int offset = 0;
-			sscanf(address.c_str(), "%x", &offset);
+
 			// This function is primarily used by the hex editor, but it is a method of the frame so that other
 			// things like this can change the offset of the editor
 			goToOffset(offset);
 
 			// Now that the offset is set up, we need to switch the view to the editor
-			for (int i = 0; i < 3; i++) {
-				if (i == kViewHex) {
-					_views[i]->Show(true);
-					_toggleViews[i]->SetValue(true);
-					_view = i;
-				} else {
-					_views[i]->Show(false);
-					_toggleViews[i]->SetValue(false);
-				}
-				_prevRow = -1;
-			}
-			_mainSizer->Layout();
+			showView(kViewHex);
 		}
 	}
 }
@@ -257,19 +245,15 @@ void HexerFrame::onDocsGridLeftClick(wxGridEvent &event) {
 	 * 2. Handle moreInfo/delete buttons
 	 */
 	int cat = _docsData->_noteBook->GetSelection();
-	_curRow = event.GetRow();
-
-	if (_curRow == 0) {
-		return;
-	
-	} else {
-		_curRow--;
-	}
-	
 	wxGrid *grid = (wxGrid *) event.GetEventObject();
 
 	if (_docsData->_catNames[cat] != "Bitflags") {
 		// Bitflags will need to be handled separately and uniquely because only certain rows are useful
+		_curRow = ((EntryTable *) grid->GetTable())->entryIndex(event.GetRow());
+		if (_curRow == -1) {
+			return;
+		}
+
 		if (event.GetCol() == 2) {
 			// Click was on the moreInfo button
 			wxString s = _docsEntries[cat][_curRow]._desc;
@@ -297,7 +281,11 @@ void HexerFrame::askDeleteClosedDocs(wxWindowModalDialogEvent &event) {
 		case wxID_YES:
 			debug("Deleting entry");
 			_docsEntries[cat].erase(_docsEntries[cat].begin() + _curRow);
-			_docsData->_grids[cat]->DeleteRows(_curRow + 1, 1);
+			_docsLog->remove(cat, _curRow);
+			_search.remove(kSearchDocs, cat, _curRow);
+			_docsMap.rebuild(_docsEntries);
+			_hoverDoc = nullptr;
+			((EntryTable *) _docsData->_grids[cat]->GetTable())->syncRows();
 			_docsData->_grids[cat]->ForceRefresh();
 			saveLocalDocs();
 			break;
@@ -310,6 +298,54 @@ void HexerFrame::askDeleteClosedDocs(wxWindowModalDialogEvent &event) {
 	delete dialog;
 }
 
+// Any change to the sort and filter controls orders the page that is showing again, and the others when they are next shown
+void HexerFrame::onDocsViewChanged(wxCommandEvent &event) {
+	EntryView view;
+	view._sort = ((wxChoice *) _docsView->FindWindow(ID_DocsSort))->GetSelection();
+	view._descending = ((wxCheckBox *) _docsView->FindWindow(ID_DocsDescending))->GetValue();
+	view._text = ((wxTextCtrl *) _docsView->FindWindow(ID_DocsFilter))->GetValue();
+
+	// The range is only used once both ends of it are hex numbers
+	wxString from = ((wxTextCtrl *) _docsView->FindWindow(ID_DocsFrom))->GetValue();
+	wxString to = ((wxTextCtrl *) _docsView->FindWindow(ID_DocsTo))->GetValue();
+	unsigned long fromOffset = 0;
+	unsigned long toOffset = 0;
+	if (from.ToULong(&fromOffset, 16) && to.ToULong(&toOffset, 16)) {
+		view._from = fromOffset;
+		view._to = toOffset;
+	}
+
+	if (view._sort == wxNOT_FOUND) {
+		view._sort = kSortNone;
+	}
+	_docsOrder = view;
+
+	int page = _docsData->_noteBook->GetSelection();
+	for (int i = 0; i < _docsData->_grids.size(); i++) {
+		if (_docsData->_catNames[i] == "Bitflags") {
+			continue;
+		}
+
+		EntryTable *table = (EntryTable *) _docsData->_grids[i]->GetTable();
+		if (i == page) {
+			table->setView(_docsOrder);
+			_docsData->_grids[i]->ForceRefresh();
+		} else {
+			table->setViewLater(_docsOrder);
+		}
+	}
+	_prevRow = -1;
+}
+
+// A page that was left for later is sorted and filtered once it is looked at
+void HexerFrame::useDocsView(int page) {
+	if ((page >= 0) && (page < _docsData->_grids.size()) && (_docsData->_catNames[page] != "Bitflags")) {
+		if (((EntryTable *) _docsData->_grids[page]->GetTable())->useView()) {
+			_docsData->_grids[page]->ForceRefresh();
+		}
+	}
+}
+
 void HexerFrame::prepBitflagDraw(int size, wxString t, wxString a, wxString &addrLine, wxString &zeroLine) {
 	int width = wxAtoi(t);
 	int addr = 0;
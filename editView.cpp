@@ -1,6 +1,37 @@
 #include "hexer.h"
 #include "rom.h"
 
+// The log reads and writes the whole notebook with these, depending on which kind of file it is kept in.
+// Every description is read from the library, since the file it came from is about to be replaced
+static bool readPatchLibrary(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches) {
+	PatchLibrary library;
+	if (!library.open(path, cats, patches)) {
+		return false;
+	}
+
+	for (int c = 0; c < patches.size(); c++) {
+		for (int i = 0; i < patches[c].size(); i++) {
+			library.description(patches[c][i]);
+		}
+	}
+	return true;
+}
+
+static bool readPatchText(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches) {
+	PatchLibrary library;
+	return library.readText(path, cats, patches);
+}
+
+static bool writePatchLibrary(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches) {
+	PatchLibrary library;
+	return library.save(path, cats, patches);
+}
+
+static bool writePatchText(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches) {
+	PatchLibrary library;
+	return library.writeText(path, cats, patches);
+}
+
 // ------------------------------------------------------------------
 /* ****               ****
  * **** The Edit View ****
@@ -31,10 +62,33 @@ void HexerFrame::populateEditView() {
 	// Since we can load a new rom after one is already loaded, we need to clear everything from the edit view panel first
 	_editView->DestroyChildren();
 
-	// We need to load the tweaks file before populating the panel in case the file can't be loaded
-	wxTextFile _editFile(wxString("local/editLocal"));
-	if (!_editFile.Open()) {
-		wxLogError(wxString("Could not load local edit file"));
+	/* We need to load the patches before populating the panel in case they can't be loaded.
+	 * They come from the binary patch library if there is one, which opens without parsing
+	 * anything, and otherwise from the text file
+	 */
+	bool binary = wxFileExists("local/editLocal.hpl");
+	wxString path = binary ? "local/editLocal.hpl" : "local/editLocal";
+
+	// Any changes made since the file was last written are in its log, which is replayed over it
+	delete _editLog;
+	_editLog = binary ? new EntryLog(path, readPatchLibrary, writePatchLibrary) : new EntryLog(path, readPatchText, writePatchText);
+	_editLog->recover();
+
+	// The search index is made again from the new patches the next time it is used
+	_search.invalidate(kSearchPatches);
+
+	wxVector<wxString> categories;
+	wxVector2D<Entry> patches;
+	bool loaded = false;
+	if (binary) {
+		loaded = _patchLibrary.open(path, categories, patches);
+
+	} else {
+		loaded = _patchLibrary.readText(path, categories, patches);
+	}
+
+	if (!loaded || !_editLog->replay(categories, patches)) {
+		wxLogError("Could not load local edit file: " + _patchLibrary._error);
 		_editView->Show(false);
 		return;
 	}
@@ -61,8 +115,45 @@ void HexerFrame::populateEditView() {
 
 	createSidePanel(_editData, _editView);
 
+	// The side panel can also apply or revert a whole page, the selected patches, the patches found by a search, or every patch, at once
+	wxStaticBoxSizer *editOptionsPatches = new wxStaticBoxSizer(wxVERTICAL, _editData->_sidePanel->GetStaticBox(), "Patches");
+
+	wxButton *applyPage = new wxButton(editOptionsPatches->GetStaticBox(), ID_ApplyPage, "Apply Page");
+	wxButton *revertPage = new wxButton(editOptionsPatches->GetStaticBox(), ID_RevertPage, "Revert Page");
+	wxButton *applySelected = new wxButton(editOptionsPatches->GetStaticBox(), ID_ApplySelected, "Apply Selected");
+	wxButton *revertSelected = new wxButton(editOptionsPatches->GetStaticBox(), ID_RevertSelected, "Revert Selected");
+	wxButton *applyFound = new wxButton(editOptionsPatches->GetStaticBox(), ID_ApplyFound, "Apply Found");
+	wxButton *revertFound = new wxButton(editOptionsPatches->GetStaticBox(), ID_RevertFound, "Revert Found");
+	wxButton *applyAll = new wxButton(editOptionsPatches->GetStaticBox(), ID_ApplyAll, "Apply All");
+	wxButton *revertAll = new wxButton(editOptionsPatches->GetStaticBox(), ID_RevertAll, "Revert All");
+	wxButton *previewPage = new wxButton(editOptionsPatches->GetStaticBox(), ID_PreviewPage, "Preview Page");
+	applyPage->Bind(wxEVT_BUTTON, &HexerFrame::onPatchBatch, this);
+	revertPage->Bind(wxEVT_BUTTON, &HexerFrame::onPatchBatch, this);
+	applySelected->Bind(wxEVT_BUTTON, &HexerFrame::onPatchBatch, this);
+	revertSelected->Bind(wxEVT_BUTTON, &HexerFrame::onPatchBatch, this);
+	applyFound->Bind(wxEVT_BUTTON, &HexerFrame::onPatchBatch, this);
+	revertFound->Bind(wxEVT_BUTTON, &HexerFrame::onPatchBatch, this);
+	applyAll->Bind(wxEVT_BUTTON, &HexerFrame::onPatchBatch, this);
+	revertAll->Bind(wxEVT_BUTTON, &HexerFrame::onPatchBatch, this);
+	previewPage->Bind(wxEVT_BUTTON, &HexerFrame::onPatchBatch, this);
+
+	editOptionsPatches->Add(applyPage, 0, wxGROW | wxBOTTOM, 5);
+	editOptionsPatches->Add(revertPage, 0, wxGROW | wxBOTTOM, 15);
+	editOptionsPatches->Add(applySelected, 0, wxGROW | wxBOTTOM, 5);
+	editOptionsPatches->Add(revertSelected, 0, wxGROW | wxBOTTOM, 15);
+	editOptionsPatches->Add(applyFound, 0, wxGROW | wxBOTTOM, 5);
+	editOptionsPatches->Add(revertFound, 0, wxGROW | wxBOTTOM, 15);
+	editOptionsPatches->Add(applyAll, 0, wxGROW | wxBOTTOM, 5);
+	editOptionsPatches->Add(revertAll, 0, wxGROW | wxBOTTOM, 15);
+	editOptionsPatches->Add(previewPage, 0, wxGROW | wxBOTTOM, 5);
+
+	_editData->_sidePanel->Add(editOptionsPatches, 0, wxGROW | wxBOTTOM, 5);
+
 	wxStaticText *romName = new wxStaticText(_editView, wxID_ANY, "Rom: " + _rom->_name);
 		wxButton *changeFile = new wxButton(_editView, wxID_ANY, "New Patches File...", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, "Load new local patches file");
+		wxButton *exportFile = new wxButton(_editView, wxID_ANY, "Export Patches...");
+		changeFile->Bind(wxEVT_BUTTON, &HexerFrame::onLoadNewPatchFile, this);
+		exportFile->Bind(wxEVT_BUTTON, &HexerFrame::onExportPatchFile, this);
 
 	midSizer->Add(_editData->_noteBook, 1, wxGROW | wxTOP, kMacMargins);
 	midSizer->Add(_editData->_sidePanel, 0, wxALIGN_CENTER_VERTICAL | wxLEFT, 15);
@@ -70,34 +161,24 @@ void HexerFrame::populateEditView() {
 
 	lowerSizer->Add(romName, 0, wxALIGN_CENTER_VERTICAL);
 	lowerSizer->AddStretchSpacer();
+	lowerSizer->Add(exportFile, 0, wxGROW | wxRIGHT, 15);
 	lowerSizer->Add(changeFile, 0, wxGROW);
 
 	editViewSizer->Add(midSizer, 1, wxGROW | wxLEFT, kMacMargins + 5);
 	editViewSizer->Add(lowerSizer, 0, wxGROW | wxALL, kMacMargins + 5);
 
 	/* Populating the edit page is done in two parts:
-	 * 1. Split up the categories into individual strings (stored in a vector), and use that to determine
-	 *    the names and number of pages in the notebook. Then create the notebook where each page
-	 *    is a grid.
-	 * 2. Iterate over the file line by line, breaking each line up into it's components, which get stored
-	 *    in structures which are contained in vectors. At the same time,
-	 *	  create the grid that will display all of the data.
+	 * 1. Use the category names to determine the names and number of pages in the notebook.
+	 *    Then create the notebook where each page is a grid.
+	 * 2. Hand the patches over to the grids, which read them straight out of the vectors.
 	 */
 
 	/* 
 	 * ---- Part 1 ----
 	 */
-	// The first line in the local files define the categories
-	wxString categories = _editFile.GetFirstLine();
-	debug(categories);
-
-	// In C++, to break up a string we need a tokenizer
-	wxStringTokenizer catTokenizer(categories, "|");
-	int i = 0;
-	while (catTokenizer.HasMoreTokens()) {
-
+	for (int i = 0; i < categories.size(); i++) {
 		// The page names are the category names
-		createPage(_editData, catTokenizer.GetNextToken(), 0, 5);
+		createPage(_editData, categories[i], 0, 5);
 
 		// For the edit view, we need a checkbox inside the grid
 		wxGridCellAttr* checkBoxAttr = new wxGridCellAttr();
@@ -106,7 +187,6 @@ void HexerFrame::populateEditView() {
 		checkBoxAttr->SetRenderer(new ThreeStateBoolRenderer());
 		checkBoxAttr->SetAlignment(wxALIGN_CENTER, wxALIGN_CENTER);
 		_editData->_grids[i]->SetColAttr(3, checkBoxAttr);
-		i++;
 	}
 
 	// Now that the grids are created, we can make the category text control use the default category label
@@ -115,107 +195,21 @@ void HexerFrame::populateEditView() {
 	/* 
 	 * ---- Part 2 ----
 	 */
-
-	// We need to keep track of the line id by category so that we can add each entry to the right vector
 	int numPages = _editData->_pages.size();
+	_editPatches.swap(patches);
 
-	wxVector<int> lineID(numPages);
-	_editPatches = wxVector2D<Entry>(numPages);
-
-	for (wxString line = _editFile.GetNextLine(); !_editFile.Eof(); line = _editFile.GetNextLine()) {
-		// Each line is stored in the hashmap within a struct
-		Entry lineEditPatch;
-
-		// Each line is defined as: category|title|description|offsets|new bytes|old bytes
-		wxStringTokenizer lineTokenizer(line, "|");
-
-		// The category is an int, so we have to convert it from the string, the rest are strings
-		int lineCat = wxAtoi(lineTokenizer.GetNextToken());
-		   lineEditPatch._cat = lineCat;
-		  lineEditPatch._name = lineTokenizer.GetNextToken();
-		 wxString lineOffsets = lineTokenizer.GetNextToken();
-		wxString lineNewBytes = lineTokenizer.GetNextToken();
-		wxString lineOldBytes = lineTokenizer.GetNextToken();
-		  lineEditPatch._desc = lineTokenizer.GetNextToken();
-		
-		// To properly capture multi-line descriptions, we will use the system newline chars
-		// Which means the whole string is contained in "" instead of always being one line per entry
-		if (lineEditPatch._desc[0] == '\"') {
-			wxString longLine = line;
-			while (longLine[longLine.size() - 1] != '\"') {
-				longLine = _editFile.GetNextLine();
-				lineEditPatch._desc << '\n' << longLine;
-			}
-		}
-
-		// Add the patch name to the grid by adding a new line to it
-		_editData->_grids[lineCat]->InsertRows(lineID[lineCat], 1, true);
-		_editData->_grids[lineCat]->SetCellValue(lineID[lineCat], 3, "1");
-		_editData->_grids[lineCat]->SetCellValue(lineID[lineCat], 4, lineEditPatch._name);
-
-		// Each of the offset/byte lines is deliniated by commas
-		wxStringTokenizer offsetTokenizer(lineOffsets, ",");
-		wxStringTokenizer newByteTokenizer(lineNewBytes, ",");
-		wxStringTokenizer oldByteTokenizer(lineOldBytes, ",");
-
-		// Now we can start to extract the offset and byte data from the strings
-		while (offsetTokenizer.HasMoreTokens()) {
-
-			// We need another struct for the bytes to keep everything organized
-			PatchBytes offsetBytes;
-			wxVector<wxByte> crb;
-			
-			// This is a little weird looking, but it's how we can grab a hex offset in C++
-			// Can this use printf instead? Probably...
-			sscanf(offsetTokenizer.GetNextToken().c_str(), "%x", &offsetBytes._offset);
-
-			// Now that we have an offset, we want to break up the new and old bytes
- 			wxString newBytes = newByteTokenizer.GetNextToken();
-			wxString oldBytes = oldByteTokenizer.GetNextToken();
-
-			for (int i = 0; i < newBytes.size(); i += 2) {
-				int newByte;
-				sscanf(newBytes.SubString(i, i + 1).c_str(), "%x", &newByte);
-				offsetBytes._newBytes.push_back(newByte);
-
-				int oldByte;
-				sscanf(oldBytes.SubString(i, i + 1).c_str(), "%x", &oldByte);
-				offsetBytes._oldBytes.push_back(oldByte);
-
-				// Current bytes are what are in the rom when loaded, and we need them so we can know whether the patch will be useable or not
-				int currentByte = _rom->getByte(offsetBytes._offset + (i / 2));
-				crb.push_back(currentByte);
-
-				// If the current bytes in the rom are not the new bytes, we want it to be set to off,
-				// and if none of the bytes match, we want it to be set to a third state to warn the user
-				if ((currentByte != newByte) && (currentByte != oldByte)) {
-					// Since the checkbox is being rendered by the grid, there's no third option currently
-					_editData->_grids[lineCat]->SetCellValue(lineID[lineCat], 3, "2");
-
-				} else if (currentByte != newByte) {
-					_editData->_grids[lineCat]->SetCellValue(lineID[lineCat], 3, "0");
-				}
-			}
-
-			// Now that we have the bytes, we can add them to patch for this line
-			lineEditPatch._bytes.push_back(offsetBytes);
-		}
-		// Finally we can add the patch line to the vector
-		_editPatches[lineCat].push_back(lineEditPatch);
-
-		// If there is a description for the patch, add a question mark button to the left of it
-		if (lineEditPatch._desc != "") {
-			_editData->_grids[lineCat]->SetCellValue(lineID[lineCat], 2, "?");
-		}
-		
-		lineID[lineCat]++;
-	}
-
-	// Now we just need to shrink the grid to the contents
+	// Now we just need to tell the grids how many patches they have, and shrink them to the contents
 	for (int i = 0; i < numPages; i++) {
+		((EntryTable *) _editData->_grids[i]->GetTable())->syncRows();
 		_editData->_grids[i]->AutoSize();
 	}
 
+	// Whether each patch is applied or not is worked out against the rom in the background, instead of holding up loading
+	if (_patchStates != nullptr) {
+		delete _patchStates;
+	}
+	_patchStates = new PatchStates(_rom, &_editPatches);
+
 	// Add the sizer to the panel and render it with layout()
 	_editView->SetSizer(editViewSizer);
 	editViewSizer->Layout();
@@ -249,13 +243,32 @@ void HexerFrame::onEditGridLeftClick(wxGridEvent& event) {
 	 * try to do any sort of selection on the content.
 	 * 2. Check/uncheck the checkbox, bring up more info,
 	 * or bring up the delete dialog.
+	 * The exception is a click with ctrl or shift, which the
+	 * grid gets so that it can select rows of patches.
 	 */
+	if (event.ControlDown() || event.ShiftDown()) {
+		event.Skip();
+		return;
+	}
+
 	int cat = _editData->_noteBook->GetSelection();
 	_curRow = event.GetRow();
 
 	if (event.GetCol() == 2) {	
-		// Click was on the moreInfo button
-		wxString s = _editPatches[cat][_curRow]._desc;
+		// Click was on the moreInfo button, which warns about conflicts before showing the description
+		if (_editPatches[cat][_curRow]._conflict) {
+			wxVector< std::pair<int, int> > others;
+			_patchStates->conflictsWith(cat, _curRow, others);
+
+			wxString names = "";
+			for (int i = 0; i < others.size(); i++) {
+				names << _editPatches[others[i].first][others[i].second]._name << " (" << _editData->_catNames[others[i].first] << ")\n";
+			}
+			wxMessageBox(names, "This patch writes to the same bytes as:", wxOK | wxICON_WARNING);
+		}
+
+		// Descriptions in the patch library are only read once they are asked for
+		wxString s = _patchLibrary.description(_editPatches[cat][_curRow]);
 		if (s != "") {
 			moreInfo(s, false);
 		}
@@ -268,37 +281,129 @@ void HexerFrame::onEditGridLeftClick(wxGridEvent& event) {
 
 	} else if ((event.GetCol() == 1) && _editMode) {
 		// Click was on the edit patch button
-		addEntry(false, _editPatches[cat][_curRow]._name, _editPatches[cat][_curRow]._desc, _editPatches[cat][_curRow]._size, _editPatches[cat][_curRow]._type, "", "", "");
+		addEntry(false, _editPatches[cat][_curRow]._name, _patchLibrary.description(_editPatches[cat][_curRow]), _editPatches[cat][_curRow]._size, _editPatches[cat][_curRow]._type, "", "", "");
 
 	} else {
-		// Click was on the checkbox or the name
-		wxGrid *grid = (wxGrid *) event.GetEventObject();
-		wxString value = grid->GetCellValue(_curRow, 3);
+		// Click was on the checkbox or the name, which applies the patch unless it is already applied
+		wxVector< std::pair<int, int> > patch;
+		patch.push_back(std::make_pair(cat, _curRow));
+		applyPatches(patch, _editPatches[cat][_curRow]._state != kPatchOn);
+	}
+}
 
-		bool old = false;
+void HexerFrame::onPatchBatch(wxCommandEvent& event) {
+	int id = event.GetId();
+	int cat = _editData->_noteBook->GetSelection();
 
-		if ((value == "") || value == "0") {
-			grid->SetCellValue(_curRow, 3, "1");
-			// Apply the patch
-			debug("set, applying the new bytes");
+	wxVector< std::pair<int, int> > patches;
+	if ((id == ID_ApplySelected) || (id == ID_RevertSelected)) {
+		// The rows selected on the current page
+		wxGrid *grid = _editData->_grids[cat];
+		wxArrayInt rows = grid->GetSelectedRows();
+		for (int r = 0; r < rows.size(); r++) {
+			patches.push_back(std::make_pair(cat, ((EntryTable *) grid->GetTable())->entryIndex(rows[r])));
+		}
 
-		} else {
-			grid->SetCellValue(_curRow, 3, "0");
-			// Reverse the patch
-			debug("unset, applying the old bytes");
-			old = true;
+	} else if ((id == ID_ApplyFound) || (id == ID_RevertFound)) {
+		// The patches found by the last search (which can also have found docs, or patches that were deleted since)
+		for (int r = 0; r < _searchResults.size(); r++) {
+			const SearchResult &found = _searchResults[r];
+			if ((found._book == kSearchPatches) && (found._cat < _editPatches.size()) && (found._index < _editPatches[found._cat].size())) {
+				patches.push_back(std::make_pair(found._cat, found._index));
+			}
 		}
 
-		for (int i = 0; i < _editPatches[cat][_curRow]._bytes.size(); i++) {
-			if (old) {
-				_rom->setBytes(_editPatches[cat][_curRow]._bytes[i]._offset, _editPatches[cat][_curRow]._bytes[i]._oldBytes);
-			} else {
-				_rom->setBytes(_editPatches[cat][_curRow]._bytes[i]._offset, _editPatches[cat][_curRow]._bytes[i]._newBytes);
+	} else {
+		// Either the current page, or every page
+		for (int c = 0; c < _editPatches.size(); c++) {
+			if (((id == ID_ApplyPage) || (id == ID_RevertPage) || (id == ID_PreviewPage)) && (c != cat)) {
+				continue;
 			}
+
+			for (int i = 0; i < _editPatches[c].size(); i++) {
+				patches.push_back(std::make_pair(c, i));
+			}
+		}
+	}
+
+	if (id == ID_PreviewPage) {
+		previewPatches(patches);
+		return;
+	}
+	applyPatches(patches, (id == ID_ApplyPage) || (id == ID_ApplySelected) || (id == ID_ApplyFound) || (id == ID_ApplyAll));
+}
+
+// Lays the new bytes of every patch that isn't already applied over the rom, to be looked at in the hex view
+void HexerFrame::previewPatches(const wxVector< std::pair<int, int> > &patches) {
+	RomOverlay *preview = new RomOverlay();
+	for (int p = 0; p < patches.size(); p++) {
+		const Entry &e = _editPatches[patches[p].first][patches[p].second];
+		if (e._state == kPatchOn) {
+			continue;
 		}
 
-		grid->Refresh();
+		for (int b = 0; b < e._bytes.size(); b++) {
+			preview->add(e._bytes[b]._offset, e._bytes[b]._newBytes);
+		}
 	}
+	showPreview(preview);
+}
+
+/* Applies (or reverts) a set of patches as one batch. Every range of every patch goes into one
+ * write to the rom, so the patch states and anything else listening only hear about it once,
+ * and the grids are only redrawn once at the end. Patches that are already in the state they
+ * are being put in are left alone, and anything mismatched gets written over like any other.
+ * A patch only changes state if every one of its ranges was written.
+ */
+void HexerFrame::applyPatches(const wxVector< std::pair<int, int> > &patches, bool apply) {
+	wxVector<RomWrite> writes;
+	wxVector<int> writePatch;					// Which of patches each write is from
+	for (int p = 0; p < patches.size(); p++) {
+		Entry &e = _editPatches[patches[p].first][patches[p].second];
+		if (e._state == (apply ? kPatchOn : kPatchOff)) {
+			continue;
+		}
+
+		for (int b = 0; b < e._bytes.size(); b++) {
+			RomWrite write;
+			write._offset = e._bytes[b]._offset;
+			write._bytes = apply ? e._bytes[b]._newBytes : e._bytes[b]._oldBytes;
+			writes.push_back(write);
+			writePatch.push_back(p);
+		}
+	}
+
+	if (writes.empty()) {
+		return;
+	}
+
+	debug(wxString::Format("%s %d ranges", apply ? "applying" : "reverting", (int) writes.size()));
+	wxVector<int> rejected;
+	_rom->writeBatch(writes, &rejected);
+
+	wxVector<bool> failed(patches.size(), false);
+	for (int r = 0; r < rejected.size(); r++) {
+		failed[writePatch[rejected[r]]] = true;
+	}
+
+	// The patch states check every patch the write touched again, but the checkbox should change right away
+	int missed = 0;
+	for (int p = 0; p < patches.size(); p++) {
+		Entry &e = _editPatches[patches[p].first][patches[p].second];
+		if (failed[p]) {
+			missed++;
+
+		} else {
+			e._state = apply ? kPatchOn : kPatchOff;
+		}
+	}
+
+	if (missed > 0) {
+		wxLogError(wxString::Format("%d patches write past the end of the rom, so they were not %s", missed, apply ? "applied" : "reverted"));
+	}
+
+	_editData->_grids[_editData->_noteBook->GetSelection()]->ForceRefresh();
+	_hexGrid->ForceRefresh();
 }
 
 void HexerFrame::askDeleteClosedEdit(wxWindowModalDialogEvent &event) {
@@ -307,8 +412,11 @@ void HexerFrame::askDeleteClosedEdit(wxWindowModalDialogEvent &event) {
 	switch (dialog->GetReturnCode()) {
 		case wxID_YES:
 			debug("Deleting entry");
+			_patchStates->remove(cat, _curRow);
 			_editPatches[cat].erase(_editPatches[cat].begin() + _curRow);
-			_editData->_grids[cat]->DeleteRows(_curRow, 1);
+			_editLog->remove(cat, _curRow);
+			_search.remove(kSearchPatches, cat, _curRow);
+			((EntryTable *) _editData->_grids[cat]->GetTable())->syncRows();
 			_editData->_grids[cat]->ForceRefresh();
 			saveLocalEdit();
 			break;
@@ -321,7 +429,96 @@ void HexerFrame::askDeleteClosedEdit(wxWindowModalDialogEvent &event) {
 	delete dialog;
 }
 
-void HexerFrame::onLoadNewPatchFile() {
+/* Replaces every local patch with the ones in a patch library or text file.
+ * They are saved into whichever kind of file the local patches are kept in, and
+ * then the edit view is made again from that (once this button is done with)
+ */
+void HexerFrame::onLoadNewPatchFile(wxCommandEvent& event) {
+	wxFileDialog open(this, _("Load Patches File"), "", "", "Patch library (*.hpl)|*.hpl|Text patches (*.*)|*.*", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+	if (open.ShowModal() == wxID_CANCEL) {
+		return;
+	}
+
+	if (wxMessageBox("Every patch in the notebook will be replaced.", "Load a new patches file?", wxYES_NO | wxICON_WARNING) != wxYES) {
+		return;
+	}
+
+	PatchLibrary library;
+	wxVector<wxString> categories;
+	wxVector2D<Entry> patches;
+	bool loaded = false;
+	if (open.GetFilterIndex() == 0) {
+		loaded = library.open(open.GetPath(), categories, patches);
+		for (int c = 0; c < patches.size(); c++) {
+			for (int i = 0; i < patches[c].size(); i++) {
+				library.description(patches[c][i]);
+			}
+		}
+		library.close();
+
+	} else {
+		loaded = library.readText(open.GetPath(), categories, patches);
+	}
+
+	if (!loaded || categories.empty()) {
+		wxLogError("Could not load patches file: " + library._error);
+		return;
+	}
+
+	// The new file replaces the old one and everything in its log
+	_patchLibrary.close();
+	_editLog->reset();
+	if (wxFileExists("local/editLocal.hpl")) {
+		loaded = library.save("local/editLocal.hpl", categories, patches);
+
+	} else {
+		loaded = library.writeText("local/editLocal", categories, patches);
+	}
+
+	if (!loaded) {
+		wxLogError(library._error);
+	}
+	CallAfter(&HexerFrame::reloadEditView);
+}
+
+// The patches can be written out as either kind of file, no matter which one they came from
+void HexerFrame::onExportPatchFile(wxCommandEvent& event) {
+	wxFileDialog save(this, _("Export Patches File"), "", "editLocal.hpl", "Patch library (*.hpl)|*.hpl|Text patches (*.*)|*.*", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+	if (save.ShowModal() == wxID_CANCEL) {
+		return;
+	}
+
+	bool saved = false;
+	PatchLibrary library;
+	readDescriptions();
+	if (save.GetFilterIndex() == 0) {
+		saved = library.save(save.GetPath(), _editData->_catNames, _editPatches);
+
+	} else {
+		saved = library.writeText(save.GetPath(), _editData->_catNames, _editPatches);
+	}
+
+	if (!saved) {
+		wxLogError(library._error);
+	}
+}
 
+// Reads every description that is still in the patch library, so the entries no longer need it
+void HexerFrame::readDescriptions() {
+	for (int c = 0; c < _editPatches.size(); c++) {
+		for (int i = 0; i < _editPatches[c].size(); i++) {
+			_patchLibrary.description(_editPatches[c][i]);
+		}
+	}
+}
+
+// Making the edit view again also makes new patch states, which the hex view highlights from
+void HexerFrame::reloadEditView() {
+	populateEditView();
+	if (_patchStates != nullptr) {
+		_hexTable->_patchIndex = _patchStates->index();
+		_hexGrid->ForceRefresh();
+	}
+	_mainSizer->Layout();
 }
 // ------------------------------------------------------------------
\ No newline at end of file
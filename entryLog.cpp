@@ -0,0 +1,384 @@
+#include "entryLog.h"
+#include "mappedFile.h"
+
+#include <wx/filefn.h>
+
+static wxUint32 get32(const wxByte *data) {
+	return data[0] | (data[1] << 8) | (data[2] << 16) | ((wxUint32) data[3] << 24);
+}
+
+static void put32(wxVector<wxByte> &out, wxUint32 value) {
+	out.push_back(value & 0xFF);
+	out.push_back((value >> 8) & 0xFF);
+	out.push_back((value >> 16) & 0xFF);
+	out.push_back((value >> 24) & 0xFF);
+}
+
+static void putString(wxVector<wxByte> &out, const wxString &s) {
+	wxScopedCharBuffer utf8 = s.utf8_str();
+	put32(out, utf8.length());
+	out.insert(out.end(), (const wxByte *) utf8.data(), (const wxByte *) utf8.data() + utf8.length());
+}
+
+// Reading stops (and gives back false) at anything that would go past the end of the record
+static bool getString(const wxByte *data, size_t end, size_t &pos, wxString &s) {
+	if ((pos + 4) > end) {
+		return false;
+	}
+	size_t length = get32(data + pos);
+	pos += 4;
+	if ((pos + length) > end) {
+		return false;
+	}
+	s = wxString::FromUTF8((const char *) data + pos, length);
+	pos += length;
+	return true;
+}
+
+static bool getBytes(const wxByte *data, size_t end, size_t &pos, size_t length, wxVector<wxByte> &bytes) {
+	if ((pos + length) > end) {
+		return false;
+	}
+	bytes.assign(data + pos, data + pos + length);
+	pos += length;
+	return true;
+}
+
+wxThread::ExitCode EntryLogCompactor::Entry() {
+	wxString tmp = _log->_path + ".tmp";
+	wxString old = _log->_path + ".log.old";
+	wxString done = _log->_path + ".log.done";
+
+	// The notebook as it was when the log was moved aside is the file with the old log over it
+	wxVector<wxString> cats;
+	wxVector< wxVector< ::Entry > > entries;		// The thread's own Entry() hides the struct in here
+	int records = 0;
+	if (!_log->_reader(_log->_path, cats, entries) || !EntryLog::replayFile(old, cats, entries, records)) {
+		wxLogError("Could not read " + _log->_path);
+		return (wxThread::ExitCode) 0;
+	}
+
+	// If the new file can't be written, the old log stays where it is and is still replayed
+	if (!_log->_writer(tmp, cats, entries)) {
+		wxLogError("Could not write " + tmp);
+		wxRemoveFile(tmp);
+		return (wxThread::ExitCode) 0;
+	}
+
+	if (wxFileExists(old) && !wxRenameFile(old, done)) {
+		wxRemoveFile(tmp);
+		return (wxThread::ExitCode) 0;
+	}
+
+	if (wxRenameFile(tmp, _log->_path, true)) {
+		wxRemoveFile(done);
+	}
+	return (wxThread::ExitCode) 0;
+}
+
+EntryLog::EntryLog(wxString path, EntryReader reader, EntryWriter writer) {
+	_path = path;
+	_reader = reader;
+	_writer = writer;
+}
+
+EntryLog::~EntryLog() {
+	waitForCompactor();
+}
+
+void EntryLog::waitForCompactor() {
+	if (_compactor != nullptr) {
+		_compactor->Wait();
+		delete _compactor;
+		_compactor = nullptr;
+	}
+}
+
+/* Once the old log has been marked done, the new file is whole, it just might not have
+ * been renamed yet. Before that, a new file might only be half written, and the old log
+ * it was made from is still there, so the new file is thrown away
+ */
+void EntryLog::recover() {
+	wxString tmp = _path + ".tmp";
+	wxString done = _path + ".log.done";
+	if (wxFileExists(done)) {
+		if (wxFileExists(tmp)) {
+			wxRenameFile(tmp, _path, true);
+		}
+		wxRemoveFile(done);
+
+	} else if (wxFileExists(tmp)) {
+		wxRemoveFile(tmp);
+	}
+}
+
+/* A record cut off by the program stopping part way through writing it would swallow whatever
+ * is added after it, so a log is cut back to the end of its last whole record before anything
+ * else goes on the end. A wxFFile can't be made shorter, so the whole records are copied to a
+ * new file which is renamed over the log
+ */
+static bool cutPartialRecord(wxString path) {
+	if (!wxFileExists(path)) {
+		return true;
+	}
+
+	MappedFile file;
+	if (!file.open(path)) {
+		return false;
+	}
+
+	const wxByte *data = file.data();
+	size_t size = file.size();
+	size_t pos = 0;
+	while ((pos + 13) <= size) {
+		size_t end = pos + 4 + get32(data + pos);
+		if (end > size) {
+			break;
+		}
+		pos = end;
+	}
+	if (pos == size) {
+		return true;
+	}
+
+	wxString cut = path + ".cut";
+	wxFFile whole(cut, "wb");
+	bool written = whole.IsOpened() && ((pos == 0) || (whole.Write(data, pos) == pos));
+	whole.Close();
+	file.close();
+	if (!written || !wxRenameFile(cut, path, true)) {
+		wxRemoveFile(cut);
+		wxLogError("Could not cut the unfinished change off the end of " + path);
+		return false;
+	}
+	return true;
+}
+
+bool EntryLog::replay(wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries) {
+	_records = 0;
+	if (!cutPartialRecord(_path + ".log.old") || !cutPartialRecord(_path + ".log")) {
+		return false;
+	}
+	bool replayed = replayFile(_path + ".log.old", cats, entries, _records);
+	return replayFile(_path + ".log", cats, entries, _records) && replayed;
+}
+
+void EntryLog::reset() {
+	waitForCompactor();
+	_file.Close();
+	_records = 0;
+
+	wxString names[] = { ".log", ".log.old", ".log.done", ".tmp", ".log.cut", ".log.old.cut" };
+	for (int i = 0; i < 6; i++) {
+		if (wxFileExists(_path + names[i])) {
+			wxRemoveFile(_path + names[i]);
+		}
+	}
+}
+
+/* Each record is its length, then the operation, category and index, and then for an entry
+ * its strings and ranges, or for a category its name. A record cut off by the program stopping
+ * part way through writing it is left out (and has already been cut off the file by replay)
+ */
+bool EntryLog::replayFile(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries, int &records) {
+	if (!wxFileExists(path)) {
+		return true;
+	}
+
+	MappedFile file;
+	if (!file.open(path)) {
+		return false;
+	}
+
+	const wxByte *data = file.data();
+	size_t size = file.size();
+	size_t pos = 0;
+	while ((pos + 13) <= size) {
+		size_t end = pos + 4 + get32(data + pos);
+		if (end > size) {
+			break;
+		}
+
+		int op = data[pos + 4];
+		size_t cat = get32(data + pos + 5);
+		size_t index = get32(data + pos + 9);
+		pos += 13;
+
+		Entry e;
+		wxString name;
+		bool read = true;
+		if ((op == kLogAdd) || (op == kLogEdit)) {
+			e._cat = cat;
+			read = getString(data, end, pos, e._name) && getString(data, end, pos, e._desc) && getString(data, end, pos, e._addr)
+				&& getString(data, end, pos, e._size) && getString(data, end, pos, e._type) && ((pos + 4) <= end);
+
+			size_t ranges = read ? get32(data + pos) : 0;
+			pos += 4;
+			for (size_t r = 0; read && (r < ranges); r++) {
+				if ((pos + 12) > end) {
+					read = false;
+					break;
+				}
+
+				PatchBytes bytes;
+				bytes._offset = get32(data + pos);
+				size_t newLength = get32(data + pos + 4);
+				size_t oldLength = get32(data + pos + 8);
+				pos += 12;
+				read = getBytes(data, end, pos, newLength, bytes._newBytes) && getBytes(data, end, pos, oldLength, bytes._oldBytes);
+				e._bytes.push_back(bytes);
+			}
+
+		} else if ((op == kLogAddCategory) || (op == kLogRenameCategory)) {
+			read = getString(data, end, pos, name);
+		}
+		pos = end;
+
+		if (!read) {
+			continue;
+		}
+
+		// Anything that doesn't fit the notebook any more is skipped instead of trusted
+		switch (op) {
+		case kLogAdd:
+			if (cat < entries.size()) {
+				entries[cat].push_back(e);
+			}
+			break;
+
+		case kLogEdit:
+			if ((cat < entries.size()) && (index < entries[cat].size())) {
+				entries[cat][index] = e;
+			}
+			break;
+
+		case kLogDelete:
+			if ((cat < entries.size()) && (index < entries[cat].size())) {
+				entries[cat].erase(entries[cat].begin() + index);
+			}
+			break;
+
+		case kLogAddCategory:
+			cats.push_back(name);
+			entries.resize(cats.size());
+			break;
+
+		case kLogRenameCategory:
+			if (cat < cats.size()) {
+				cats[cat] = name;
+			}
+			break;
+		}
+		records++;
+	}
+	return true;
+}
+
+void EntryLog::append(int op, int cat, int index, const Entry *e, wxString name) {
+	wxVector<wxByte> record;
+	put32(record, 0);
+	record.push_back(op);
+	put32(record, cat);
+	put32(record, index);
+
+	if (e != nullptr) {
+		putString(record, e->_name);
+		putString(record, e->_desc);
+		putString(record, e->_addr);
+		putString(record, e->_size);
+		putString(record, e->_type);
+		put32(record, e->_bytes.size());
+		for (int b = 0; b < e->_bytes.size(); b++) {
+			put32(record, e->_bytes[b]._offset);
+			put32(record, e->_bytes[b]._newBytes.size());
+			put32(record, e->_bytes[b]._oldBytes.size());
+			record.insert(record.end(), e->_bytes[b]._newBytes.begin(), e->_bytes[b]._newBytes.end());
+			record.insert(record.end(), e->_bytes[b]._oldBytes.begin(), e->_bytes[b]._oldBytes.end());
+		}
+
+	} else if ((op == kLogAddCategory) || (op == kLogRenameCategory)) {
+		putString(record, name);
+	}
+
+	// The length at the start doesn't count itself
+	wxUint32 length = record.size() - 4;
+	record[0] = length & 0xFF;
+	record[1] = (length >> 8) & 0xFF;
+	record[2] = (length >> 16) & 0xFF;
+	record[3] = (length >> 24) & 0xFF;
+
+	if (!_file.IsOpened() && !_file.Open(_path + ".log", "ab")) {
+		wxLogError("Could not write to " + _path + ".log");
+		return;
+	}
+	_file.Write(&record[0], record.size());
+	_file.Flush();
+	_records++;
+}
+
+void EntryLog::add(const Entry &e) {
+	append(kLogAdd, e._cat, 0, &e, "");
+}
+
+void EntryLog::edit(int cat, int index, const Entry &e) {
+	append(kLogEdit, cat, index, &e, "");
+}
+
+void EntryLog::remove(int cat, int index) {
+	append(kLogDelete, cat, index, nullptr, "");
+}
+
+void EntryLog::addCategory(wxString name) {
+	append(kLogAddCategory, 0, 0, nullptr, name);
+}
+
+void EntryLog::renameCategory(int cat, wxString name) {
+	append(kLogRenameCategory, cat, 0, nullptr, name);
+}
+
+/* The log is moved aside before the thread starts, so everything in it is in the file being
+ * written, and everything after goes into a new log. If a compaction is still going, this one
+ * waits for the next change instead of holding anything up
+ */
+void EntryLog::compact() {
+	if (_compactor != nullptr) {
+		if (_compactor->IsAlive()) {
+			return;
+		}
+		waitForCompactor();
+	}
+
+	// If the last one wrote its file but couldn't rename it, the file has to be put in place before it is read again
+	recover();
+
+	_file.Close();
+	wxString log = _path + ".log";
+	wxString old = log + ".old";
+	if (wxFileExists(log)) {
+		// An old log is only still there if writing the last copy failed, in which case this log goes on the end of it
+		if (wxFileExists(old)) {
+			if (!cutPartialRecord(old) || !cutPartialRecord(log)) {
+				return;
+			}
+
+			MappedFile newer;
+			wxFFile older(old, "ab");
+			if (newer.open(log) && older.IsOpened() && (newer.size() > 0)) {
+				older.Write(newer.data(), newer.size());
+			}
+			older.Close();
+			newer.close();
+			wxRemoveFile(log);
+
+		} else if (!wxRenameFile(log, old)) {
+			return;
+		}
+	}
+	_records = 0;
+
+	_compactor = new EntryLogCompactor(this);
+	if (_compactor->Run() != wxTHREAD_NO_ERROR) {
+		delete _compactor;
+		_compactor = nullptr;
+	}
+}
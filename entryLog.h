@@ -0,0 +1,98 @@
+#ifndef HEXER_ENTRYLOG_H
+#define HEXER_ENTRYLOG_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+#include <wx/ffile.h>
+#include <wx/thread.h>
+
+#include "entryTable.h"
+
+enum EntryLogOp {
+	kLogAdd,								// An entry added to the end of a category
+	kLogEdit,								// An entry replaced
+	kLogDelete,								// An entry removed
+	kLogAddCategory,
+	kLogRenameCategory
+};
+
+enum EntryLogLimits {
+	kLogCompactRecords = 256				// How many changes can build up in the log before the whole file is written again
+};
+
+/* Read and write a whole notebook at path, in whichever format the notebook is kept in (these are called from the compaction thread).
+ * The reader has to give back every entry whole, with nothing still left to be read from the file later
+ */
+typedef bool (*EntryReader)(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries);
+typedef bool (*EntryWriter)(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries);
+
+class EntryLog;
+
+/* Reads the notebook file and replays the old log over it, writes that over the file, and then
+ * lets go of the old log. Nothing else changes either of those while it runs, so it doesn't
+ * need a copy of the notebook from the frame
+ */
+class EntryLogCompactor : public wxThread {
+public:
+	EntryLogCompactor(EntryLog *log) : wxThread(wxTHREAD_JOINABLE) {
+		_log = log;
+	}
+
+protected:
+	ExitCode Entry() wxOVERRIDE;
+
+private:
+	EntryLog *_log;
+};
+
+/* Hexer Entry Log
+ * Instead of the whole notebook file being written again after every change, each change is
+ * added to the end of a log next to it, so saving costs about as much as the entry that changed.
+ * Loading the notebook reads the file and then replays the log over it. Once the log is long
+ * enough, a background thread does the same, writes the result to a new file, and renames it
+ * over the old one, so the file is never half written. The log is moved aside first, so changes
+ * can keep going into a new one while that happens:
+ *   file.log -> file.log.old		while the new file is being written to file.tmp
+ *   file.log.old -> file.log.done	once it is, and then file.tmp -> file
+ * Whichever of those the program was stopped during is sorted out the next time it loads.
+ */
+class EntryLog {
+public:
+	EntryLog(wxString path, EntryReader reader, EntryWriter writer);
+	~EntryLog();							// Waits for a compaction that is still going
+
+	void recover();							// Has to be called before the notebook file is read
+	bool replay(wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries);
+	void reset();							// Throws the log away, for when the file has been replaced
+
+	void add(const Entry &e);
+	void edit(int cat, int index, const Entry &e);
+	void remove(int cat, int index);
+	void addCategory(wxString name);
+	void renameCategory(int cat, wxString name);
+
+	bool needsCompacting() { return _records >= kLogCompactRecords; }
+	void compact();
+
+private:
+	friend class EntryLogCompactor;
+
+	wxString _path;
+	EntryReader _reader;
+	EntryWriter _writer;
+	wxFFile _file;
+	int _records = 0;
+	EntryLogCompactor *_compactor = nullptr;
+
+	void append(int op, int cat, int index, const Entry *e, wxString name);
+	static bool replayFile(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries, int &records);
+	void waitForCompactor();
+};
+
+#endif
@@ -0,0 +1,272 @@
+#include "entryTable.h"
+
+#include <algorithm>
+#include <climits>
+
+int EntryTable::entryIndex(int row) {
+	int index = row - firstRow();
+	if ((index < 0) || (index >= shown())) {
+		return -1;
+	}
+	return _view.active() ? _order[index] : index;
+}
+
+int EntryTable::rowOf(int index) {
+	if (!_view.active()) {
+		return ((index >= 0) && (index < count())) ? (firstRow() + index) : -1;
+	}
+
+	if ((index < 0) || (index >= _rowOf.size()) || (_rowOf[index] == -1)) {
+		return -1;
+	}
+	return firstRow() + _rowOf[index];
+}
+
+Entry *EntryTable::entryAt(int row) {
+	int index = entryIndex(row);
+	if (index == -1) {
+		return nullptr;
+	}
+	return &(*_entries)[_cat][index];
+}
+
+void EntryTable::setView(const EntryView &view) {
+	_view = view;
+	_viewChanged = false;
+	syncRows();
+}
+
+void EntryTable::setViewLater(const EntryView &view) {
+	_nextView = view;
+	_viewChanged = true;
+}
+
+bool EntryTable::useView() {
+	if (!_viewChanged) {
+		return false;
+	}
+	setView(_nextView);
+	return true;
+}
+
+void EntryTable::order() {
+	_order.clear();
+	_rowOf.clear();
+	if (!_view.active()) {
+		return;
+	}
+
+	wxVector<Entry> &entries = (*_entries)[_cat];
+	wxString text = _view._text.Lower();
+	for (int i = 0; i < count(); i++) {
+		Entry &e = entries[i];
+		if ((_view._to > _view._from) && ((e._offset < _view._from) || (e._offset >= _view._to))) {
+			continue;
+		}
+
+		if ((text != "") && (e._name.Lower().Find(text) == wxNOT_FOUND) && (e._addr.Lower().Find(text) == wxNOT_FOUND)
+			&& (e._type.Lower().Find(text) == wxNOT_FOUND) && (e._desc.Lower().Find(text) == wxNOT_FOUND)) {
+			continue;
+		}
+		_order.push_back(i);
+	}
+
+	if (_view._sort != kSortNone) {
+		sortOrder();
+	}
+
+	_rowOf.assign(count(), -1);
+	for (int i = 0; i < _order.size(); i++) {
+		_rowOf[_order[i]] = i;
+	}
+}
+
+/* The key of every entry is worked out once before sorting, instead of every time two are
+ * compared, and only the indexes are sorted. The sort is stable, so entries with the same
+ * key stay in the order they are in the file (even when the order is reversed)
+ */
+void EntryTable::sortOrder() {
+	wxVector<Entry> &entries = (*_entries)[_cat];
+
+	// Entries without an address or size sort as if theirs was bigger than any other
+	wxVector<int> numbers;
+	wxVector<wxString> words;
+	if (_view._sort == kSortAddress) {
+		numbers.resize(count());
+		for (int i = 0; i < _order.size(); i++) {
+			int offset = entries[_order[i]]._offset;
+			numbers[_order[i]] = (offset < 0) ? INT_MAX : offset;
+		}
+
+	} else if (_view._sort == kSortSize) {
+		numbers.resize(count());
+		for (int i = 0; i < _order.size(); i++) {
+			Entry &e = entries[_order[i]];
+			numbers[_order[i]] = (e._size == "") ? INT_MAX : wxAtoi(e._size);
+		}
+
+	} else {
+		words.resize(count());
+		for (int i = 0; i < _order.size(); i++) {
+			Entry &e = entries[_order[i]];
+			words[_order[i]] = (_view._sort == kSortType) ? e._type.Lower() : e._name.Lower();
+		}
+	}
+
+	bool descending = _view._descending;
+	std::stable_sort(_order.begin(), _order.end(), [&](int a, int b) {
+		if (descending) {
+			std::swap(a, b);
+		}
+		if (!numbers.empty()) {
+			return numbers[a] < numbers[b];
+		}
+		return words[a].Cmp(words[b]) < 0;
+	});
+}
+
+wxString EntryTable::GetValue(int row, int col) {
+	// The buttons for deleting and editing are only on the row under the mouse
+	if ((col == 0) || (col == 1)) {
+		return ((row == _hoverRow) && (entryAt(row) != nullptr)) ? ((col == 0) ? "X" : "E") : "";
+	}
+
+	Entry *e = entryAt(row);
+	if (e == nullptr) {
+		return "";
+	}
+
+	// Conflicting with another patch is more important to know about than the description
+	if (col == 2) {
+		if (e->_conflict) {
+			return "!";
+		}
+		// A description that hasn't been read from the library yet is only known by where it is
+		return (!e->_desc.IsEmpty() || ((e->_descAt >= 0) && (e->_descLength > 0))) ? "?" : "";
+	}
+	return entryValue(*e, col);
+}
+
+// Setting a button cell moves the hover row, anything else is up to the kind of table
+void EntryTable::SetValue(int row, int col, const wxString &value) {
+	if ((col == 0) || (col == 1)) {
+		if (value != "") {
+			_hoverRow = row;
+
+		} else if (row == _hoverRow) {
+			_hoverRow = -1;
+		}
+	}
+}
+
+/* The number of rows only changes here, so the grid and the table can never disagree about it,
+ * even while the entries are being filled in
+ */
+void EntryTable::syncRows() {
+	// Anything that changes the rows sorts them again anyway, so a view that was kept is used now
+	if (_viewChanged) {
+		_view = _nextView;
+		_viewChanged = false;
+	}
+
+	order();
+	int rows = shown();
+	wxGrid *grid = GetView();
+	if ((grid != nullptr) && (rows > _rows)) {
+		wxGridTableMessage message(this, wxGRIDTABLE_NOTIFY_ROWS_APPENDED, rows - _rows);
+		grid->ProcessTableMessage(message);
+
+	} else if ((grid != nullptr) && (rows < _rows)) {
+		wxGridTableMessage message(this, wxGRIDTABLE_NOTIFY_ROWS_DELETED, firstRow() + rows, _rows - rows);
+		grid->ProcessTableMessage(message);
+	}
+	_rows = rows;
+
+	if (_hoverRow >= GetNumberRows()) {
+		_hoverRow = -1;
+	}
+}
+
+wxString PatchTable::entryValue(Entry &e, int col) {
+	switch (col) {
+	case 3:
+		return wxString::Format("%d", e._state);
+
+	case 4:
+		return e._name;
+
+	default:
+		return "";
+	}
+}
+
+// The checkbox is the only cell of an entry that the grid changes
+void PatchTable::SetValue(int row, int col, const wxString &value) {
+	Entry *e = entryAt(row);
+	if ((col == 3) && (e != nullptr)) {
+		e->_state = wxAtoi(value);
+		return;
+	}
+	EntryTable::SetValue(row, col, value);
+}
+
+wxGridCellAttr *PatchTable::GetAttr(int row, int col, wxGridCellAttr::wxAttrKind kind) {
+	wxGridCellAttr *attr = EntryTable::GetAttr(row, col, kind);
+	Entry *e = entryAt(row);
+	if ((e == nullptr) || !e->_conflict || ((col != 2) && (col != 4))) {
+		return attr;
+	}
+
+	// The column attributes are shared by every row, so the conflict colour has to go on a copy
+	if (attr == nullptr) {
+		attr = new wxGridCellAttr();
+
+	} else {
+		wxGridCellAttr *copy = attr->Clone();
+		attr->DecRef();
+		attr = copy;
+	}
+	attr->SetTextColour(*wxRED);
+	return attr;
+}
+
+wxString DocsTable::GetValue(int row, int col) {
+	if (row == 0) {
+		switch (col) {
+		case 3:
+			return "Address";
+
+		case 4:
+			return "Size (b)";
+
+		case 5:
+			return "Type";
+
+		case 6:
+			return "Description";
+
+		default:
+			return "";
+		}
+	}
+	return EntryTable::GetValue(row, col);
+}
+
+wxString DocsTable::entryValue(Entry &e, int col) {
+	switch (col) {
+	case 3:
+		return e._addr;
+
+	case 4:
+		return e._size;
+
+	case 5:
+		return e._type;
+
+	case 6:
+		return e._name;
+
+	default:
+		return "";
+	}
+}
@@ -0,0 +1,141 @@
+#ifndef HEXER_ENTRYTABLE_H
+#define HEXER_ENTRYTABLE_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+#include "wx/grid.h"
+
+// The checkbox of a patch is 0, 1 or 2 (the third state is for when the rom has neither the old nor the new bytes)
+enum PatchState {
+	kPatchOff,
+	kPatchOn,
+	kPatchMixed
+};
+
+struct PatchBytes {
+	int _offset = 0;
+	wxVector<wxByte> _newBytes;
+	wxVector<wxByte> _oldBytes;
+};
+
+struct Entry {
+	int _cat = 0;
+	wxString _name = "";
+	wxString _desc = "";
+	int _descAt = -1;					// Where the description is in the patch library, until it is read from there
+	int _descLength = 0;
+	wxString _addr = "";
+	wxString _size = "";
+	wxString _type = "";
+	int _offset = -1;					// The address and size of a doc as numbers, worked out by the docs map (-1 without an address)
+	int _length = 0;
+	wxVector<PatchBytes> _bytes;
+	int _state = kPatchOn;				// Only used by patches
+	bool _conflict = false;				// Whether another patch writes to any of the same bytes
+};
+
+enum EntrySort {
+	kSortNone,								// The order they are in the file
+	kSortAddress,
+	kSortSize,
+	kSortType,
+	kSortName
+};
+
+// How a table orders its entries, and which of them it shows
+struct EntryView {
+	int _sort = kSortNone;
+	bool _descending = false;
+	int _from = 0;							// Only entries with an address in [from, to), if to is past from
+	int _to = 0;
+	wxString _text = "";					// Only entries with this in the name, address, type or description
+
+	bool active() { return (_sort != kSortNone) || (_to > _from) || (_text != ""); }
+};
+
+/* Hexer Entry Table
+ * The grid of a notebook page doesn't hold any of the entries itself,
+ * it asks this table for a cell only when it is drawn, and the table reads
+ * it straight out of the entries for that category. That way a notebook with
+ * thousands of entries costs nothing more than the entries themselves.
+ * The delete and edit buttons only show on the row under the mouse, so
+ * instead of cells the table just keeps which row that is.
+ * A table can also be sorted and filtered, which never moves the entries
+ * themselves. It keeps the index of the entry for each row it shows instead,
+ * and the row of each entry the other way around. A page that isn't showing
+ * can be given a view to use later, so only the page being looked at is sorted.
+ */
+class EntryTable : public wxGridTableBase {
+public:
+	EntryTable(wxVector< wxVector<Entry> > *entries, int cat) {
+		_entries = entries;
+		_cat = cat;
+	}
+
+	int GetNumberRows() wxOVERRIDE { return firstRow() + _rows; }
+	wxString GetValue(int row, int col) wxOVERRIDE;
+	void SetValue(int row, int col, const wxString &value) wxOVERRIDE;
+	bool IsEmptyCell(int row, int col) wxOVERRIDE { return GetValue(row, col).IsEmpty(); }
+
+	void syncRows();						// Tells the grid about any entries that were added or removed since the last time
+	void setView(const EntryView &view);	// Sorts and filters the rows again, which the grid still has to be refreshed for
+	void setViewLater(const EntryView &view);	// Keeps the view until the rows are next synced, or it is used
+	bool useView();							// Sorts and filters with a view that was kept, returns false if there wasn't one
+
+	int entryIndex(int row);				// Where the entry of a row is in its category, or -1 if the row isn't an entry
+	int rowOf(int index);					// And the row of an entry, or -1 if it isn't shown
+
+protected:
+	wxVector< wxVector<Entry> > *_entries;	// All of the categories, since adding one can move the rest
+	int _cat;
+	int _hoverRow = -1;
+	int _rows = 0;							// How many entries the grid has been told about
+	EntryView _view;
+	EntryView _nextView;
+	bool _viewChanged = false;				// Whether _nextView still has to be used
+	wxVector<int> _order;					// The entry for each row, which is only used if the view sorts or filters
+	wxVector<int> _rowOf;					// And the row for each entry (-1 if it is filtered out), not counting the rows before them
+
+	int count() { return (_cat < _entries->size()) ? (*_entries)[_cat].size() : 0; }
+	int shown() { return _view.active() ? _order.size() : count(); }
+	Entry *entryAt(int row);
+	void order();
+	void sortOrder();
+
+	virtual int firstRow() { return 0; }	// Rows before the first entry
+	virtual wxString entryValue(Entry &e, int col) = 0;
+};
+
+// Patches are: delete, edit, more info, checkbox, name
+class PatchTable : public EntryTable {
+public:
+	PatchTable(wxVector< wxVector<Entry> > *entries, int cat) : EntryTable(entries, cat) {}
+
+	int GetNumberCols() wxOVERRIDE { return 5; }
+	void SetValue(int row, int col, const wxString &value) wxOVERRIDE;
+	wxGridCellAttr *GetAttr(int row, int col, wxGridCellAttr::wxAttrKind kind) wxOVERRIDE;	// Patches that conflict are shown in red
+
+protected:
+	wxString entryValue(Entry &e, int col) wxOVERRIDE;
+};
+
+// Documents are: delete, edit, more info, address, size, type, name, with a header row on top
+class DocsTable : public EntryTable {
+public:
+	DocsTable(wxVector< wxVector<Entry> > *entries, int cat) : EntryTable(entries, cat) {}
+
+	int GetNumberCols() wxOVERRIDE { return 7; }
+	wxString GetValue(int row, int col) wxOVERRIDE;
+
+protected:
+	int firstRow() wxOVERRIDE { return 1; }
+	wxString entryValue(Entry &e, int col) wxOVERRIDE;
+};
+
+#endif
@@ -0,0 +1,281 @@
+#include "freeSpace.h"
+
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#include <emmintrin.h>
+	#define HEXER_FREE_SPACE_SSE2
+#endif
+
+enum FreeSpaceValues {
+	kFreeSpaceChunk = 65536						// How much of the rom is scanned at a time
+};
+
+/* Returns how many bytes at the start of data are the filler byte (or are not, if equal is false).
+ * The bulk of the data is checked 16 bytes at a time with SSE2, or 8 at a time as a 64 bit word
+ * without it, and only the block where the span ends is looked at byte by byte.
+ */
+static int spanLength(const wxByte *data, int length, wxByte filler, bool equal) {
+	int i = 0;
+
+#ifdef HEXER_FREE_SPACE_SSE2
+	__m128i fill = _mm_set1_epi8((char) filler);
+	while ((i + 16) <= length) {
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) &data[i]), fill));
+		if (mask != (equal ? 0xFFFF : 0)) {
+			break;
+		}
+		i += 16;
+	}
+
+#else
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t highs = 0x8080808080808080ULL;
+	uint64_t fill = ones * filler;
+	while ((i + 8) <= length) {
+		uint64_t word;
+		memcpy(&word, &data[i], 8);
+
+		// After the xor, any byte that was the filler is now zero
+		word ^= fill;
+		bool hasFiller = ((word - ones) & ~word & highs) != 0;
+		if (equal ? (word != 0) : hasFiller) {
+			break;
+		}
+		i += 8;
+	}
+#endif
+
+	while ((i < length) && ((data[i] == filler) == equal)) {
+		i++;
+	}
+	return i;
+}
+
+FreeSpaceIndex::FreeSpaceIndex(Rom *rom, wxByte filler, int minLength) {
+	_rom = rom;
+	_filler = filler;
+	_minLength = (minLength > 0) ? minLength : 1;
+
+	build();
+	_rom->addListener(this);
+}
+
+FreeSpaceIndex::~FreeSpaceIndex() {
+	_rom->removeListener(this);
+}
+
+void FreeSpaceIndex::build() {
+	_byStart.clear();
+	_bySize.clear();
+	_reserved.clear();
+	_total = 0;
+	scan(0, _rom->size());
+}
+
+void FreeSpaceIndex::addRun(int start, int length) {
+	if (length < _minLength) {
+		return;
+	}
+	_byStart[start] = length;
+	_bySize.insert(std::make_pair(length, start));
+	_total += length;
+}
+
+// Filler that was found by a scan, which only counts as a run around any space that is reserved in it
+void FreeSpaceIndex::addFree(int start, int length) {
+	int end = start + length;
+
+	std::map<int, int>::iterator reserved = _reserved.upper_bound(start);
+	if (reserved != _reserved.begin()) {
+		reserved--;
+	}
+
+	for (; (reserved != _reserved.end()) && (reserved->first < end); reserved++) {
+		int reservedEnd = reserved->first + reserved->second;
+		if (reservedEnd <= start) {
+			continue;
+		}
+		addRun(start, reserved->first - start);
+		start = reservedEnd;
+	}
+
+	if (start < end) {
+		addRun(start, end - start);
+	}
+}
+
+void FreeSpaceIndex::removeRun(std::map<int, int>::iterator run) {
+	_bySize.erase(std::make_pair(run->second, run->first));
+	_total -= run->second;
+	_byStart.erase(run);
+}
+
+/* Records every run between start and end. Neither end can be
+ * in the middle of a run, or it would be recorded as shorter than it is
+ */
+void FreeSpaceIndex::scan(int start, int end) {
+	wxVector<wxByte> buffer(kFreeSpaceChunk);
+	int pos = start;
+	int runStart = -1;
+
+	while (pos < end) {
+		int want = ((end - pos) < kFreeSpaceChunk) ? (end - pos) : kFreeSpaceChunk;
+		int length = _rom->readBytes(pos, &buffer[0], want);
+		if (length <= 0) {
+			break;
+		}
+
+		// A run can carry on from one chunk into the next, so the start is kept until the run ends
+		int i = 0;
+		while (i < length) {
+			if (runStart == -1) {
+				i += spanLength(&buffer[i], length - i, _filler, false);
+				if (i < length) {
+					runStart = pos + i;
+				}
+
+			} else {
+				i += spanLength(&buffer[i], length - i, _filler, true);
+				if (i < length) {
+					addFree(runStart, (pos + i) - runStart);
+					runStart = -1;
+				}
+			}
+		}
+		pos += length;
+	}
+
+	if (runStart != -1) {
+		addFree(runStart, pos - runStart);
+	}
+}
+
+void FreeSpaceIndex::onRomWrite(int offset, int length) {
+	int romSize = _rom->size();
+	int start = (offset > 0) ? offset : 0;
+	int end = ((offset + length) < romSize) ? (offset + length) : romSize;
+	if (start >= end) {
+		return;
+	}
+
+	// Whatever was reserved where the write went is in use now
+	std::map<int, int>::iterator reserved = _reserved.upper_bound(start);
+	if (reserved != _reserved.begin()) {
+		reserved--;
+	}
+	while ((reserved != _reserved.end()) && (reserved->first < end)) {
+		if ((reserved->first + reserved->second) > start) {
+			_reserved.erase(reserved++);
+		} else {
+			reserved++;
+		}
+	}
+
+	// Any run that overlaps or touches the write is taken out, and the area grows to cover it
+	std::map<int, int>::iterator run = _byStart.upper_bound(start);
+	if (run != _byStart.begin()) {
+		std::map<int, int>::iterator before = run;
+		before--;
+		if ((before->first + before->second) >= start) {
+			run = before;
+		}
+	}
+
+	while ((run != _byStart.end()) && (run->first <= end)) {
+		if (run->first < start) {
+			start = run->first;
+		}
+		if ((run->first + run->second) > end) {
+			end = run->first + run->second;
+		}
+		std::map<int, int>::iterator next = run;
+		next++;
+		removeRun(run);
+		run = next;
+	}
+
+	// There can also be filler too short to be a run right next to the area, which the write might have joined up with
+	while ((start > 0) && (_rom->getByte(start - 1) == _filler)) {
+		start--;
+	}
+	while ((end < romSize) && (_rom->getByte(end) == _filler)) {
+		end++;
+	}
+
+	scan(start, end);
+}
+
+void FreeSpaceIndex::onRomResize(int offset, int change) {
+	// Every run after the change has moved, so it is simpler (and about as fast) to scan the whole rom again
+	build();
+}
+
+bool FreeSpaceIndex::fit(int start, int runLength, int length, int bankSize, int low, int high, int &offset) {
+	int pos = (start > low) ? start : low;
+	int end = ((start + runLength) < high) ? (start + runLength) : high;
+
+	if (bankSize > 0) {
+		if (length > bankSize) {
+			return false;
+		}
+
+		// If the data would go over the end of the bank, it has to start at the next one instead
+		int bankEnd = ((pos / bankSize) + 1) * bankSize;
+		if ((pos + length) > bankEnd) {
+			pos = bankEnd;
+		}
+	}
+
+	if ((pos + length) > end) {
+		return false;
+	}
+
+	offset = pos;
+	return true;
+}
+
+bool FreeSpaceIndex::find(int length, int bankSize, int &offset, int low, int high) {
+	if (length <= 0) {
+		return false;
+	}
+
+	// The runs are in order of size, so the first one that fits is the best fit
+	std::set< std::pair<int, int> >::iterator it = _bySize.lower_bound(std::make_pair(length, INT_MIN));
+	for (; it != _bySize.end(); it++) {
+		if (fit(it->second, it->first, length, bankSize, low, high, offset)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FreeSpaceIndex::allocate(int length, int bankSize, int &offset, int low, int high) {
+	if (!find(length, bankSize, offset, low, high)) {
+		return false;
+	}
+
+	// The run is split around the space that was taken, and whatever is left on either side goes back in
+	std::map<int, int>::iterator run = _byStart.upper_bound(offset);
+	run--;
+	int runStart = run->first;
+	int runEnd = run->first + run->second;
+	removeRun(run);
+
+	addRun(runStart, offset - runStart);
+	addRun(offset + length, runEnd - (offset + length));
+	_reserved[offset] = length;
+	return true;
+}
+
+void FreeSpaceIndex::release(int offset, int length) {
+	// The bytes haven't changed, so rescanning them is the same as if they were just written
+	onRomWrite(offset, length);
+}
+
+int FreeSpaceIndex::largest() {
+	if (_bySize.empty()) {
+		return 0;
+	}
+	return _bySize.rbegin()->first;
+}
@@ -0,0 +1,66 @@
+#ifndef HEXER_FREESPACE_H
+#define HEXER_FREESPACE_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <map>
+#include <set>
+#include <climits>
+
+#include "rom.h"
+
+/* Hexer Free Space Index
+ * Keeps track of every run of a filler byte (usually FF or 00) in the rom
+ * that is at least a minimum length. The runs are kept both by address and
+ * by size, so that finding the smallest run that fits some data is quick.
+ * The index listens to the rom, and only rescans the area around a write.
+ * Space that has been allocated stays out of the index until it is written
+ * or released, even if a write next to it rescans the filler it still holds.
+ */
+class FreeSpaceIndex : public RomListener {
+public:
+	FreeSpaceIndex(Rom *rom, wxByte filler, int minLength);
+	~FreeSpaceIndex();
+
+	void build();								// Scans the whole rom
+
+	/* Both of these look for the smallest run that can hold length bytes without crossing a bank
+	 * boundary (a bankSize of 0 means there are no banks), and that is within [low, high).
+	 * Allocate also takes the space out of the index, so it can't be given out twice before it is written
+	 */
+	bool find(int length, int bankSize, int &offset, int low = 0, int high = INT_MAX);
+	bool allocate(int length, int bankSize, int &offset, int low = 0, int high = INT_MAX);
+	void release(int offset, int length);		// Gives back space that was allocated but never written, so it can't be written after this
+
+	wxByte filler() { return _filler; }
+	   int minLength() { return _minLength; }
+	   int runCount() { return _byStart.size(); }
+	   int largest();
+	  long total() { return _total; }
+
+	void onRomWrite(int offset, int length) wxOVERRIDE;
+	void onRomResize(int offset, int change) wxOVERRIDE;
+
+private:
+	Rom *_rom;
+	wxByte _filler;
+	int _minLength;
+	long _total = 0;
+
+	std::map<int, int> _byStart;				// Start of the run -> length of the run
+	std::set< std::pair<int, int> > _bySize;	// (length, start) of every run, smallest first
+	std::map<int, int> _reserved;				// Start -> length of the space that was allocated but not written yet
+
+	void addRun(int start, int length);
+	void addFree(int start, int length);
+	void removeRun(std::map<int, int>::iterator run);
+	void scan(int start, int end);
+	bool fit(int start, int runLength, int length, int bankSize, int low, int high, int &offset);
+};
+
+#endif
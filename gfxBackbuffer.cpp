@@ -0,0 +1,272 @@
+#include "gfxBackbuffer.h"
+#include "romEditor.h"
+#include "gfxDecode.h"
+
+void gfxColours(RomEditorTable *table, int brightness, unsigned char *colours) {
+	memset(colours, 0, 256 * 3);
+	for (int i = 0; (i < 256) && (i < table->_gfxPalette.size()); i++) {
+		colours[(i * 3)]     = table->_gfxPalette[i].Red() << brightness;
+		colours[(i * 3) + 1] = table->_gfxPalette[i].Green() << brightness;
+		colours[(i * 3) + 2] = table->_gfxPalette[i].Blue() << brightness;
+	}
+}
+
+void gfxTileRGB(RomEditorTable *table, const TileKey &key, TileDecoder decoder, DirectDecoder direct, int tileBytes, const unsigned char *colours, unsigned char *rgb) {
+	if (table->_tileCache.find(key, rgb)) {
+		return;
+	}
+
+	wxByte data[kGfxMaxTileBytes] = {0};
+	table->_rom->readBytes(key._offset, data, tileBytes);
+
+	if (direct != nullptr) {
+		direct(data, rgb, kGfxTilePixels);
+
+	} else {
+		wxByte pixels[kGfxTilePixels];
+		decoder(data, pixels);
+		for (int i = 0; i < kGfxTilePixels; i++) {
+			memcpy(&rgb[i * 3], &colours[pixels[i] * 3], 3);
+		}
+	}
+	table->_tileCache.add(key, rgb, tileBytes);
+}
+
+// The same as getOffset, for the first tile of a row
+int GfxBackbuffer::rowOffset(int row) {
+	int rowSize = 16 * _format._stride;
+	return _format._offset + ((row - (_format._offset / rowSize)) * rowSize);
+}
+
+void GfxBackbuffer::prepare(wxGrid &grid, RomEditorTable *table) {
+	GfxBackbufferFormat format;
+	format._offset = table->_offset;
+	format._stride = table->_gfxByteSize;
+	format._bitDepth = table->gfxDepth();
+	format._gfxType = table->_gfxType->GetSelection();
+	format._palette = table->_gfxPaletteId;
+	format._brightness = 8 - table->_gfxPalCtrl->GetValue();
+	format._cellWidth = grid.GetColSize(1);
+	format._cellHeight = grid.GetDefaultRowSize();
+
+	// The visible rows are whatever rows are at the top and bottom of the grid window
+	int x = 0;
+	int y = 0;
+	grid.CalcUnscrolledPosition(0, 0, &x, &y);
+	int height = grid.GetGridWindow()->GetClientSize().GetHeight();
+
+	int firstRow = grid.YToRow(y);
+	int lastRow = grid.YToRow(y + height - 1);
+	if (firstRow < 0) {
+		firstRow = 0;
+	}
+	if (lastRow < 0) {
+		lastRow = grid.GetNumberRows() - 1;
+	}
+	int rows = (lastRow - firstRow) + 1;
+	if ((rows <= 0) || (format._cellWidth <= 0) || (format._cellHeight <= 0)) {
+		return;
+	}
+
+	// A different format means every row looks different
+	if (!(format == _format)) {
+		_format = format;
+		_rows = 0;
+
+		gfxColours(table, _format._brightness, _colours);
+	}
+
+	// Prefetching only has to be looked at again when the view moved or looks different
+	bool moved = (rows != _rows) || (firstRow != _firstRow);
+	if (moved) {
+		table->_prefetcher.scrolled(firstRow);
+	}
+
+	if (rows != _rows) {
+		_rows = rows;
+		_firstRow = firstRow;
+		_rgb.assign(_rows * rowBytes(), 0);
+		_rowValid.assign(_rows, false);
+
+	} else if (firstRow != _firstRow) {
+		// The rows that are still visible are moved up or down to where they are now
+		int shift = firstRow - _firstRow;
+		int keep = _rows - abs(shift);
+		if (keep <= 0) {
+			_rowValid.assign(_rows, false);
+
+		} else if (shift > 0) {
+			memmove(&_rgb[0], &_rgb[shift * rowBytes()], keep * rowBytes());
+			for (int i = 0; i < _rows; i++) {
+				_rowValid[i] = (i < keep) ? _rowValid[i + shift] : false;
+			}
+
+		} else {
+			memmove(&_rgb[-shift * rowBytes()], &_rgb[0], keep * rowBytes());
+			for (int i = _rows - 1; i >= 0; i--) {
+				_rowValid[i] = (i >= -shift) ? _rowValid[i + shift] : false;
+			}
+		}
+		_firstRow = firstRow;
+		_bitmapValid = false;
+	}
+
+	// The visible rows are always decoded here first, the prefetch threads only work on what comes after
+	bool rendered = false;
+	for (int i = 0; i < _rows; i++) {
+		if (!_rowValid[i]) {
+			renderRow(table, i);
+			_rowValid[i] = true;
+			_bitmapValid = false;
+			rendered = true;
+		}
+	}
+
+	if (moved || rendered) {
+		prefetch(table, grid.GetNumberRows());
+	}
+
+	// The bitmap is only made again if something in the buffer changed
+	if (!_bitmapValid) {
+		_memoryDC.SelectObject(wxNullBitmap);
+		wxImage image(16 * _format._cellWidth, _rows * _format._cellHeight, &_rgb[0], true);
+		_bitmap = wxBitmap(image);
+		_memoryDC.SelectObject(_bitmap);
+		_bitmapValid = true;
+	}
+}
+
+void GfxBackbuffer::renderRow(RomEditorTable *table, int index) {
+	int width = 16 * _format._cellWidth;
+	unsigned char *rowData = &_rgb[index * rowBytes()];
+	memset(rowData, 0, rowBytes());
+
+	TileDecoder decoder = getTileDecoder(_format._gfxType, _format._bitDepth);
+	DirectDecoder direct = (_format._gfxType == kGfxTypeRGB) ? getDirectDecoder(_format._bitDepth) : nullptr;
+	if ((decoder == nullptr) && (direct == nullptr)) {
+		return;
+	}
+
+	// The tile is zoomed by the largest whole number that fits the cell, and centered in it
+	int zoom = wxMin(_format._cellWidth, _format._cellHeight) / 8;
+	if (zoom < 1) {
+		zoom = 1;
+	}
+	int tileSize = 8 * zoom;
+	int marginX = wxMax(0, (_format._cellWidth - tileSize) / 2);
+	int marginY = wxMax(0, (_format._cellHeight - tileSize) / 2);
+	int drawWidth = wxMin(tileSize, _format._cellWidth - marginX);
+
+	int tileBytes = gfxTileBytes(_format._gfxType, _format._bitDepth);
+	int start = rowOffset(_firstRow + index);
+
+	TileKey key;
+	key._bitDepth = _format._bitDepth;
+	key._gfxType = _format._gfxType;
+	key._palette = _format._palette;
+	key._brightness = _format._brightness;
+
+	wxVector<unsigned char> line(tileSize * 3);
+	unsigned char tile[kTileRGBBytes];
+	for (int col = 0; col < 16; col++) {
+		int offset = start + (col * _format._stride);
+
+		// Tiles past the end of the rom are left empty (the renderer shows them as not part of the rom)
+		if ((offset < 0) || ((offset + _format._stride) > table->_size)) {
+			continue;
+		}
+
+		key._offset = offset;
+		gfxTileRGB(table, key, decoder, direct, tileBytes, _colours, tile);
+
+		// Each row of the tile is widened once, and then copied for as many lines as the zoom
+		for (int ty = 0; ty < 8; ty++) {
+			for (int tx = 0; tx < 8; tx++) {
+				for (int z = 0; z < zoom; z++) {
+					memcpy(&line[((tx * zoom) + z) * 3], &tile[((ty * 8) + tx) * 3], 3);
+				}
+			}
+
+			for (int z = 0; z < zoom; z++) {
+				int y = marginY + (ty * zoom) + z;
+				if (y >= _format._cellHeight) {
+					break;
+				}
+				memcpy(&rowData[((y * width) + (col * _format._cellWidth) + marginX) * 3], &line[0], drawWidth * 3);
+			}
+		}
+	}
+}
+
+void GfxBackbuffer::prefetch(RomEditorTable *table, int numRows) {
+	int ahead = table->_prefetcher.rowsAhead(_rows);
+	int direction = (ahead > 0) ? 1 : -1;
+	int row = (ahead > 0) ? (_firstRow + _rows) : (_firstRow - 1);
+
+	PrefetchJob job;
+	job._key._bitDepth = _format._bitDepth;
+	job._key._gfxType = _format._gfxType;
+	job._key._palette = _format._palette;
+	job._key._brightness = _format._brightness;
+	job._stride = _format._stride;
+	job._tileBytes = gfxTileBytes(_format._gfxType, _format._bitDepth);
+	job._writes = table->_tileCache.writes();
+	memcpy(job._colours, _colours, sizeof(_colours));
+
+	// The bytes are read here, since the rom can't be read from another thread while it is being edited
+	wxVector<PrefetchJob> jobs;
+	for (int i = 0; (i < abs(ahead)) && (row >= 0) && (row < numRows); i++, row += direction) {
+		job._offset = rowOffset(row);
+		if (job._offset < 0) {
+			continue;
+		}
+
+		job._tiles = 0;
+		while ((job._tiles < 16) && ((job._offset + ((job._tiles + 1) * job._stride)) <= table->_size)) {
+			job._tiles++;
+		}
+		if (job._tiles == 0) {
+			continue;
+		}
+
+		// The last tile can read a little past its stride, the same as it would when drawn
+		job._bytes.assign((16 * job._stride) + kGfxMaxTileBytes, 0);
+		table->_rom->readBytes(job._offset, &job._bytes[0], ((job._tiles - 1) * job._stride) + job._tileBytes);
+		jobs.push_back(job);
+	}
+
+	table->_prefetcher.queue(jobs);
+}
+
+void GfxBackbuffer::draw(wxDC &dc, const wxRect &rect, int row, int col) {
+	int index = row - _firstRow;
+	if (!_bitmapValid || (index < 0) || (index >= _rows)) {
+		dc.SetBrush(*wxBLACK_BRUSH);
+		dc.SetPen(*wxTRANSPARENT_PEN);
+		dc.DrawRectangle(rect);
+		return;
+	}
+
+	dc.Blit(rect.x, rect.y, rect.width, rect.height, &_memoryDC, (col - 1) * _format._cellWidth, index * _format._cellHeight);
+}
+
+void GfxBackbuffer::invalidate(int offset, int length) {
+	if (_rows == 0) {
+		return;
+	}
+
+	// A tile can read a little past its stride (linear gfx round the depth up), so rows just before the write count too
+	for (int i = 0; i < _rows; i++) {
+		int start = rowOffset(_firstRow + i);
+		int end = start + (16 * _format._stride) + kGfxMaxTileBytes;
+		if ((start < (offset + length)) && (end > offset)) {
+			_rowValid[i] = false;
+		}
+	}
+}
+
+void GfxBackbuffer::clear() {
+	_rows = 0;
+	_rowValid.clear();
+	_bitmapValid = false;
+}
@@ -0,0 +1,79 @@
+#ifndef HEXER_GFXBACKBUFFER_H
+#define HEXER_GFXBACKBUFFER_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+#include <wx/dcmemory.h>
+
+#include "tileCache.h"
+
+class wxGrid;
+class RomEditorTable;
+
+// Fills colours with the RGB of the gfx palette, with the brightness applied
+void gfxColours(RomEditorTable *table, int brightness, unsigned char *colours);
+
+/* Copies the RGB of a tile out of the tile cache, decoding it (and adding it to the cache) if it isn't there yet.
+ * Only one of the decoders is used, the direct one if there is one (for RGB gfx), otherwise the palette one
+ */
+void gfxTileRGB(RomEditorTable *table, const TileKey &key, TileDecoder decoder, DirectDecoder direct, int tileBytes, const unsigned char *colours, unsigned char *rgb);
+
+// Everything that changes what the backbuffer looks like, other than which rows are in it
+struct GfxBackbufferFormat {
+	int _offset = 0;						// The offset of the table, which decides where each row starts
+	int _stride = 0;						// Bytes per tile
+	int _bitDepth = 0;
+	int _gfxType = 0;
+	unsigned int _palette = 0;
+	int _brightness = 0;
+	int _cellWidth = 0;
+	int _cellHeight = 0;
+
+	bool operator==(const GfxBackbufferFormat &other) const {
+		return (_offset == other._offset) && (_stride == other._stride) && (_bitDepth == other._bitDepth)
+			&& (_gfxType == other._gfxType) && (_palette == other._palette) && (_brightness == other._brightness)
+			&& (_cellWidth == other._cellWidth) && (_cellHeight == other._cellHeight);
+	}
+};
+
+/* Hexer Gfx Backbuffer
+ * The gfx view is drawn from a single RGB buffer that holds every visible row of tiles,
+ * each one zoomed by a whole number with nearest neighbour so the pixels stay sharp.
+ * When the grid scrolls, the rows that are still visible are moved instead of being
+ * drawn again, so only the rows that scrolled into view get decoded. Each cell is then
+ * just a blit of its part of the one bitmap.
+ */
+class GfxBackbuffer {
+public:
+	void prepare(wxGrid &grid, RomEditorTable *table);		// Makes sure every visible row is in the buffer
+	void draw(wxDC &dc, const wxRect &rect, int row, int col);
+
+	void invalidate(int offset, int length);	// Rows with any of these bytes get drawn again
+	void clear();
+
+private:
+	GfxBackbufferFormat _format;
+	int _firstRow = 0;
+	int _rows = 0;
+
+	wxVector<unsigned char> _rgb;
+	wxVector<bool> _rowValid;
+	unsigned char _colours[256 * 3];		// The palette with the brightness applied
+
+	bool _bitmapValid = false;
+	wxBitmap _bitmap;
+	wxMemoryDC _memoryDC;
+
+	int rowOffset(int row);
+	int rowBytes() { return 16 * _format._cellWidth * _format._cellHeight * 3; }
+	void renderRow(RomEditorTable *table, int index);
+	void prefetch(RomEditorTable *table, int numRows);		// Queues the rows the view is heading towards
+};
+
+#endif
@@ -0,0 +1,278 @@
+#include "gfxDecode.h"
+#include "romEditor.h"
+
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#include <emmintrin.h>
+	#define HEXER_GFX_DECODE_SSE2
+#endif
+
+/* For planar gfx, every byte of a bitplane is one bit of 8 pixels. This table spreads
+ * those 8 bits out into 8 bytes (one per pixel, in the order they are drawn), so a whole
+ * row of a plane can be added to the pixels with a single shift and or.
+ * The bytes are put in with memcpy, so the table works the same on any endianness.
+ */
+struct SpreadTable {
+	uint64_t _values[256];
+
+	SpreadTable() {
+		for (int b = 0; b < 256; b++) {
+			wxByte pixels[8];
+			for (int x = 0; x < 8; x++) {
+				pixels[x] = (b >> (7 - x)) & 1;
+			}
+			memcpy(&_values[b], pixels, 8);
+		}
+	}
+};
+
+static const SpreadTable spread;
+
+// How the bitplanes of a tile are arranged
+enum PlaneLayout {
+	kPlanesSequential,
+	kPlanesPaired,
+	kPlanesByRow
+};
+
+/* Where the byte for row y of plane p is within a tile.
+ * Normal planar gfx have each plane one after the other (8 bytes each).
+ * Composite gfx have planes in pairs, with the two planes of a pair
+ * alternating by row (16 bytes per pair), and if there is an odd plane
+ * left over at the end, it is just 8 bytes on its own (like SNES 3bpp).
+ * Row interleaved gfx have one byte of every plane for each row (bpp bytes per row).
+ */
+template<int bpp, int layout>
+static inline int planeByte(int p, int y) {
+	if (layout == kPlanesSequential) {
+		return (p * 8) + y;
+	}
+	if (layout == kPlanesByRow) {
+		return (y * bpp) + p;
+	}
+
+	int pair = p / 2;
+	if (((pair * 2) + 1) < bpp) {
+		return (pair * 16) + (y * 2) + (p & 1);
+	}
+	return (pair * 16) + y;
+}
+
+template<int bpp, int layout>
+static void decodePlanar(const wxByte *data, wxByte *pixels) {
+	for (int y = 0; y < 8; y++) {
+		uint64_t row = 0;
+		for (int p = 0; p < bpp; p++) {
+			row |= spread._values[data[planeByte<bpp, layout>(p, y)]] << p;
+		}
+		memcpy(&pixels[y * 8], &row, 8);
+	}
+}
+
+/* Linear gfx have the pixels packed one after the other, bits per pixel at a time.
+ * Depths that don't fit evenly into a byte are stored in the next size up,
+ * and only the low bits are used. Normally the first pixel is in the low bits
+ * of the byte (like the GBA), and reversed has it in the high bits (like the Genesis).
+ */
+template<int bits, int bpp, bool reversed>
+static void decodeLinear(const wxByte *data, wxByte *pixels) {
+	const int perByte = 8 / bits;
+	const int mask = (1 << bpp) - 1;
+
+	if (bits == 8) {
+		for (int i = 0; i < kGfxTilePixels; i++) {
+			pixels[i] = data[i] & mask;
+		}
+		return;
+	}
+
+	for (int i = 0; i < (kGfxTilePixels / perByte); i++) {
+		wxByte byte = data[i];
+		for (int n = 0; n < perByte; n++) {
+			int shift = reversed ? (8 - (bits * (n + 1))) : (bits * n);
+			pixels[(i * perByte) + n] = (byte >> shift) & mask;
+		}
+	}
+}
+
+static const TileDecoder planarDecoders[8] = {
+	decodePlanar<1, kPlanesSequential>, decodePlanar<2, kPlanesSequential>, decodePlanar<3, kPlanesSequential>, decodePlanar<4, kPlanesSequential>,
+	decodePlanar<5, kPlanesSequential>, decodePlanar<6, kPlanesSequential>, decodePlanar<7, kPlanesSequential>, decodePlanar<8, kPlanesSequential>
+};
+
+static const TileDecoder compositeDecoders[8] = {
+	decodePlanar<1, kPlanesPaired>, decodePlanar<2, kPlanesPaired>, decodePlanar<3, kPlanesPaired>, decodePlanar<4, kPlanesPaired>,
+	decodePlanar<5, kPlanesPaired>, decodePlanar<6, kPlanesPaired>, decodePlanar<7, kPlanesPaired>, decodePlanar<8, kPlanesPaired>
+};
+
+static const TileDecoder planarRowDecoders[8] = {
+	decodePlanar<1, kPlanesByRow>, decodePlanar<2, kPlanesByRow>, decodePlanar<3, kPlanesByRow>, decodePlanar<4, kPlanesByRow>,
+	decodePlanar<5, kPlanesByRow>, decodePlanar<6, kPlanesByRow>, decodePlanar<7, kPlanesByRow>, decodePlanar<8, kPlanesByRow>
+};
+
+static const TileDecoder linearDecoders[8] = {
+	decodeLinear<1, 1, false>, decodeLinear<2, 2, false>, decodeLinear<4, 3, false>, decodeLinear<4, 4, false>,
+	decodeLinear<8, 5, false>, decodeLinear<8, 6, false>, decodeLinear<8, 7, false>, decodeLinear<8, 8, false>
+};
+
+static const TileDecoder linearRevDecoders[8] = {
+	decodeLinear<1, 1, true>, decodeLinear<2, 2, true>, decodeLinear<4, 3, true>, decodeLinear<4, 4, true>,
+	decodeLinear<8, 5, true>, decodeLinear<8, 6, true>, decodeLinear<8, 7, true>, decodeLinear<8, 8, true>
+};
+
+TileDecoder getTileDecoder(int gfxType, int bitDepth) {
+	if ((bitDepth < 1) || (bitDepth > 8)) {
+		return nullptr;
+	}
+
+	switch (gfxType) {
+	case kGfxTypePlanar:
+		return planarDecoders[bitDepth - 1];
+
+	case kGfxTypePlanarComp:
+		return compositeDecoders[bitDepth - 1];
+
+	case kGfxTypePlanarRow:
+		return planarRowDecoders[bitDepth - 1];
+
+	case kGfxTypeLinear:
+		return linearDecoders[bitDepth - 1];
+
+	case kGfxTypeLinearRev:
+		return linearRevDecoders[bitDepth - 1];
+
+	default:
+		return nullptr;
+	}
+}
+
+int gfxTileBytes(int gfxType, int bitDepth) {
+	if (gfxType == kGfxTypeRGB) {
+		return kGfxTilePixels * gfxPixelBytes(bitDepth);
+	}
+
+	if ((gfxType == kGfxTypeLinear) || (gfxType == kGfxTypeLinearRev)) {
+		// Linear depths are rounded up to 1, 2, 4 or 8 bits
+		int bits = 1;
+		while (bits < bitDepth) {
+			bits <<= 1;
+		}
+		return bits * 8;
+	}
+	return bitDepth * 8;
+}
+
+/* 16 bit colours have each channel at a shift, with 5 bits (or 6 for the green of 565).
+ * A channel is made 8 bits by copying its high bits into the low bits it is missing,
+ * so that full brightness is FF and not F8. With SSE2 that is done for 8 pixels at once,
+ * but SSE2 can't shuffle bytes, so putting the channels back together is still one pixel at a time.
+ */
+template<int rShift, int gShift, int gBits, int bShift>
+static void decode16(const wxByte *data, unsigned char *rgb, int pixels) {
+	int i = 0;
+
+#ifdef HEXER_GFX_DECODE_SSE2
+	const __m128i mask5 = _mm_set1_epi16(0x1F);
+	const __m128i maskG = _mm_set1_epi16((1 << gBits) - 1);
+	wxByte rb[16];
+	wxByte gg[16];
+	for (; (i + 8) <= pixels; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *) &data[i * 2]);
+		__m128i r = _mm_and_si128(_mm_srli_epi16(v, rShift), mask5);
+		__m128i g = _mm_and_si128(_mm_srli_epi16(v, gShift), maskG);
+		__m128i b = _mm_and_si128(_mm_srli_epi16(v, bShift), mask5);
+
+		r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+		b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+		if (gBits == 6) {
+			g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+		} else {
+			g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+		}
+
+		// The red and blue end up in one register, 8 bytes each
+		_mm_storeu_si128((__m128i *) rb, _mm_packus_epi16(r, b));
+		_mm_storeu_si128((__m128i *) gg, _mm_packus_epi16(g, g));
+		for (int p = 0; p < 8; p++) {
+			rgb[((i + p) * 3)]     = rb[p];
+			rgb[((i + p) * 3) + 1] = gg[p];
+			rgb[((i + p) * 3) + 2] = rb[p + 8];
+		}
+	}
+#endif
+
+	for (; i < pixels; i++) {
+		int v = data[i * 2] | (data[(i * 2) + 1] << 8);
+		int r = (v >> rShift) & 0x1F;
+		int g = (v >> gShift) & ((1 << gBits) - 1);
+		int b = (v >> bShift) & 0x1F;
+
+		rgb[(i * 3)]     = (r << 3) | (r >> 2);
+		rgb[(i * 3) + 1] = (gBits == 6) ? ((g << 2) | (g >> 4)) : ((g << 3) | (g >> 2));
+		rgb[(i * 3) + 2] = (b << 3) | (b >> 2);
+	}
+}
+
+static void decodeRGB888(const wxByte *data, unsigned char *rgb, int pixels) {
+	memcpy(rgb, data, pixels * 3);
+}
+
+// The alpha is dropped, since there is nothing behind the gfx to blend with
+static void decodeARGB8888(const wxByte *data, unsigned char *rgb, int pixels) {
+	for (int i = 0; i < pixels; i++) {
+		rgb[(i * 3)]     = data[(i * 4) + 2];
+		rgb[(i * 3) + 1] = data[(i * 4) + 1];
+		rgb[(i * 3) + 2] = data[(i * 4)];
+	}
+}
+
+/* Every console preset is just the type and depth that its tiles use, which picks
+ * one of the decoders above. Mode 7 tiles are stored in the rom as 8bpp linear,
+ * and only get interleaved with the tilemap once they are in vram.
+ */
+static const GfxPreset gfxPresets[] = {
+	{"None",              -1,                 0},
+	{"NES 2bpp",          kGfxTypePlanar,     2},
+	{"Game Boy 2bpp",     kGfxTypePlanarComp, 2},
+	{"SNES 2bpp",         kGfxTypePlanarComp, 2},
+	{"SNES 3bpp",         kGfxTypePlanarComp, 3},
+	{"SNES 4bpp",         kGfxTypePlanarComp, 4},
+	{"SNES 8bpp",         kGfxTypePlanarComp, 8},
+	{"SNES Mode 7",       kGfxTypeLinear,     8},
+	{"SMS / GG 4bpp",     kGfxTypePlanarRow,  4},
+	{"Genesis 4bpp",      kGfxTypeLinearRev,  4},
+	{"GBA 4bpp",          kGfxTypeLinear,     4},
+	{"GBA 8bpp",          kGfxTypeLinear,     8}
+};
+
+int gfxPresetCount() {
+	return sizeof(gfxPresets) / sizeof(gfxPresets[0]);
+}
+
+const GfxPreset &getGfxPreset(int index) {
+	if ((index < 0) || (index >= gfxPresetCount())) {
+		return gfxPresets[0];
+	}
+	return gfxPresets[index];
+}
+
+static const DirectDecoder directDecoders[kGfxDirectFormats] = {
+	decode16<10, 5, 5, 0>, decode16<0, 5, 5, 10>, decode16<11, 5, 6, 0>, decodeRGB888, decodeARGB8888
+};
+
+static const int directPixelBytes[kGfxDirectFormats] = {2, 2, 2, 3, 4};
+
+DirectDecoder getDirectDecoder(int format) {
+	if ((format < 0) || (format >= kGfxDirectFormats)) {
+		return nullptr;
+	}
+	return directDecoders[format];
+}
+
+int gfxPixelBytes(int format) {
+	if ((format < 0) || (format >= kGfxDirectFormats)) {
+		return 0;
+	}
+	return directPixelBytes[format];
+}
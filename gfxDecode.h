@@ -0,0 +1,54 @@
+#ifndef HEXER_GFXDECODE_H
+#define HEXER_GFXDECODE_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+enum GfxTileSize {
+	kGfxTilePixels   = 64,					// Every tile is 8x8
+	kGfxMaxTileBytes = 256					// And a tile of 32 bit direct colour is the most bytes one can take up
+};
+
+/* Hexer Gfx Decoding
+ * A tile decoder turns the bytes of one 8x8 tile into 64 palette indices,
+ * left to right and top to bottom. There is a decoder made at compile time for
+ * every gfx type and bit depth, so none of them have to work out the layout per pixel.
+ */
+typedef void (*TileDecoder)(const wxByte *data, wxByte *pixels);
+
+TileDecoder getTileDecoder(int gfxType, int bitDepth);	// The decoder for the type and depth, or nullptr if there isn't one
+		int gfxTileBytes(int gfxType, int bitDepth);	// How many bytes the decoder reads for one tile
+
+// The direct colour formats, where for RGB gfx this takes the place of the bit depth
+enum GfxDirectFormat {
+	kGfxRGB555,								// 16 bit little endian, red in the high bits
+	kGfxBGR555,								// 16 bit little endian, blue in the high bits (SNES, GBA)
+	kGfxRGB565,
+	kGfxRGB888,								// 3 bytes in the order red, green, blue
+	kGfxARGB8888,							// 32 bit little endian, so the bytes are blue, green, red, alpha
+	kGfxDirectFormats
+};
+
+/* A direct decoder turns any number of pixels of direct colour into RGB.
+ * For a tile that is 64 pixels, but a whole line of a bitmap can be done at once too
+ */
+typedef void (*DirectDecoder)(const wxByte *data, unsigned char *rgb, int pixels);
+
+// A console preset is the gfx type and bit depth of its tile format (a type of -1 means it doesn't change anything)
+struct GfxPreset {
+	const char *_name;
+	int _gfxType;
+	int _bitDepth;
+};
+
+			int gfxPresetCount();
+const GfxPreset &getGfxPreset(int index);
+
+DirectDecoder getDirectDecoder(int format);			// The decoder for the format, or nullptr if there isn't one
+		  int gfxPixelBytes(int format);			// How many bytes each pixel of the format takes up
+
+#endif
@@ -64,9 +64,12 @@ void HexerFrame::populateHexView() {
 	_gridLines->Bind(wxEVT_CHECKBOX, &HexerFrame::onGridLinesCheck, this);
 
 	// Last is a choice box with the different presets for different consoles, with a label next to it
-	wxString presetChoices[7] = {"None", "Nintendo", "Master System", "Gameboy", "Super Nintendo", "Genesis", "Gameboy Advance"};
+	wxArrayString presetChoices;
+	for (int i = 0; i < gfxPresetCount(); i++) {
+		presetChoices.Add(getGfxPreset(i)._name);
+	}
 	wxStaticText *presetTxt = new wxStaticText(_hexView, wxID_ANY, "Console Preset ");
-	    wxChoice *presetChoice = new wxChoice(_hexView, wxID_ANY, wxDefaultPosition, wxDefaultSize, 7, presetChoices, 0, wxDefaultValidator, wxEmptyString);
+	    wxChoice *presetChoice = new wxChoice(_hexView, wxID_ANY, wxDefaultPosition, wxDefaultSize, presetChoices, 0, wxDefaultValidator, wxEmptyString);
 			      presetChoice->Bind(wxEVT_CHOICE, &HexerFrame::onPresetChoice, this);
 
 	// Now they can all be added to the main upper sizer
@@ -90,7 +93,11 @@ void HexerFrame::populateHexView() {
 
 	// This table data won't change, but the view of it will, so we need the createHexEditor to use _hexTable
 	// We start the table off with the view type as bytes
-	_hexTable = new RomEditorTable(_rom->_rom->Length(), _rom, kViewTypeBytes);
+	_hexTable = new RomEditorTable(_rom->size(), _rom, kViewTypeBytes);
+	if (_patchStates != nullptr) {
+		_hexTable->_patchIndex = _patchStates->index();
+	}
+	_hexTable->_docsMap = &_docsMap;
 
 	// Now we can create the header (which won't be re-made) and the editor itself (which needs to be able to re-make itself)
 	createHexEditorHeader();
@@ -128,6 +135,7 @@ void HexerFrame::populateHexView() {
 
 	wxStaticBoxSizer *controlPanel = new wxStaticBoxSizer(wxVERTICAL, _hexView, "Controls");
 	wxStaticBoxSizer *selectionPanel = new wxStaticBoxSizer(wxVERTICAL, _hexView, "Selection");
+	wxStaticBoxSizer *previewPanel = new wxStaticBoxSizer(wxHORIZONTAL, _hexView, "Preview");
 
 	// String View includes:
 	// A button for loading a new string table
@@ -149,11 +157,27 @@ void HexerFrame::populateHexView() {
 	stringByteSizeSizer->Add(stringByteText, 0, wxALIGN_CENTER_VERTICAL);
 	stringByteSizeSizer->Add(_hexTable->_stringCtrl);
 
+	// A checkbox for decoding the rom as a stream of text instead of fixed size characters
+	wxCheckBox *stringStream = new wxCheckBox(_stringPanel->GetStaticBox(), wxID_ANY, "Decode as Stream", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, wxEmptyString);
+	stringStream->Bind(wxEVT_CHECKBOX, &HexerFrame::onStringStreamCheck, this);
+
+	// Buttons for dumping the strings to a script, and inserting an edited script back in
+	wxBoxSizer *scriptSizer = new wxBoxSizer(wxHORIZONTAL);
+	wxButton *dumpScript = new wxButton(_stringPanel->GetStaticBox(), wxID_ANY, "Dump Script");
+			  dumpScript->Bind(wxEVT_BUTTON, &HexerFrame::onDumpScript, this);
+	wxButton *insertScript = new wxButton(_stringPanel->GetStaticBox(), wxID_ANY, "Insert Script");
+			  insertScript->Bind(wxEVT_BUTTON, &HexerFrame::onInsertScript, this);
+
+	scriptSizer->Add(dumpScript, 1, wxGROW | wxRIGHT, 5);
+	scriptSizer->Add(insertScript, 1, wxGROW);
+
 	// And lastly, a search control for searching by string
 	wxSearchCtrl *searchBar = new wxSearchCtrl(_stringPanel->GetStaticBox(), wxID_ANY, wxEmptyString);
 
 	_stringPanel->Add(loadStringTable, 0, wxGROW | wxBOTTOM, 10);
 	_stringPanel->Add(stringByteSizeSizer, 0, wxGROW | wxBOTTOM, 10);
+	_stringPanel->Add(stringStream, 0, wxGROW | wxBOTTOM, 10);
+	_stringPanel->Add(scriptSizer, 0, wxGROW | wxBOTTOM, 10);
 	_stringPanel->Add(searchBar, 0, wxGROW | wxBOTTOM, 6);
 
 	// Palette View includes:
@@ -181,11 +205,27 @@ void HexerFrame::populateHexView() {
 	_hexTable->_formatCtrl = new wxSpinCtrl(_palettePanel->GetStaticBox(), wxID_ANY, "1", wxDefaultPosition, wxDefaultSize, 0, 1, 8, 0, wxEmptyString);
 	_hexTable->_formatCtrl->Bind(wxEVT_SPINCTRL, &HexerFrame::onFormatChanged, this);
 
+	wxString orderChoices[2] = {"RGB", "BGR"};
+	_hexTable->_clrOrderCtrl = new wxChoice(_palettePanel->GetStaticBox(), wxID_ANY, wxDefaultPosition, wxDefaultSize, 2, orderChoices, 0, wxDefaultValidator, wxEmptyString);
+	_hexTable->_clrOrderCtrl->SetSelection(kColourRGB);
+	_hexTable->_clrOrderCtrl->Bind(wxEVT_CHOICE, &HexerFrame::onColourOrderChanged, this);
+
+	// A button for changing a whole selection of colours at once
+	wxButton *clrAdjust = new wxButton(_palettePanel->GetStaticBox(), wxID_ANY, "Adjust Selection", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, wxEmptyString);
+			  clrAdjust->Bind(wxEVT_BUTTON, &HexerFrame::onAdjustPalette, this);
+
 	// And lastly the index related controls
 	_hexTable->_clrIndexCheck = new wxCheckBox(_palettePanel->GetStaticBox(), wxID_ANY, "Indexed", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, wxEmptyString);
 	   wxButton *clrIndexLoad = new wxButton(_palettePanel->GetStaticBox(), wxID_ANY, "Load Palette", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, wxEmptyString);
 	   			 clrIndexLoad->Bind(wxEVT_BUTTON, &HexerFrame::onLoadIndexedPalette, this);
 
+	// Palette files can also go straight into the rom, or be made from it
+	wxBoxSizer *fileSizer = new wxBoxSizer(wxHORIZONTAL);
+	wxButton *clrImport = new wxButton(_palettePanel->GetStaticBox(), wxID_ANY, "Import", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, wxEmptyString);
+			  clrImport->Bind(wxEVT_BUTTON, &HexerFrame::onImportPalette, this);
+	wxButton *clrExport = new wxButton(_palettePanel->GetStaticBox(), wxID_ANY, "Export", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, wxEmptyString);
+			  clrExport->Bind(wxEVT_BUTTON, &HexerFrame::onExportPalette, this);
+
 	// Now we can add all of them to the sizer
 	clrSizer->Add(clrTxt,  0, wxALIGN_CENTER_VERTICAL);
 	clrSizer->Add(clrCtrl, 0, wxLEFT, 5);
@@ -193,13 +233,19 @@ void HexerFrame::populateHexView() {
 
 	formatSizer->Add(formatTxt, 0, wxALIGN_CENTER_VERTICAL);
 	formatSizer->Add(_hexTable->_formatCtrl);
+	formatSizer->Add(_hexTable->_clrOrderCtrl, 0, wxLEFT, 5);
 
 	indexSizer->Add(_hexTable->_clrIndexCheck, 0, wxALIGN_CENTER_VERTICAL);
 	indexSizer->Add(clrIndexLoad, 0, wxLEFT, 5);
 
+	fileSizer->Add(clrImport, 1);
+	fileSizer->Add(clrExport, 1, wxLEFT, 5);
+
 	_palettePanel->Add(clrSizer,    0, wxGROW | wxBOTTOM, 6);
 	_palettePanel->Add(formatSizer, 0, wxGROW | wxBOTTOM, 6);
+	_palettePanel->Add(clrAdjust,   0, wxGROW | wxBOTTOM, 6);
 	_palettePanel->Add(indexSizer,  0, wxGROW | wxBOTTOM | wxALIGN_LEFT, 6);
+	_palettePanel->Add(fileSizer,   0, wxGROW | wxBOTTOM, 6);
 
 	// Graphics View includes:
 	// A spin control for the bit depth of the gfx
@@ -210,6 +256,7 @@ void HexerFrame::populateHexView() {
 	wxBoxSizer *gfxSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxBoxSizer *gfxPalSizer = new wxBoxSizer(wxHORIZONTAL);
 	wxBoxSizer *gfxTypeSizer = new wxBoxSizer(wxHORIZONTAL);
+	wxBoxSizer *gfxRGBSizer = new wxBoxSizer(wxHORIZONTAL);
 
 	// The controls themselves
 	wxStaticText *gfxTxt = new wxStaticText(_gfxPanel->GetStaticBox(), wxID_ANY, "Bits per pixel (bpp) ");
@@ -223,11 +270,21 @@ void HexerFrame::populateHexView() {
 	wxButton *gfxLoadPal = new wxButton(_gfxPanel->GetStaticBox(), wxID_ANY, "Load Palette", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, wxEmptyString);
 			  gfxLoadPal->Bind(wxEVT_BUTTON, &HexerFrame::onChangeGfxPalette, this);
 
+	wxButton *gfxSheet = new wxButton(_gfxPanel->GetStaticBox(), wxID_ANY, "Tile Sheet", wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, wxEmptyString);
+			  gfxSheet->Bind(wxEVT_BUTTON, &HexerFrame::onShowTileSheet, this);
+
 	wxStaticText *gfxTypeTxt = new wxStaticText(_gfxPanel->GetStaticBox(), wxID_ANY, "Type ");
-	wxString gfxTypeChoices[5] = {"Planar", "Planar (Composite)", "Linear", "Linear (Reversed)", "RGB"};
-	_hexTable->_gfxType = new wxChoice(_gfxPanel->GetStaticBox(), wxID_ANY, wxDefaultPosition, wxDefaultSize, 5, gfxTypeChoices, 0, wxDefaultValidator, wxEmptyString);
+	wxString gfxTypeChoices[6] = {"Planar", "Planar (Composite)", "Linear", "Linear (Reversed)", "RGB", "Planar (Row Interleaved)"};
+	_hexTable->_gfxType = new wxChoice(_gfxPanel->GetStaticBox(), wxID_ANY, wxDefaultPosition, wxDefaultSize, 6, gfxTypeChoices, 0, wxDefaultValidator, wxEmptyString);
 	_hexTable->_gfxType->Bind(wxEVT_CHOICE, &HexerFrame::onGfxRefresh, this);
 
+	// RGB gfx don't use the bpp, they have their own formats instead
+	wxStaticText *gfxRGBTxt = new wxStaticText(_gfxPanel->GetStaticBox(), wxID_ANY, "RGB format ");
+	wxString gfxRGBChoices[kGfxDirectFormats] = {"RGB555", "BGR555", "RGB565", "RGB888", "ARGB8888"};
+	_hexTable->_gfxRGBFormat = new wxChoice(_gfxPanel->GetStaticBox(), wxID_ANY, wxDefaultPosition, wxDefaultSize, kGfxDirectFormats, gfxRGBChoices, 0, wxDefaultValidator, wxEmptyString);
+	_hexTable->_gfxRGBFormat->SetSelection(kGfxBGR555);
+	_hexTable->_gfxRGBFormat->Bind(wxEVT_CHOICE, &HexerFrame::onGfxRefresh, this);
+
 	// Add them to the sizers
 	gfxSizer->Add(gfxTxt, 0, wxALIGN_CENTER_VERTICAL);
 	gfxSizer->Add(_hexTable->_gfxCtrl);
@@ -237,11 +294,16 @@ void HexerFrame::populateHexView() {
 
 	gfxTypeSizer->Add(gfxTypeTxt, 0, wxALIGN_CENTER_VERTICAL);
 	gfxTypeSizer->Add(_hexTable->_gfxType);
+
+	gfxRGBSizer->Add(gfxRGBTxt, 0, wxALIGN_CENTER_VERTICAL);
+	gfxRGBSizer->Add(_hexTable->_gfxRGBFormat);
 	// And lastly add the sizer to the panel
 	_gfxPanel->Add(gfxSizer, 0, wxGROW | wxBOTTOM, 6);
 	_gfxPanel->Add(gfxTypeSizer, 0, wxGROW | wxBOTTOM, 6);
+	_gfxPanel->Add(gfxRGBSizer, 0, wxGROW | wxBOTTOM, 6);
 	_gfxPanel->Add(gfxPalSizer, 0, wxGROW | wxBOTTOM, 6);
 	_gfxPanel->Add(gfxLoadPal, 0, wxGROW | wxBOTTOM, 6);
+	_gfxPanel->Add(gfxSheet, 0, wxGROW | wxBOTTOM, 6);
 
 	// Control box includes:
 	// 4 arrow buttons (and maybe other stuff?)
@@ -275,8 +337,13 @@ void HexerFrame::populateHexView() {
 	hBox->Add(vBox);
 	hBox->Add(rightArrow, 0, wxALIGN_CENTER_VERTICAL);
 
+	// Below the arrows is a button for finding free space in the rom
+	wxButton *findFreeSpace = new wxButton(controlPanel->GetStaticBox(), wxID_ANY, "Free Space");
+			  findFreeSpace->Bind(wxEVT_BUTTON, &HexerFrame::onFindFreeSpace, this);
+
 	// And finally to the box
 	controlPanel->Add(hBox, 0, wxGROW | wxBOTTOM, 6);
+	controlPanel->Add(findFreeSpace, 0, wxGROW | wxBOTTOM, 6);
 
 	// Selection box includes:
 	// Button to make document entry
@@ -291,7 +358,22 @@ void HexerFrame::populateHexView() {
 	controlSelect->Add(controlPanel);
 	controlSelect->Add(selectionPanel, 0, wxLEFT, 10);
 
+	// Preview box includes:
+	// Button to load an IPS patch over the rom without writing it
+	// Buttons to write the preview to the rom, or throw it away
+	wxButton *previewIPS = new wxButton(previewPanel->GetStaticBox(), wxID_ANY, "Load IPS...");
+	wxButton *commitPreview = new wxButton(previewPanel->GetStaticBox(), wxID_ANY, "Commit");
+	wxButton *discardPreview = new wxButton(previewPanel->GetStaticBox(), wxID_ANY, "Discard");
+			  previewIPS->Bind(wxEVT_BUTTON, &HexerFrame::onPreviewIPS, this);
+			  commitPreview->Bind(wxEVT_BUTTON, &HexerFrame::onCommitPreview, this);
+			  discardPreview->Bind(wxEVT_BUTTON, &HexerFrame::onDiscardPreview, this);
+
+	previewPanel->Add(previewIPS, 0, wxRIGHT | wxBOTTOM, 6);
+	previewPanel->Add(commitPreview, 0, wxRIGHT | wxBOTTOM, 6);
+	previewPanel->Add(discardPreview, 0, wxBOTTOM, 6);
+
 	viewTypeSizer->Add(controlSelect, 0, wxTOP, 15);
+	viewTypeSizer->Add(previewPanel, 0, wxGROW | wxTOP, 15);
 	viewTypeSizer->Add(_stringPanel, 0, wxTOP, 15);
 	viewTypeSizer->Add(_palettePanel, 0, wxTOP, 15);
 	viewTypeSizer->Add(_gfxPanel, 0, wxTOP, 15);
@@ -378,6 +460,10 @@ void HexerFrame::createHexEditor() {
 	_hexGrid = new wxGrid(_hexView, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxBORDER_DOUBLE, wxEmptyString);
 	_hexGrid->SetTable(_hexTable, false);
 
+	// The name of the doc under the mouse is shown as a tooltip
+	_hexGrid->GetGridWindow()->Bind(wxEVT_MOTION, &HexerFrame::onHexGridMotion, this);
+	_hoverDoc = nullptr;
+
 	// We need to set up some properties of the grid
 	_hexGrid->SetDefaultCellAlignment(wxALIGN_CENTER, wxALIGN_CENTER);
 	_hexGrid->SetRowLabelSize(0);
@@ -392,7 +478,7 @@ void HexerFrame::createHexEditor() {
 	_hexGrid->SetScrollLineY(_hexGrid->GetDefaultRowSize());
 
 	// The size of the offset box needs to be big enough to hold the largest offset, ie. the size of the file
-	wxSize offsetNumSize = _header->GetTextExtent(wxString::Format("%lld", _rom->_rom->Length() / 16) << "00");
+	wxSize offsetNumSize = _header->GetTextExtent(wxString::Format("%d", _rom->size() / 16) << "00");
 	int offsetSize = (offsetNumSize.GetWidth() >= _hexTable->_offsetLabelSize.GetWidth()) ? offsetNumSize.GetWidth() : _hexTable->_offsetLabelSize.GetWidth();
 	_hexGrid->SetColSize(0, offsetSize);
 	_header->SetColSize(0, offsetSize);
@@ -442,21 +528,9 @@ void HexerFrame::loadDefaultStringTable() {
 		stringTableName += prefFile.GetNextLine();
 	}
 
-	wxTextFile stringTable(stringTableName);
-	if (!stringTable.Open()) {
+	// The table is loaded straight into the table's lookup structure
+	if (!_hexTable->_stringTable.load(stringTableName)) {
 		wxLogError(wxString("Could not load string table file"));
-
-	} else {
-		for (wxString line = stringTable.GetFirstLine(); !stringTable.Eof(); line = stringTable.GetNextLine()) {
-			wxStringTokenizer lineTokenizer(line, "=");
-			
-			wxString key = lineTokenizer.GetNextToken();
-			wxString value = lineTokenizer.GetNextToken();
-			if (value.Cmp("EQU") == 0) {
-				value = "=";
-			}
-			_hexTable->_stringTable[key] = value;
-		}
 	}
 }
 
@@ -485,6 +559,9 @@ void HexerFrame::goToOffset(int offset) {
 	if (offset < 0) {
 		return;
 	}
+
+	// A jump means whatever was being prefetched for the old position isn't needed anymore
+	_hexTable->_prefetcher.cancel();
 	
 	int size = 16;
 
@@ -504,7 +581,7 @@ void HexerFrame::goToOffset(int offset) {
 		break;
 	}
 
-	if ((offset + size) < _hexTable->_rom->_rom->Length()) {
+	if ((offset + size) < _hexTable->_rom->size()) {
 		// We unfortunately need both X and Y for the function
 		int scrollX;
 		int scrollY;
@@ -554,81 +631,116 @@ void HexerFrame::loadDefaultPalettes() {
 		return;
 	}
 
-	wxTextFile newPalette("palettes/greyscale.pal");
-	if (!newPalette.Open()) {
-		wxLogError(wxString("Could not load palette file"));
+	PaletteFile newPalette;
+	if (!newPalette.load("palettes/greyscale.pal")) {
+		wxLogError(newPalette._error);
 		return;
-
-	} else {
-		_hexTable->_indexedPalette.clear();
-		_hexTable->_gfxPalette.clear();
-		for (wxString line = newPalette.GetFirstLine(); !newPalette.Eof(); line = newPalette.GetNextLine()) {
-			wxStringTokenizer colourTokenizer(line, ",");
-
-			int red   = 0;
-			int green = 0;
-			int blue  = 0;
-			sscanf(colourTokenizer.GetNextToken().c_str(), "%x", &red);
-			sscanf(colourTokenizer.GetNextToken().c_str(), "%x", &green);
-			sscanf(colourTokenizer.GetNextToken().c_str(), "%x", &blue);
-			wxColour c(red, green, blue);
-
-			_hexTable->_gfxPalette.push_back(c);
-			_hexTable->_indexedPalette.push_back(c);
-		}
 	}
+
+	paletteColours(newPalette, _hexTable->_gfxPalette);
+	paletteColours(newPalette, _hexTable->_indexedPalette);
+	_hexTable->_gfxPaletteId++;
 	_hexGrid->ForceRefresh();
 }
 
-void HexerFrame::loadPalette(wxVector<wxColour> &targetPal) {
-	// This should check how many colours are in the file, and fill the remaining positions with black up to 8 * 8 colours for 8bpp
+// Fills the remaining positions with black, up to 8 * 8 colours for 8bpp
+void HexerFrame::paletteColours(PaletteFile &file, wxVector<wxColour> &targetPal) {
+	targetPal.clear();
+	for (int i = 0; i < file.count(); i++) {
+		targetPal.push_back(wxColour(file._rgb[(i * 3)], file._rgb[(i * 3) + 1], file._rgb[(i * 3) + 2]));
+	}
 
+	while (targetPal.size() < 64) {
+		targetPal.push_back(wxColour(0, 0, 0));
+	}
+}
 
-	// Prompt the user to open a rom file
-	wxFileDialog open(this, _("Open Palette File"), "", "", "", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+void HexerFrame::loadPalette(wxVector<wxColour> &targetPal) {
+	// Prompt the user to open a palette file
+	wxFileDialog open(this, _("Open Palette File"), "", "", PaletteFile::wildcard(), wxFD_OPEN | wxFD_FILE_MUST_EXIST);
 
 	// If they decide to cancel, just return
 	if (open.ShowModal() == wxID_CANCEL) {
 		return;
 	}
 
-	wxString path = open.GetPath();
+	PaletteFile newPalette;
+	if (!newPalette.load(open.GetPath())) {
+		wxLogError(newPalette._error);
+		return;
+	}
 
-	if (!wxFile::Exists(path)) {
-		wxLogError("Cannot open file");
+	paletteColours(newPalette, targetPal);
+	_hexTable->_gfxPaletteId++;
+	_hexGrid->ForceRefresh();
+}
+
+/* Writes a palette file into the rom at the start of the palette view selection (or the cursor),
+ * converted to the format of the palette view. Every colour goes in with one write
+ */
+void HexerFrame::onImportPalette(wxCommandEvent &event) {
+	int first = 0;
+	int last = 0;
+	if (!paletteSelection(first, last, false)) {
 		return;
 	}
 
-	wxTextFile newPalette(path);
-	if (!newPalette.Open()) {
-		wxLogError(wxString("Could not load palette file"));
+	wxFileDialog open(this, _("Import Palette File"), "", "", PaletteFile::wildcard(), wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+	if (open.ShowModal() == wxID_CANCEL) {
 		return;
+	}
 
-	} else {
-		_hexTable->_gfxPalette.clear();
-		for (wxString line = newPalette.GetFirstLine(); !newPalette.Eof(); line = newPalette.GetNextLine()) {
-			wxStringTokenizer colourTokenizer(line, ",");
-
-			int red   = 0;
-			int green = 0;
-			int blue  = 0;
-			sscanf(colourTokenizer.GetNextToken().c_str(), "%x", &red);
-			sscanf(colourTokenizer.GetNextToken().c_str(), "%x", &green);
-			sscanf(colourTokenizer.GetNextToken().c_str(), "%x", &blue);
-			wxColour c(red, green, blue);
-
-			_hexTable->_gfxPalette.push_back(c);
-		}
+	PaletteFile palette;
+	if (!palette.load(open.GetPath())) {
+		wxLogError(palette._error);
+		return;
+	}
 
-		if (_hexTable->_gfxPalette.size() < 64) {
-			for (int i = _hexTable->_gfxPalette.size(); i < 64; i++) {
-				_hexTable->_gfxPalette.push_back(wxColour(0,0,0));
-			}
-		}
+	ColourFormat format = _hexTable->paletteFormat();
+	int count = palette.count();
+	int length = count * format.byteSize();
+	if ((first + length) > _rom->size()) {
+		wxMessageBox(wxString::Format("The palette needs %d bytes, which would go past the end of the rom", length), "Can't import palette", wxICON_WARNING);
+		return;
 	}
+
+	wxVector<wxByte> raw(count * 3);
+	wxVector<wxByte> data(length, 0);
+	reduceColours(format, &palette._rgb[0], count, &raw[0]);
+	encodeColours(format, &raw[0], count, &data[0]);
+	_rom->setBytes(first, data);
 	_hexGrid->ForceRefresh();
 }
 
+// Saves the selected colours of the palette view (or the row the cursor is on) as a palette file
+void HexerFrame::onExportPalette(wxCommandEvent &event) {
+	int first = 0;
+	int last = 0;
+	if (!paletteSelection(first, last, true)) {
+		return;
+	}
+
+	wxFileDialog save(this, _("Export Palette File"), "", _rom->_name + ".pal", PaletteFile::wildcard(), wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+	if (save.ShowModal() == wxID_CANCEL) {
+		return;
+	}
+
+	ColourFormat format = _hexTable->paletteFormat();
+	int count = ((last - first) / format.byteSize()) + 1;
+	wxVector<wxByte> data(count * format.byteSize());
+	wxVector<wxByte> raw(count * 3);
+	_rom->readBytes(first, &data[0], data.size());
+
+	PaletteFile palette;
+	palette._rgb.resize(count * 3);
+	decodeColours(format, &data[0], count, &raw[0]);
+	expandColours(format, &raw[0], count, &palette._rgb[0]);
+
+	if (!palette.save(save.GetPath(), save.GetFilterIndex())) {
+		wxLogError(palette._error);
+	}
+}
+
 /*
  * Top Level Widget bound functions
  */
@@ -655,10 +767,18 @@ void HexerFrame::onViewTypeChoice(wxCommandEvent &event) {
 	refreshEditor();
 }
 
-/* This applies a preset to the settings
+/* A preset sets the gfx panel to the tile format of a console,
+ * which is then the same as if the user had picked it themselves
  */
 void HexerFrame::onPresetChoice(wxCommandEvent &event) {
-	debug(event.GetSelection());
+	const GfxPreset &preset = getGfxPreset(event.GetSelection());
+	if (preset._gfxType == -1) {
+		return;
+	}
+
+	_hexTable->_gfxType->SetSelection(preset._gfxType);
+	_hexTable->_gfxCtrl->SetValue(preset._bitDepth);
+	onGfxRefresh(event);
 }
 
 /* This checkbox just controls the gridlines of the grid
@@ -726,7 +846,7 @@ void HexerFrame::refreshEditor() {
 
 	case kViewTypeGfx:
 		// 64 pixels in an 8x8 square
-		_hexTable->_gfxByteSize = calcByteSize(_hexTable->_gfxCtrl->GetValue() * 64);
+		_hexTable->_gfxByteSize = calcGfxByteSize();
 		updateGridProps(fontSize, _hexTable->_cellSizeGfx, _hexTable->_gfxByteSize, "00");
 
 	default:
@@ -786,26 +906,18 @@ void HexerFrame::onHexViewDClick(wxGridEvent& event) {
 		int col = event.GetCol();
 		int bitDepth = _hexTable->_formatCtrl->GetValue();
 
-		// We want to grab the string of the current cell colour
-		wxStringTokenizer colourTokenizer(_hexGrid->GetCellValue(row, col), " ");
-
-		// And extract the colour data
-		wxString inputRed   = colourTokenizer.GetNextToken();
-		wxString inputGreen = colourTokenizer.GetNextToken();
-		wxString inputBlue  = colourTokenizer.GetNextToken();
-
+		// We want the colour data of the current cell, straight from the rom
 		int red;
 		int green;
 		int blue;
-
-		sscanf(inputRed.c_str(),   "%2x", &red);
-		sscanf(inputGreen.c_str(), "%2x", &green);
-		sscanf(inputBlue.c_str(),  "%2x", &blue);
+		if (!_hexTable->getPaletteColour(getOffset(row, col, _hexTable->_offset, _hexTable->_palByteSize), red, green, blue)) {
+			return;
+		}
 
 		// This colour data is then converted from whatever bitdepth it currently is, into 24bit for the colour picker
-		red   = trunc(float(red)   / float((1 << bitDepth) - 1) * float((1 << 8) - 1) + 0.5f);
-		green = trunc(float(green) / float((1 << bitDepth) - 1) * float((1 << 8) - 1) + 0.5f);
-		blue  = trunc(float(blue)  / float((1 << bitDepth) - 1) * float((1 << 8) - 1) + 0.5f);
+		red   = colourUp(bitDepth, red);
+		green = colourUp(bitDepth, green);
+		blue  = colourUp(bitDepth, blue);
 
 		// To start the dialog with a certain colour, we need to put it into a colourData object
 		wxColourData *cellClrData = new wxColourData();
@@ -825,9 +937,9 @@ void HexerFrame::onHexViewDClick(wxGridEvent& event) {
 		// If the current colours have changed at all from what the colour picker was given, we want to write the new ones into the cell
 		if ((red != newClr.Red()) || (green != newClr.Green()) || (blue != newClr.Blue())) {
 			// Convert it back down to whatever bitdepth it started as
-			int newR = trunc(float(newClr.Red())   / float((1 << 8) - 1) * float((1 << bitDepth) - 1) + 0.5f);
-			int newG = trunc(float(newClr.Green()) / float((1 << 8) - 1) * float((1 << bitDepth) - 1) + 0.5f);
-			int newB = trunc(float(newClr.Blue())  / float((1 << 8) - 1) * float((1 << bitDepth) - 1) + 0.5f);
+			int newR = colourDown(bitDepth, newClr.Red());
+			int newG = colourDown(bitDepth, newClr.Green());
+			int newB = colourDown(bitDepth, newClr.Blue());
 
 			// And finally create a string containing these new colours
 			wxString clrString = wxString::Format("%02X", newR) + "," + wxString::Format("%02X", newG) + "," + wxString::Format("%02X", newB);
@@ -836,6 +948,42 @@ void HexerFrame::onHexViewDClick(wxGridEvent& event) {
 	}
 }
 
+// The tooltip is only changed when the mouse moves onto a different doc, since setting it again would make it flicker
+void HexerFrame::onHexGridMotion(wxMouseEvent &event) {
+	event.Skip();
+
+	wxPoint pos = _hexGrid->CalcUnscrolledPosition(event.GetPosition());
+	int row = _hexGrid->YToRow(pos.y);
+	int col = _hexGrid->XToCol(pos.x);
+
+	Entry *doc = nullptr;
+	if ((row != wxNOT_FOUND) && (col > 0)) {
+		int byteWidth = 1;
+		if (_hexTable->_viewType == kViewTypeChars) {
+			byteWidth = _hexTable->_stringByteSize;
+
+		} else if (_hexTable->_viewType == kViewTypePal) {
+			byteWidth = _hexTable->_palByteSize;
+
+		} else if (_hexTable->_viewType == kViewTypeGfx) {
+			byteWidth = _hexTable->_gfxByteSize;
+		}
+		doc = _docsMap.at(getOffset(row, col, _hexTable->_offset, byteWidth));
+	}
+
+	if (doc == _hoverDoc) {
+		return;
+	}
+	_hoverDoc = doc;
+
+	if (doc == nullptr) {
+		_hexGrid->GetGridWindow()->UnsetToolTip();
+
+	} else {
+		_hexGrid->GetGridWindow()->SetToolTip(doc->_name + wxString::Format("\n$%X (%d bytes)", doc->_offset, doc->_length));
+	}
+}
+
 /* String panel functions
  */
 void HexerFrame::onChangeStringTable(wxCommandEvent &event) {
@@ -854,33 +1002,45 @@ void HexerFrame::onChangeStringTable(wxCommandEvent &event) {
 		return;
 	}
 
-	wxTextFile stringTable(path);
-	if (!stringTable.Open()) {
+	if (!_hexTable->_stringTable.load(path)) {
 		wxLogError(wxString("Could not load string table file"));
 		return;
+	}
 
-	} else {
-		_hexTable->_stringTable.clear();
-		int byteSize = 1;
-		for (wxString line = stringTable.GetFirstLine(); !stringTable.Eof(); line = stringTable.GetNextLine()) {
-			wxStringTokenizer lineTokenizer(line, "=");
-			
-			wxString key = lineTokenizer.GetNextToken();
-			byteSize = key.size() / 2;
-			wxString value = lineTokenizer.GetNextToken();
-			if (value.Cmp("EQU") == 0) {
-				value = "=";
-			}
-
-			_hexTable->_stringTable[key] = value;
+	// Anything decoded with the old table is no longer valid
+	_hexTable->clearTextBlocks();
 
-		}
+	// A table can mix key lengths, so the cell width goes with whichever length most of the table uses
+	int byteSize = _hexTable->_stringTable.commonKeyLength();
+	if (byteSize > 4) {
+		byteSize = 4;
+	}
+
+	// Stream mode always uses single byte cells, so it only needs the control updated for later
+	if (!_hexTable->_stringStream) {
 		_hexTable->_stringByteSize = byteSize;
-		_hexTable->_stringCtrl->SetValue(byteSize);
 	}
+	_hexTable->_stringCtrl->SetValue(byteSize);
 	refreshEditor();
 }
 
+void HexerFrame::onStringStreamCheck(wxCommandEvent &event) {
+	_hexTable->_stringStream = event.IsChecked();
+	_hexTable->clearTextBlocks();
+
+	// In stream mode the entries decide their own size, so every cell is one byte and the byte size control doesn't apply
+	if (_hexTable->_stringStream) {
+		_hexTable->_stringByteSize = 1;
+	} else {
+		_hexTable->_stringByteSize = _hexTable->_stringCtrl->GetValue();
+	}
+	_hexTable->_stringCtrl->Enable(!_hexTable->_stringStream);
+
+	if (_hexTable->_viewType == kViewTypeChars) {
+		refreshEditor();
+	}
+}
+
 void HexerFrame::onStringByteSizeChanged(wxSpinEvent &event) {
 	_hexTable->_stringByteSize = event.GetPosition();
 	if (_hexTable->_viewType == kViewTypeChars) {
@@ -888,6 +1048,126 @@ void HexerFrame::onStringByteSizeChanged(wxSpinEvent &event) {
 	}
 }
 
+void HexerFrame::onDumpScript(wxCommandEvent &event) {
+	ScriptLayout layout;
+	if (!scriptLayoutDialog(layout)) {
+		return;
+	}
+
+	wxFileDialog save(this, _("Save Script File"), "", _rom->_name + ".txt", "", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+	if (save.ShowModal() == wxID_CANCEL) {
+		return;
+	}
+
+	wxBusyCursor busy;
+	Script script(_rom, &_hexTable->_stringTable);
+	int count = script.dump(layout, save.GetPath());
+	if (count == -1) {
+		wxLogError(script._error);
+		return;
+	}
+	debug(wxString::Format("dumped %d strings", count));
+}
+
+void HexerFrame::onInsertScript(wxCommandEvent &event) {
+	wxFileDialog open(this, _("Open Script File"), "", "", "", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+	if (open.ShowModal() == wxID_CANCEL) {
+		return;
+	}
+
+	wxBusyCursor busy;
+	Script script(_rom, &_hexTable->_stringTable, _freeSpace);
+	int count = script.insert(open.GetPath());
+	if (count == -1) {
+		wxLogError(script._error);
+		return;
+	}
+	debug(wxString::Format("inserted %d strings", count));
+
+	// The whole script went in at once, so the editor only needs to be refreshed once
+	_hexGrid->ForceRefresh();
+}
+
+void HexerFrame::onFindFreeSpace(wxCommandEvent &event) {
+	// The last filler and minimum length are kept, since changing either means scanning the whole rom again
+	int filler = 0xFF;
+	int minLength = 16;
+	int length = 16;
+	int bankSize = 0;
+	if (_freeSpace != nullptr) {
+		filler = _freeSpace->filler();
+		minLength = _freeSpace->minLength();
+	}
+
+	if (!freeSpaceDialog(filler, minLength, length, bankSize)) {
+		return;
+	}
+
+	if ((_freeSpace == nullptr) || (_freeSpace->filler() != filler) || (_freeSpace->minLength() != minLength)) {
+		wxBusyCursor busy;
+		delete _freeSpace;
+		_freeSpace = new FreeSpaceIndex(_rom, filler, minLength);
+	}
+
+	int offset = 0;
+	if (!_freeSpace->find(length, bankSize, offset)) {
+		wxMessageBox(wxString::Format("The largest run of %02X is %d bytes", filler, _freeSpace->largest()), "Not enough free space", wxICON_WARNING);
+		return;
+	}
+
+	goToOffset(offset);
+	wxMessageBox(wxString::Format("%d bytes free at %X\n%d runs of %02X, %ld bytes in total", length, offset, _freeSpace->runCount(), filler, _freeSpace->total()), "Free Space", wxICON_INFORMATION);
+}
+
+/* Preview functions
+ */
+// An IPS patch is only ever previewed, so it can be looked at in every view before any of it goes into the rom
+void HexerFrame::onPreviewIPS(wxCommandEvent &event) {
+	wxFileDialog open(this, _("Preview IPS Patch"), "", "", "IPS patch (*.ips)|*.ips", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+	if (open.ShowModal() == wxID_CANCEL) {
+		return;
+	}
+
+	RomOverlay *preview = new RomOverlay();
+	if (!preview->loadIPS(open.GetPath(), _rom->size())) {
+		wxLogError(preview->_error);
+		delete preview;
+		return;
+	}
+
+	if (preview->clipped() > 0) {
+		wxMessageBox(wxString::Format("%d bytes of the patch are past the end of the rom, and are not in the preview", preview->clipped()), "Patch is bigger than the rom", wxICON_WARNING);
+	}
+	showPreview(preview);
+}
+
+void HexerFrame::onCommitPreview(wxCommandEvent &event) {
+	if (_rom->preview() != nullptr) {
+		_rom->commitPreview();
+		_hexGrid->ForceRefresh();
+		refreshTileSheet();
+	}
+}
+
+void HexerFrame::onDiscardPreview(wxCommandEvent &event) {
+	showPreview(nullptr);
+}
+
+// Replaces the preview (or removes it), and goes to the first byte of the new one
+void HexerFrame::showPreview(RomOverlay *preview) {
+	int first = -1;
+	if ((preview != nullptr) && !preview->empty()) {
+		first = preview->runs().begin()->first;
+	}
+
+	_rom->setPreview(preview);
+	if (first >= 0) {
+		goToOffset(first);
+	}
+	_hexGrid->ForceRefresh();
+	refreshTileSheet();
+}
+
 /* Palette panel functions
  */
 void HexerFrame::onColourPickerChanged(wxColourPickerEvent &event) {
@@ -903,6 +1183,123 @@ void HexerFrame::onFormatChanged(wxSpinEvent &event) {
 	}
 }
 
+void HexerFrame::onColourOrderChanged(wxCommandEvent &event) {
+	_hexGrid->ForceRefresh();
+}
+
+/* Gives the offsets of the first and last colour selected in the palette view.
+ * A selection of blocks is taken as one run of colours, from the lowest offset to the highest.
+ * Without a selection it is the colour under the cursor, or the whole row it is on if wholeRow is set
+ */
+bool HexerFrame::paletteSelection(int &first, int &last, bool wholeRow) {
+	if (_hexTable->_viewType != kViewTypePal) {
+		return false;
+	}
+
+	first = -1;
+	last = -1;
+	for (const wxGridBlockCoords &block : _hexGrid->GetSelectedBlocks()) {
+		int start = getOffset(block.GetTopRow(), wxMax(1, block.GetLeftCol()), _hexTable->_offset, _hexTable->_palByteSize);
+		int end = getOffset(block.GetBottomRow(), wxMax(1, block.GetRightCol()), _hexTable->_offset, _hexTable->_palByteSize);
+		if ((first == -1) || (start < first)) {
+			first = start;
+		}
+		if (end > last) {
+			last = end;
+		}
+	}
+
+	if (first == -1) {
+		int row = _hexGrid->GetGridCursorRow();
+		int col = wxMax(1, _hexGrid->GetGridCursorCol());
+		first = getOffset(row, wholeRow ? 1 : col, _hexTable->_offset, _hexTable->_palByteSize);
+		last = getOffset(row, wholeRow ? (_hexGrid->GetNumberCols() - 1) : col, _hexTable->_offset, _hexTable->_palByteSize);
+	}
+
+	// The last colour might only be partly in the rom, in which case we leave it out
+	while ((last >= first) && ((last + _hexTable->_palByteSize) > _rom->size())) {
+		last -= _hexTable->_palByteSize;
+	}
+	return (first >= 0) && (last >= first);
+}
+
+/* Tints, fades or re-encodes every colour from the first selected cell to the last.
+ * All of the colours are converted together, and then written back as a single write
+ */
+void HexerFrame::onAdjustPalette(wxCommandEvent &event) {
+	int first = 0;
+	int last = 0;
+	if (!paletteSelection(first, last, false)) {
+		return;
+	}
+
+	ColourFormat format = _hexTable->paletteFormat();
+
+	int operation = kPaletteTint;
+	wxColour colour = *wxBLACK;
+	int amount = 50;
+	int bitDepth = format._bitDepth;
+	int order = format._order;
+	if (!paletteAdjustDialog(operation, colour, amount, bitDepth, order)) {
+		return;
+	}
+
+	int count = ((last - first) / format.byteSize()) + 1;
+	wxVector<wxByte> data(count * format.byteSize());
+	wxVector<wxByte> raw(count * 3);
+	wxVector<wxByte> rgb(count * 3);
+	_rom->readBytes(first, &data[0], data.size());
+	decodeColours(format, &data[0], count, &raw[0]);
+	expandColours(format, &raw[0], count, &rgb[0]);
+
+	wxByte target[3] = {colour.Red(), colour.Green(), colour.Blue()};
+	ColourFormat newFormat = format;
+	switch (operation) {
+	case kPaletteTint:
+		blendColours(&rgb[0], count, target, amount, amount);
+		break;
+
+	case kPaletteFade:
+		blendColours(&rgb[0], count, target, 0, amount);
+		break;
+
+	case kPaletteReencode:
+		newFormat = ColourFormat(bitDepth, order);
+		break;
+
+	default:
+		break;
+	}
+
+	// A bigger format takes up more bytes than were selected, so we make sure that is what the user wants
+	int length = count * newFormat.byteSize();
+	if ((first + length) > _rom->size()) {
+		wxMessageBox("The colours would not fit before the end of the rom", "Can't adjust palette", wxICON_WARNING);
+		return;
+	}
+	if (length > (int) data.size()) {
+		int answer = wxMessageBox(wxString::Format("The new format needs %d bytes instead of %d, which will overwrite the bytes after the selection. Continue?", length, (int) data.size()), "Palette will grow", wxYES_NO | wxICON_WARNING);
+		if (answer != wxYES) {
+			return;
+		}
+	}
+
+	reduceColours(newFormat, &rgb[0], count, &raw[0]);
+	data.assign(length, 0);
+	encodeColours(newFormat, &raw[0], count, &data[0]);
+	_rom->setBytes(first, data);
+
+	// After re-encoding, the view shows the new format
+	if (!(newFormat == format)) {
+		_hexTable->_formatCtrl->SetValue(newFormat._bitDepth);
+		_hexTable->_clrOrderCtrl->SetSelection(newFormat._order);
+		_hexTable->_palByteSize = newFormat.byteSize();
+		refreshEditor();
+	} else {
+		_hexGrid->ForceRefresh();
+	}
+}
+
 void HexerFrame::onLoadIndexedPalette(wxCommandEvent &event) {
 	loadPalette(_hexTable->_indexedPalette);
 }
@@ -912,22 +1309,58 @@ void HexerFrame::onColourSearch(wxCommandEvent &event) {}
 /* Gfx panel functions
  */
 void HexerFrame::onGfxBitdepthChanged(wxSpinEvent &event) {
-	_hexTable->_gfxByteSize = calcByteSize(_hexTable->_gfxCtrl->GetValue() * 64);
+	_hexTable->_gfxByteSize = calcGfxByteSize();
 	if (_hexTable->_viewType == kViewTypeGfx) {
 		refreshEditor();
 	}
+	refreshTileSheet();
+}
+
+// RGB gfx take up whole bytes per pixel, everything else is the bpp for each of the 64 pixels
+int HexerFrame::calcGfxByteSize() {
+	if (_hexTable->_gfxType->GetSelection() == kGfxTypeRGB) {
+		return gfxTileBytes(kGfxTypeRGB, _hexTable->gfxDepth());
+	}
+	return calcByteSize(_hexTable->_gfxCtrl->GetValue() * 64);
 }
 
 void HexerFrame::onChangeGfxPalette(wxCommandEvent &event) {
 	loadPalette(_hexTable->_gfxPalette);
+	refreshTileSheet();
 }
 
 void HexerFrame::onGfxPalChanged(wxSpinEvent &event) {
 	_hexGrid->ForceRefresh();
+	refreshTileSheet();
 }
 
 void HexerFrame::onGfxRefresh(wxCommandEvent &event) {
-	_hexGrid->ForceRefresh();
+	// Switching to or from RGB (or between RGB formats), or a preset with a new depth, changes how big a tile is
+	int byteSize = calcGfxByteSize();
+	if (byteSize != _hexTable->_gfxByteSize) {
+		_hexTable->_gfxByteSize = byteSize;
+		if (_hexTable->_viewType == kViewTypeGfx) {
+			refreshEditor();
+		}
+	} else {
+		_hexGrid->ForceRefresh();
+	}
+	refreshTileSheet();
+}
+
+void HexerFrame::onShowTileSheet(wxCommandEvent &event) {
+	if (_tileSheet == nullptr) {
+		_tileSheet = new TileSheetFrame(this, _hexTable);
+	}
+	_tileSheet->Show();
+	_tileSheet->Raise();
+}
+
+// The sheet uses the settings of the gfx panel, so it has to be drawn again whenever they change
+void HexerFrame::refreshTileSheet() {
+	if (_tileSheet != nullptr) {
+		_tileSheet->refreshSheet();
+	}
 }
 
 /* Controls panel functions
@@ -939,7 +1372,7 @@ void HexerFrame::onArrowUp(wxCommandEvent &event) {
 }
 
 void HexerFrame::onArrowDown(wxCommandEvent &event) {
-	if ((_hexTable->_offset + 16) < _hexTable->_rom->_rom->Length()) {
+	if ((_hexTable->_offset + 16) < _hexTable->_rom->size()) {
 		goToOffset(_hexTable->_offset + 16);
 	}
 }
@@ -951,7 +1384,7 @@ void HexerFrame::onArrowLeft(wxCommandEvent &event) {
 }
 
 void HexerFrame::onArrowRight(wxCommandEvent &event) {
-	if ((_hexTable->_offset + 1) < _hexTable->_rom->_rom->Length()) {
+	if ((_hexTable->_offset + 1) < _hexTable->_rom->size()) {
 		goToOffset(_hexTable->_offset + 1);
 	}
 }
@@ -149,9 +149,16 @@ void HexerFrame::populateMenuBar(wxMenuBar *menuBar) {
 	 * -Preferences
 	 * -Undo
 	 * -Add
+	 * -Expand Rom
+	 * -Insert Bytes
+	 * -Delete Bytes
 	 */
 	wxMenu *menuEdit = new wxMenu;
 	menuEdit->Append(ID_MenuUndo, "&Undo\tCtrl-Z", "Undo the last action");
+	menuEdit->AppendSeparator();
+	menuEdit->Append(ID_MenuExpand, 	 "&Expand Rom...", "Pad the end of the rom to a larger size");
+	menuEdit->Append(ID_MenuInsertBytes, "&Insert Bytes...", "Insert bytes into the rom, moving everything after them");
+	menuEdit->Append(ID_MenuDeleteBytes, "&Delete Bytes...", "Delete bytes from the rom, moving everything after them");
 	/* -------------- */
 
 	/* ---- Help ----
@@ -186,11 +193,18 @@ void HexerFrame::populateMenuBar(wxMenuBar *menuBar) {
 	Bind(wxEVT_MENU, &HexerFrame::onLoadTweaks,  this, ID_MenuLoadTweaks);
 	Bind(wxEVT_MENU, &HexerFrame::onLoadDocs,    this, ID_MenuLoadDocs);
 	Bind(wxEVT_MENU, &HexerFrame::onRefresh,     this, ID_MenuRefresh);
+	Bind(wxEVT_MENU, &HexerFrame::onExpandRom,   this, ID_MenuExpand);
+	Bind(wxEVT_MENU, &HexerFrame::onInsertBytes, this, ID_MenuInsertBytes);
+	Bind(wxEVT_MENU, &HexerFrame::onDeleteBytes, this, ID_MenuDeleteBytes);
 	Bind(wxEVT_MENU, &HexerFrame::onContact,	 this, ID_MenuContact);
 	Bind(wxEVT_MENU, &HexerFrame::onCredits, 	 this, ID_MenuCredits);
 	Bind(wxEVT_MENU, &HexerFrame::onAbout,   	 this, wxID_ABOUT);
 	Bind(wxEVT_MENU, &HexerFrame::onExit,    	 this, wxID_EXIT);
 	Bind(wxEVT_MENU, &HexerFrame::onPreferences, this, wxID_PREFERENCES);
+
+	// Patch states are worked out a few at a time whenever there is nothing else to do
+	Bind(wxEVT_IDLE, &HexerFrame::onIdle,		 this);
+	Bind(wxEVT_CLOSE_WINDOW, &HexerFrame::onClose, this);
 }
 
 void HexerFrame::onLoadTweaks(wxCommandEvent& event) {}
@@ -213,6 +227,15 @@ void HexerFrame::onAbout(wxCommandEvent& event) {
 	wxMessageBox("The Hackers Notebook is designed to be a\n'Hackers' Digital Assistant'", "About Hexer", wxOK | wxICON_INFORMATION);
 }
 
+void HexerFrame::onClose(wxCloseEvent& event) {
+	// A notebook that is still being written in the background has to be finished first
+	delete _editLog;
+	_editLog = nullptr;
+	delete _docsLog;
+	_docsLog = nullptr;
+	event.Skip();
+}
+
 void HexerFrame::onExit(wxCommandEvent& event) {
 	// This true ensures that this close button has vito over all windows
 	Close(true);
@@ -246,7 +269,8 @@ void HexerFrame::populateToolBar(wxToolBar *toolBar) {
 	_toggleViews[2] = toggleHex;
 
 	// We also have a search bar, and buttons for undo/save/open rom
-	wxSearchCtrl *searchBar = new wxSearchCtrl(toolBar, ID_ToolSearch, wxEmptyString, wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, "Search");
+	_searchBar = new wxSearchCtrl(toolBar, ID_ToolSearch, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER, wxDefaultValidator, "Search");
+	_searchBar->SetDescriptiveText("Search patches and docs");
 
 	wxButton *buttonUndo = new wxButton(toolBar, ID_ToolUndo, "Undo", wxDefaultPosition, wxDefaultSize, wxBU_NOTEXT | wxBORDER_NONE | wxBU_EXACTFIT, wxDefaultValidator, "Undo");
 	buttonUndo->SetBitmap(wxArtProvider::GetIcon(wxART_UNDO, wxART_FRAME_ICON));
@@ -264,7 +288,7 @@ void HexerFrame::populateToolBar(wxToolBar *toolBar) {
 	//toolBar->AddControl(separator2);
 	toolBar->AddControl(toggleHex);
 	toolBar->AddStretchableSpace();
-	toolBar->AddControl(searchBar);
+	toolBar->AddControl(_searchBar);
 	//toolBar->AddControl(buttonUndo);
 	toolBar->AddControl(buttonSave);
 	toolBar->AddControl(buttonOpen);
@@ -289,6 +313,8 @@ void HexerFrame::populateToolBar(wxToolBar *toolBar) {
 	Bind(wxEVT_BUTTON, 		 &HexerFrame::onSave,	this, ID_ToolSave);
 	Bind(wxEVT_BUTTON, 		 &HexerFrame::onOpen,	this, ID_ToolOpen);
 	Bind(wxEVT_SEARCH,		 &HexerFrame::onSearch, this, ID_ToolSearch);
+	Bind(wxEVT_TEXT,		 &HexerFrame::onSearchText, this, ID_ToolSearch);
+	Bind(wxEVT_MENU,		 &HexerFrame::onSearchResult, this, ID_SearchResult, ID_SearchResultEnd);
 }
 
 void HexerFrame::onToggle(wxCommandEvent &event) {
@@ -322,22 +348,105 @@ void HexerFrame::onToggle(wxCommandEvent &event) {
 	_mainSizer->Layout();
 }
 
-void HexerFrame::onSearch(wxCommandEvent &event) {
-	wxString s = event.GetString();
-	int cat = -1;
-	int entry = -1;
-	for (int i = 0; i < _editPatches.size(); i++) {
-		for (int j = 0; j < _editPatches[i].size(); j++) {
-			if (_editPatches[i][j]._name.CmpNoCase(s) == 0) {
-				debug("yes?");
-				cat = i;
-				entry = j;
-				_editData->_noteBook->SetSelection(cat);
-				return;
+void HexerFrame::showView(int view) {
+	for (int i = 0; i < 3; i++) {
+		if (i == view) {
+			_views[i]->Show(true);
+			_toggleViews[i]->SetValue(true);
+			_view = i;
+		} else {
+			_views[i]->Show(false);
+			_toggleViews[i]->SetValue(false);
+		}
+		_prevRow = -1;
+	}
+	_mainSizer->Layout();
+}
+
+// The descriptions in the patch library all have to be read for the index, so it isn't made until it is needed
+void HexerFrame::buildSearch() {
+	if (!_search.built(kSearchPatches) && (_editData != nullptr)) {
+		readDescriptions();
+		_search.build(kSearchPatches, _editData->_catNames, _editPatches);
+	}
+
+	if (!_search.built(kSearchDocs) && (_docsData != nullptr)) {
+		_search.build(kSearchDocs, _docsData->_catNames, _docsEntries);
+	}
+}
+
+/* Every change to the search bar searches again, and puts the results in the menu of the search
+ * bar. Nothing moves while typing, enter goes to the best result (and then the next one each time)
+ */
+void HexerFrame::onSearchText(wxCommandEvent &event) {
+	_searchResults.clear();
+	_searchAt = -1;
+
+	if (event.GetString() != "") {
+		buildSearch();
+		_search.find(event.GetString(), kSearchResults, _searchResults);
+	}
+
+	wxMenu *menu = nullptr;
+	if (!_searchResults.empty()) {
+		menu = new wxMenu();
+		for (int i = 0; i < _searchResults.size(); i++) {
+			SearchResult &r = _searchResults[i];
+			if (r._book == kSearchPatches) {
+				menu->Append(ID_SearchResult + i, _editPatches[r._cat][r._index]._name + " (" + _editData->_catNames[r._cat] + ")");
+			} else {
+				menu->Append(ID_SearchResult + i, _docsEntries[r._cat][r._index]._name + " (" + _docsData->_catNames[r._cat] + ")");
 			}
 		}
 	}
-	debug("couldn't find the search term");
+
+	// The search bar deletes the menu it had
+	_searchBar->SetMenu(menu);
+}
+
+void HexerFrame::onSearch(wxCommandEvent &event) {
+	if (!_searchResults.empty()) {
+		_searchAt = (_searchAt + 1) % _searchResults.size();
+		showSearchResult(_searchAt);
+	}
+}
+
+void HexerFrame::onSearchResult(wxCommandEvent &event) {
+	_searchAt = event.GetId() - ID_SearchResult;
+	if ((_searchAt >= 0) && (_searchAt < _searchResults.size())) {
+		showSearchResult(_searchAt);
+	}
+}
+
+void HexerFrame::showSearchResult(int result) {
+	SearchResult &r = _searchResults[result];
+
+	ViewData *data = (r._book == kSearchPatches) ? _editData : _docsData;
+	if (r._cat >= data->_grids.size()) {
+		return;
+	}
+
+	showView((r._book == kSearchPatches) ? kViewEdit : kViewDocs);
+
+	// Changing the page this way doesn't send the page change event, so the name is set here
+	data->_noteBook->ChangeSelection(r._cat);
+	data->_catName->SetLabel(data->_catNames[r._cat]);
+
+	// The bitflags page is drawn into the grid instead of read from a table, so there's no row to go to
+	if ((data == _docsData) && (data->_catNames[r._cat] == "Bitflags")) {
+		return;
+	}
+
+	// The docs have a header row, and might be sorted or filtered, so the table says which row the entry is on
+	if (data == _docsData) {
+		useDocsView(r._cat);
+	}
+	wxGrid *grid = data->_grids[r._cat];
+	int row = ((EntryTable *) grid->GetTable())->rowOf(r._index);
+	if (row != -1) {
+		grid->SelectRow(row);
+		grid->MakeCellVisible(row, 0);
+	}
 }
 
 void HexerFrame::onUndo(wxCommandEvent &event) {
@@ -364,93 +473,20 @@ ViewData *HexerFrame::getViewData() {
 	}
 }
 
+/* Every change is already in the log by the time these are called, so the whole
+ * file is only written again (in the background) once the log is long enough
+ */
 void HexerFrame::saveLocalEdit() {
-	wxTextFile _editFile(wxString("local/editLocal"));
-	if (!_editFile.Open()) {
-		wxLogError(wxString("Could not load local edit file"));
-		debug("couldn't load the local edit file");
-		return;
+	// The library stays open, since what is mapped (or was read) from it doesn't change when the file is replaced
+	if (_editLog->needsCompacting()) {
+		_editLog->compact();
 	}
-
-	_editFile.Clear();
-	wxString catLine = "";
-	for (int i = 0; i < _editData->_catNames.size(); i++) {
-		catLine << _editData->_catNames[i];
-		if (i != _editData->_catNames.size() - 1) {
-			catLine << "|";
-		}
-	}	
-	_editFile.AddLine(catLine);
-	for (int i = 0; i < _editPatches.size(); i++) {
-		for (int j = 0; j < _editPatches[i].size(); j++) {
-			wxString editLine = "";
-			editLine << i << "|";
-			editLine << _editPatches[i][j]._name << "|";
-
-			wxString sOffsets = "";
-			wxString sOldBytes = "";
-			wxString sNewBytes = "";
-			debug(_editPatches[i][j]._bytes.size());
-			for (int k = 0; k < _editPatches[i][j]._bytes.size(); k++) {
-				debug("for every offset");
-				// For every offset, we add an offset to the offset string
-				sOffsets << wxString::Format("%X", _editPatches[i][j]._bytes[k]._offset);
-				for (int l = 0; l < _editPatches[i][j]._bytes[k]._oldBytes.size(); l++) {
-					debug("for every byte string");
-					// And for every byte string, we add the byte string to old/newbytes
-					sOldBytes << wxString::Format("%02X", _editPatches[i][j]._bytes[k]._oldBytes[l]);
-					sNewBytes << wxString::Format("%02X", _editPatches[i][j]._bytes[k]._newBytes[l]);
-				}
-				if (k != _editPatches[i][j]._bytes.size() - 1) {
-					// Separated by commas
-					sOffsets << ",";
-					sOldBytes << ",";
-					sNewBytes << ",";
-				}
-			}
-			editLine << sOffsets << "|";
-			editLine << sNewBytes << "|";
-			editLine << sOldBytes << "|";
-			editLine << _editPatches[i][j]._desc;
-
-			_editFile.AddLine(editLine);
-		}
-	}
-	_editFile.Write();
 }
 
 void HexerFrame::saveLocalDocs() {
-	wxTextFile _docsFile(wxString("local/docsLocal"));
-	if (!_docsFile.Open()) {
-		wxLogError(wxString("Could not load local docs file"));
-		debug("couldn't load the local docs file");
-		return;
-	}
-
-	// First we clear and rewrite the docs file
-	_docsFile.Clear();
-	wxString catLine = "";
-	for (int i = 0; i < _docsData->_catNames.size(); i++) {
-		catLine << _docsData->_catNames[i];
-		if (i != _docsData->_catNames.size() - 1) {
-			catLine << "|";
-		}
-	}
-	_docsFile.AddLine(catLine);
-	for (int i = 0; i < _docsEntries.size(); i++) {
-		for (int j = 0; j < _docsEntries[i].size(); j++) {
-			wxString docsLine = "";
-			docsLine << i << "|";
-			docsLine << _docsEntries[i][j]._name << "|";
-			docsLine << _docsEntries[i][j]._addr << "|";
-			docsLine << _docsEntries[i][j]._size << "|";
-			docsLine << _docsEntries[i][j]._type << "|";
-			docsLine << _docsEntries[i][j]._desc;
-			_docsFile.AddLine(docsLine);
-			debug(docsLine);
-		}
+	if (_docsLog->needsCompacting()) {
+		_docsLog->compact();
 	}
-	_docsFile.Write();
 }
 
 int HexerFrame::YToRowGood(wxGrid *grid, int y) {
@@ -504,6 +540,9 @@ void HexerFrame::onNotebookChange(wxBookCtrlEvent &event) {
 		_editData->_catName->SetLabel(_editData->_catNames[event.GetSelection()]);
 	} else {
 		_docsData->_catName->SetLabel(_docsData->_catNames[event.GetSelection()]);
+
+		// The page might not have been sorted and filtered since the view last changed
+		useDocsView(event.GetSelection());
 	}
 	SendSizeEvent();
 }
@@ -513,7 +552,16 @@ void HexerFrame::onTextEnter(wxCommandEvent& event) {
 	if (data->_catName->GetValue() != "Bitflags") {
 		data->_catNames[data->_noteBook->GetSelection()] = data->_catName->GetValue();
 		data->_noteBook->SetPageText(data->_noteBook->GetSelection(), data->_catName->GetValue());
-		saveLocalDocs();
+		if (data == _editData) {
+			_editLog->renameCategory(data->_noteBook->GetSelection(), data->_catName->GetValue());
+			_search.renameCategory(kSearchPatches, data->_noteBook->GetSelection(), data->_catName->GetValue());
+			saveLocalEdit();
+
+		} else {
+			_docsLog->renameCategory(data->_noteBook->GetSelection(), data->_catName->GetValue());
+			_search.renameCategory(kSearchDocs, data->_noteBook->GetSelection(), data->_catName->GetValue());
+			saveLocalDocs();
+		}
 	}
 }
 
@@ -635,8 +683,22 @@ void HexerFrame::createPage(ViewData *data, wxString pageName, int row, int col)
 	// And lastly, we want the entries to be drawn directly on the panel, so we use a transparent background
 	grid->SetDefaultCellBackgroundColour(wxColour(0,0,0,0));
 
-	// Now we can actually create the grid
-	grid->CreateGrid(row, col, wxGrid::wxGridSelectionModes::wxGridSelectNone);
+	// Now we can actually create the grid. Patches and documents come straight from the entries through a table,
+	// only the bitflag diagrams are made of cells that the grid holds itself
+	int cat = data->_grids.size() - 1;
+	if (data == _editData) {
+		// Rows of patches can be selected (with ctrl or shift), to be applied or reverted together
+		grid->SetTable(new PatchTable(&_editPatches, cat), true, wxGrid::wxGridSelectionModes::wxGridSelectRows);
+
+	} else if (pageName != "Bitflags") {
+		grid->SetTable(new DocsTable(&_docsEntries, cat), true, wxGrid::wxGridSelectionModes::wxGridSelectNone);
+		if (_docsOrder.active()) {
+			((EntryTable *) grid->GetTable())->setView(_docsOrder);
+		}
+
+	} else {
+		grid->CreateGrid(row, col, wxGrid::wxGridSelectionModes::wxGridSelectNone);
+	}
 
 	/* MoreInfo: Light grey question mark
 	 * Edit: Image
@@ -727,6 +789,24 @@ void HexerFrame::onOpen(wxCommandEvent &event) {
 		return;
 	}
 
+	// Any free space index belongs to the old rom
+	if (_freeSpace != nullptr) {
+		delete _freeSpace;
+		_freeSpace = nullptr;
+	}
+
+	// And so does the tile sheet
+	if (_tileSheet != nullptr) {
+		_tileSheet->Destroy();
+		_tileSheet = nullptr;
+	}
+
+	// As well as the patch states
+	if (_patchStates != nullptr) {
+		delete _patchStates;
+		_patchStates = nullptr;
+	}
+
 	// Get the rom loaded in
 	_rom = new Rom(path);
 
@@ -757,6 +837,21 @@ void HexerFrame::onOpen(wxCommandEvent &event) {
 	_mainSizer->Layout();
 }
 
+void HexerFrame::onIdle(wxIdleEvent &event) {
+	if ((_patchStates == nullptr) || !_patchStates->pending()) {
+		return;
+	}
+
+	// The grid reads the states straight from the patches, so it only has to be redrawn if any of them changed
+	if (_patchStates->evaluate(kPatchBudget) > 0) {
+		_editData->_grids[_editData->_noteBook->GetSelection()]->ForceRefresh();
+	}
+
+	if (_patchStates->pending()) {
+		event.RequestMore();
+	}
+}
+
 void HexerFrame::onSave(wxCommandEvent& event) {
 	if (_rom != nullptr) {
 		_rom->saveToRom();
@@ -764,6 +859,109 @@ void HexerFrame::onSave(wxCommandEvent& event) {
 		debug("pressed save button but no rom was loaded");
 	}
 }
+
+void HexerFrame::onExpandRom(wxCommandEvent& event) {
+	if (_rom == nullptr) {
+		debug("tried to expand but no rom was loaded");
+		return;
+	}
+
+	// By default the rom goes up to the next power of two
+	long long next = 1;
+	while (next <= _rom->size()) {
+		next <<= 1;
+	}
+
+	wxString sizeString = wxGetTextFromUser("New size of the rom (hex)", "Expand Rom", wxString::Format("%llX", next), this);
+	if (sizeString.IsEmpty()) {
+		return;
+	}
+
+	wxString fillerString = wxGetTextFromUser("Byte to fill the new space with (hex)", "Expand Rom", "FF", this);
+	if (fillerString.IsEmpty()) {
+		return;
+	}
+
+	int size = 0;
+	int filler = 0;
+	sscanf(sizeString.c_str(), "%x", &size);
+	sscanf(fillerString.c_str(), "%x", &filler);
+
+	if (size == next) {
+		_rom->expandToPowerOfTwo(filler);
+
+	} else if (!_rom->expand(size, filler)) {
+		wxMessageBox("The new size has to be larger than the rom is now", "Could not expand rom", wxICON_WARNING);
+	}
+}
+
+void HexerFrame::onInsertBytes(wxCommandEvent& event) {
+	if (_rom == nullptr) {
+		debug("tried to insert but no rom was loaded");
+		return;
+	}
+
+	wxString offsetString = wxGetTextFromUser("Offset to insert at (hex)", "Insert Bytes", wxString::Format("%X", _hexTable->_offset), this);
+	if (offsetString.IsEmpty()) {
+		return;
+	}
+
+	wxString bytesString = wxGetTextFromUser("Bytes to insert (hex)", "Insert Bytes", "", this);
+	bytesString.Replace(" ", "");
+	if (bytesString.IsEmpty()) {
+		return;
+	}
+
+	int offset = 0;
+	sscanf(offsetString.c_str(), "%x", &offset);
+
+	// The bytes are read two characters at a time, just like the patch bytes, so half of a byte can't be inserted
+	if ((bytesString.Len() % 2) != 0) {
+		wxMessageBox("Please input whole bytes, as two hexadecimal digits each", "Bytes must be whole", wxICON_WARNING);
+		return;
+	}
+
+	wxVector<wxByte> bytes;
+	for (int i = 0; (i + 1) < bytesString.Len(); i += 2) {
+		int b = -1;
+		sscanf(bytesString.Mid(i, 2).c_str(), "%x", &b);
+		if (b == -1) {
+			wxMessageBox("Please input only Hexadecimal bytes", "Bytes must be Hexadecimal", wxICON_WARNING);
+			return;
+		}
+		bytes.push_back(b);
+	}
+
+	if (!_rom->insertBytes(offset, bytes)) {
+		wxMessageBox("The offset has to be inside the rom", "Could not insert bytes", wxICON_WARNING);
+	}
+}
+
+void HexerFrame::onDeleteBytes(wxCommandEvent& event) {
+	if (_rom == nullptr) {
+		debug("tried to delete but no rom was loaded");
+		return;
+	}
+
+	wxString offsetString = wxGetTextFromUser("Offset to delete from (hex)", "Delete Bytes", wxString::Format("%X", _hexTable->_offset), this);
+	if (offsetString.IsEmpty()) {
+		return;
+	}
+
+	wxString lengthString = wxGetTextFromUser("Number of bytes to delete (hex)", "Delete Bytes", "1", this);
+	if (lengthString.IsEmpty()) {
+		return;
+	}
+
+	int offset = 0;
+	int length = 0;
+	sscanf(offsetString.c_str(), "%x", &offset);
+	sscanf(lengthString.c_str(), "%x", &length);
+
+	if (!_rom->deleteBytes(offset, length)) {
+		wxMessageBox("The bytes to delete have to be inside the rom", "Could not delete bytes", wxICON_WARNING);
+	}
+}
 // ------------------------------------------------------------------
 
 // ------------------------------------------------------------------
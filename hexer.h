@@ -51,12 +51,25 @@
 
 #include "rom.h"
 #include "romEditor.h"
+#include "script.h"
+#include "freeSpace.h"
+#include "tileSheet.h"
+#include "paletteFile.h"
+#include "entryTable.h"
+#include "patchState.h"
+#include "patchLibrary.h"
+#include "docsFile.h"
+#include "entryLog.h"
+#include "searchIndex.h"
+#include "docsMap.h"
 
 // For some reason this isn't a default template?
 template<class T> using wxVector2D = wxVector< wxVector<T> >;
 
 enum CommonValues {
 	kMacMargins = 19,
+	kPatchBudget = 64,						// How many patches are evaluated in one idle event
+	kSearchResults = 20						// How many search results are listed under the search bar
 };
 
 enum ID {
@@ -81,6 +94,9 @@ enum ID {
 	ID_MenuPreferences,
 	ID_MenuCredits,
 	ID_MenuContact,
+	ID_MenuExpand,
+	ID_MenuInsertBytes,
+	ID_MenuDeleteBytes,
 
 	// ToolBar
 	ID_ToolPrefs,
@@ -91,11 +107,27 @@ enum ID {
 	ID_ToolSearch,
 	ID_ToolSave,
 	ID_ToolOpen,
+	ID_SearchResult,
+	ID_SearchResultEnd = ID_SearchResult + kSearchResults,
 
 	// Grids
 
 	// Misc
 	ID_EditMode,
+	ID_ApplyPage,
+	ID_RevertPage,
+	ID_ApplyAll,
+	ID_RevertAll,
+	ID_ApplySelected,
+	ID_RevertSelected,
+	ID_ApplyFound,
+	ID_RevertFound,
+	ID_PreviewPage,
+	ID_DocsSort,
+	ID_DocsDescending,
+	ID_DocsFilter,
+	ID_DocsFrom,
+	ID_DocsTo,
 
 	// Dialog
 	ID_DTitle,
@@ -105,32 +137,39 @@ enum ID {
 	ID_DType,
 	ID_DAddress,
 	ID_DOldBytes,
-	ID_DNewBytes
+	ID_DNewBytes,
+	ID_DScriptMode,
+	ID_DScriptTable,
+	ID_DScriptCount,
+	ID_DScriptSize,
+	ID_DScriptAdjust,
+	ID_DScriptBank,
+	ID_DScriptStart,
+	ID_DScriptEnd,
+	ID_DFreeFiller,
+	ID_DFreeMin,
+	ID_DFreeSize,
+	ID_DFreeBank,
+	ID_DPalOperation,
+	ID_DPalColour,
+	ID_DPalAmount,
+	ID_DPalDepth,
+	ID_DPalOrder
 
 };
 
+enum PaletteAdjust {
+	kPaletteTint,						// Every colour is blended towards a colour by the same amount
+	kPaletteFade,						// The blend goes from nothing at the first colour up to the amount at the last
+	kPaletteReencode					// The colours are converted to a different bit depth or channel order
+};
+
 enum Views {
 	kViewDocs,
 	kViewHex,
 	kViewEdit
 };
 
-struct PatchBytes {
-	int _offset = 0;
-	wxVector<wxByte> _newBytes;
-	wxVector<wxByte> _oldBytes;
-};
-
-struct Entry {
-	int _cat = 0;
-	wxString _name = "";
-	wxString _desc = "";
-	wxString _addr = "";
-	wxString _size = "";
-	wxString _type = "";
-	wxVector<PatchBytes> _bytes;
-};
-
 struct ViewData {
 	wxNotebook  *_noteBook;
 	 wxTextCtrl *_catName;
@@ -194,6 +233,32 @@ protected:
 	// The rom is a member so that it can be read/written from anywhere
 	Rom *_rom = nullptr;
 
+	// The free space index is only made once it is needed, and then keeps itself up to date with the rom
+	FreeSpaceIndex *_freeSpace = nullptr;
+
+	// The tile sheet window is made the first time it is opened, and only hidden when it is closed
+	TileSheetFrame *_tileSheet = nullptr;
+
+	// The applied state of every patch, which is worked out in the background while the program is idle
+	PatchStates *_patchStates = nullptr;
+
+	// The binary patch library stays open while its patches are in the edit view, so that descriptions can be read from it later
+	PatchLibrary _patchLibrary;
+
+	// Changes to either notebook go into a log next to its file, instead of the whole file being written every time
+	EntryLog *_editLog = nullptr;
+	EntryLog *_docsLog = nullptr;
+
+	// The docs as a map of the rom, which the hex view shades and shows the name of the doc under the mouse from
+	DocsMap _docsMap;
+	Entry *_hoverDoc = nullptr;
+
+	// Both notebooks are indexed for the search bar the first time something is searched for, and kept up to date after that
+	SearchIndex _search;
+	wxSearchCtrl *_searchBar;
+	wxVector<SearchResult> _searchResults;
+	int _searchAt = -1;									// The result enter last went to, or -1 if it hasn't gone to one yet
+
 	// We also need the files to be accessable as members
 	wxTextFile _editFile;
 	wxTextFile _docsFile;
@@ -223,6 +288,7 @@ protected:
 	/* Specific to the DocsView */
 	ViewData *_docsData = nullptr;
 	wxVector2D<Entry> _docsEntries;
+	EntryView _docsOrder;					// How every page of the docs is sorted and filtered
 
 	/* Specific to the HexView */
 			  wxGrid *_hexGrid;
@@ -259,19 +325,31 @@ private:
 	void onPreferences(wxCommandEvent& event);
 	void onContact(wxCommandEvent& event);
 	void onCredits(wxCommandEvent& event);
+	void onClose(wxCloseEvent& event);
 	void onExit(wxCommandEvent& event);
 	void onAbout(wxCommandEvent& event);
 
 	// Toolbar functions
 	void onToggle(wxCommandEvent &event);
 	void onUndo(wxCommandEvent &event);
+	void onSearchText(wxCommandEvent &event);
+	void onSearchResult(wxCommandEvent &event);
+	void showSearchResult(int result);
+	void buildSearch();
+	void showView(int view);
 
 	// Edit View functions
 	void onEditGridLeftClick(wxGridEvent& event);
 	void onMouseInEditGrid(wxMouseEvent& event);
 	void onAddPatch(wxCommandEvent& event);
-	void onLoadNewPatchFile();
+	void onLoadNewPatchFile(wxCommandEvent& event);
+	void onExportPatchFile(wxCommandEvent& event);
+	void readDescriptions();
+	void reloadEditView();
 	void askDeleteClosedEdit(wxWindowModalDialogEvent &event);
+	void onPatchBatch(wxCommandEvent& event);
+	void applyPatches(const wxVector< std::pair<int, int> > &patches, bool apply);
+	void previewPatches(const wxVector< std::pair<int, int> > &patches);
 
 	// Docs View functions
 	void onDocsGridLeftClick(wxGridEvent& event);
@@ -283,6 +361,8 @@ private:
 	void onNotebookChange(wxBookCtrlEvent &event);
 	void onTextEnter(wxCommandEvent& event);
 	void onDocsGridDoubleClick(wxGridEvent &event);
+	void onDocsViewChanged(wxCommandEvent &event);
+	void useDocsView(int page);
 
 	// Hex View functions
 	void onColourPickerChanged(wxColourPickerEvent &event);
@@ -295,6 +375,14 @@ private:
 	void onChangeStringTable(wxCommandEvent &event);
 	void onGridLinesCheck(wxCommandEvent &event);
 	void onStringByteSizeChanged(wxSpinEvent &event);
+	void onStringStreamCheck(wxCommandEvent &event);
+	void onDumpScript(wxCommandEvent &event);
+	void onInsertScript(wxCommandEvent &event);
+	void onFindFreeSpace(wxCommandEvent &event);
+	void onPreviewIPS(wxCommandEvent &event);
+	void onCommitPreview(wxCommandEvent &event);
+	void onDiscardPreview(wxCommandEvent &event);
+	void showPreview(RomOverlay *preview);
 	void onFormatChanged(wxSpinEvent &event);
 	void onGfxBitdepthChanged(wxSpinEvent &event);
 	void onArrowUp(wxCommandEvent &event);
@@ -302,7 +390,9 @@ private:
 	void onArrowLeft(wxCommandEvent &event);
 	void onArrowRight(wxCommandEvent &event);
 	void onHexViewDClick(wxGridEvent &event);
+	void onHexGridMotion(wxMouseEvent &event);
 	 int calcByteSize(int numBits);
+	 int calcGfxByteSize();
 	void updateColLabels(int size);
 	void updateGridProps(int size, int cellSize, int byteSize, wxString colWidth);
 	void loadDefaultStringTable();
@@ -314,14 +404,26 @@ private:
 	void onColourSearch(wxCommandEvent &event);
 	void loadDefaultPalettes();
 	void loadPalette(wxVector<wxColour> &targetPal);
+	void paletteColours(PaletteFile &file, wxVector<wxColour> &targetPal);
+	bool paletteSelection(int &first, int &last, bool wholeRow);
+	void onImportPalette(wxCommandEvent &event);
+	void onExportPalette(wxCommandEvent &event);
 	void onChangeGfxPalette(wxCommandEvent &event);
 	void onLoadIndexedPalette(wxCommandEvent &event);
+	void onColourOrderChanged(wxCommandEvent &event);
+	void onAdjustPalette(wxCommandEvent &event);
 	void onGfxPalChanged(wxSpinEvent &event);
 	void onGfxRefresh(wxCommandEvent &event);
+	void onShowTileSheet(wxCommandEvent &event);
+	void refreshTileSheet();
 
 	// General program functions
 	void onOpen(wxCommandEvent& event);
+	void onIdle(wxIdleEvent &event);
 	void onSave(wxCommandEvent& event);
+	void onExpandRom(wxCommandEvent& event);
+	void onInsertBytes(wxCommandEvent& event);
+	void onDeleteBytes(wxCommandEvent& event);
 	void saveLocalEdit();
 	void saveLocalDocs();
 	void addEntry(bool addOrEdit, wxString n, wxString d, wxString s, wxString t, wxString a, wxString nb, wxString ob);
@@ -329,6 +431,9 @@ private:
 	void onRefresh(wxCommandEvent& event);
 	 int YToRowGood(wxGrid *grid, int y);
 	void moreInfo(wxString description, bool big);
+	bool scriptLayoutDialog(ScriptLayout &layout);
+	bool freeSpaceDialog(int &filler, int &minLength, int &length, int &bankSize);
+	bool paletteAdjustDialog(int &operation, wxColour &colour, int &amount, int &bitDepth, int &order);
 	void onGridMouseExit(wxMouseEvent& event);
 	void onSearch(wxCommandEvent &event);
 	void createPage(ViewData *data, wxString pageName, int row, int col);
@@ -0,0 +1,116 @@
+#include "intervalIndex.h"
+
+#include <algorithm>
+#include <climits>
+
+void IntervalIndex::clear() {
+	_intervals.clear();
+	_maxEnd.clear();
+}
+
+void IntervalIndex::add(int start, int end, int id) {
+	if (end <= start) {
+		return;
+	}
+
+	Interval interval;
+	interval._start = start;
+	interval._end = end;
+	interval._id = id;
+	_intervals.push_back(interval);
+}
+
+void IntervalIndex::build() {
+	std::sort(_intervals.begin(), _intervals.end());
+	_maxEnd.assign(_intervals.size(), INT_MIN);
+	buildSpan(0, _intervals.size());
+}
+
+void IntervalIndex::insert(int start, int end, int id) {
+	if (end <= start) {
+		return;
+	}
+
+	Interval interval;
+	interval._start = start;
+	interval._end = end;
+	interval._id = id;
+	_intervals.insert(std::upper_bound(_intervals.begin(), _intervals.end(), interval), interval);
+
+	_maxEnd.assign(_intervals.size(), INT_MIN);
+	buildSpan(0, _intervals.size());
+}
+
+void IntervalIndex::remove(int id, wxVector<Interval> *removed) {
+	int kept = 0;
+	for (int i = 0; i < _intervals.size(); i++) {
+		if (_intervals[i]._id != id) {
+			_intervals[kept++] = _intervals[i];
+
+		} else if (removed != nullptr) {
+			removed->push_back(_intervals[i]);
+		}
+	}
+
+	if (kept == _intervals.size()) {
+		return;
+	}
+	_intervals.resize(kept);
+
+	_maxEnd.assign(_intervals.size(), INT_MIN);
+	buildSpan(0, _intervals.size());
+}
+
+// Returns the furthest end in [low, high), after filling it in for the node of that span and every span under it
+int IntervalIndex::buildSpan(int low, int high) {
+	if (low >= high) {
+		return INT_MIN;
+	}
+
+	int mid = low + ((high - low) / 2);
+	int maxEnd = _intervals[mid]._end;
+	maxEnd = std::max(maxEnd, buildSpan(low, mid));
+	maxEnd = std::max(maxEnd, buildSpan(mid + 1, high));
+	_maxEnd[mid] = maxEnd;
+	return maxEnd;
+}
+
+/* Nothing in a span can overlap if none of it reaches past the start, and since the
+ * ranges are sorted, nothing after a node that starts at or past the end can either
+ */
+void IntervalIndex::findSpan(int low, int high, int start, int end, wxVector<int> *ids, bool &found) {
+	if ((low >= high) || (found && (ids == nullptr))) {
+		return;
+	}
+
+	int mid = low + ((high - low) / 2);
+	if (_maxEnd[mid] <= start) {
+		return;
+	}
+
+	findSpan(low, mid, start, end, ids, found);
+
+	if (_intervals[mid]._start >= end) {
+		return;
+	}
+
+	if (_intervals[mid]._end > start) {
+		found = true;
+		if (ids != nullptr) {
+			ids->push_back(_intervals[mid]._id);
+		}
+	}
+
+	findSpan(mid + 1, high, start, end, ids, found);
+}
+
+void IntervalIndex::find(int start, int end, wxVector<int> &ids) {
+	bool found = false;
+	findSpan(0, _intervals.size(), start, end, &ids, found);
+}
+
+bool IntervalIndex::any(int start, int end) {
+	bool found = false;
+	findSpan(0, _intervals.size(), start, end, nullptr, found);
+	return found;
+}
@@ -0,0 +1,55 @@
+#ifndef HEXER_INTERVALINDEX_H
+#define HEXER_INTERVALINDEX_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+
+// A range of offsets [start, end), and whatever number the owner of the index uses to know what it belongs to
+struct Interval {
+	int _start;
+	int _end;
+	int _id;
+
+	bool operator<(const Interval &other) const { return _start < other._start; }
+};
+
+/* Hexer Interval Index
+ * An interval tree over ranges of the rom. The ranges are kept sorted by where they
+ * start, and the tree is implicit in that array: the middle of any span is the node
+ * for that span, and it keeps the furthest end of anything in it. A lookup only has to
+ * go down the sides of the tree that can reach the range it is looking for, so finding
+ * what overlaps a range is O(log n) plus the number of ranges found.
+ * Ranges are added and then the index is built. After that, ranges can be inserted and
+ * removed one owner at a time, which keeps them sorted without sorting everything again,
+ * and only has to fill in the ends of the tree again.
+ */
+class IntervalIndex {
+public:
+	void clear();
+	void add(int start, int end, int id);
+	void build();										// Has to be called after adding ranges, before looking anything up
+
+	void insert(int start, int end, int id);			// Puts a range into a built index
+	void remove(int id, wxVector<Interval> *removed = nullptr);	// Takes every range with the id out of a built index, adding them to removed
+
+	void find(int start, int end, wxVector<int> &ids);	// Adds the id of every range overlapping [start, end) to ids
+	bool any(int start, int end);						// Whether anything overlaps [start, end)
+	bool contains(int offset) { return any(offset, offset + 1); }
+
+	int size() { return _intervals.size(); }
+
+private:
+	wxVector<Interval> _intervals;
+	wxVector<int> _maxEnd;								// For the node at each position, the furthest end of its whole span
+
+	int buildSpan(int low, int high);
+	void findSpan(int low, int high, int start, int end, wxVector<int> *ids, bool &found);
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "mappedFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#define HEXER_CAN_MMAP
+#endif
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(wxString path) {
+	close();
+
+#ifdef HEXER_CAN_MMAP
+	int fd = ::open(path.fn_str(), O_RDONLY);
+	if (fd >= 0) {
+		struct stat info;
+		if ((fstat(fd, &info) == 0) && (info.st_size > 0)) {
+			void *map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (map != MAP_FAILED) {
+				// The mapping stays valid after the descriptor is closed
+				::close(fd);
+				_data = (const wxByte *) map;
+				_size = info.st_size;
+				_mapped = true;
+				return true;
+			}
+		}
+		::close(fd);
+	}
+#endif
+
+	// If mapping isn't available (or failed), we just read the whole file in one go
+	wxFile file(path, wxFile::read);
+	if (!file.IsOpened()) {
+		return false;
+	}
+
+	_size = file.Length();
+	_buffer.resize(_size + 1);
+	if (file.Read(&_buffer[0], _size) != (ssize_t) _size) {
+		_buffer.clear();
+		_size = 0;
+		return false;
+	}
+
+	_data = &_buffer[0];
+	return true;
+}
+
+void MappedFile::close() {
+#ifdef HEXER_CAN_MMAP
+	if (_mapped && (_data != nullptr)) {
+		munmap((void *) _data, _size);
+	}
+#endif
+	_buffer.clear();
+	_data = nullptr;
+	_size = 0;
+	_mapped = false;
+}
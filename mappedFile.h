@@ -0,0 +1,43 @@
+#ifndef HEXER_MAPPEDFILE_H
+#define HEXER_MAPPEDFILE_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+#include <wx/file.h>
+
+/* Hexer Mapped File
+ * A read only view of an entire file. Where the platform
+ * supports it the file is memory mapped, so opening even
+ * a very large file costs nothing until the bytes are touched.
+ * Everywhere else it falls back to reading the file into a buffer.
+ */
+class MappedFile {
+public:
+	MappedFile() {}
+	~MappedFile();
+
+	bool open(wxString path);				// Maps the file at path, returns false if it could not be opened
+	void close();							// Unmaps the file (or frees the fallback buffer)
+
+	const wxByte *data() { return _data; }	// The start of the file contents
+	size_t size() { return _size; }			// The number of bytes in the file
+	bool isOpen() { return _data != nullptr; }
+
+private:
+	const wxByte *_data = nullptr;
+	size_t _size = 0;
+	bool _mapped = false;
+	wxVector<wxByte> _buffer;				// Only used when the file can't be mapped
+
+	// A mapping can't be shared between two objects
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "paletteFile.h"
+#include "mappedFile.h"
+#include "colourFormat.h"
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <cstring>
+
+// Returns the value of a digit in base (10 or 16), or -1 if it isn't one
+static int digitValue(int c, int base) {
+	if ((c >= '0') && (c <= '9')) {
+		return c - '0';
+	} else if ((base == 16) && (c >= 'A') && (c <= 'F')) {
+		return c - 'A' + 10;
+	} else if ((base == 16) && (c >= 'a') && (c <= 'f')) {
+		return c - 'a' + 10;
+	}
+	return -1;
+}
+
+// Moves pos past the next line, and gives back where it starts and ends (without the \r of windows line endings)
+static bool nextLine(const wxByte *data, size_t size, size_t &pos, size_t &start, size_t &end) {
+	if (pos >= size) {
+		return false;
+	}
+
+	start = pos;
+	while ((pos < size) && (data[pos] != '\n')) {
+		pos++;
+	}
+	end = pos;
+	pos++;
+
+	if ((end > start) && (data[end - 1] == '\r')) {
+		end--;
+	}
+	return true;
+}
+
+// True if the line starting at pos begins with header
+static bool startsWith(const wxByte *data, size_t size, size_t pos, const char *header) {
+	size_t length = strlen(header);
+	return ((pos + length) <= size) && (memcmp(&data[pos], header, length) == 0);
+}
+
+wxString PaletteFile::wildcard() {
+	return "Comma palette (*.pal)|*.pal|JASC palette (*.pal)|*.pal|GIMP palette (*.gpl)|*.gpl|BGR555 binary (*.bin)|*.bin";
+}
+
+/* Every line with three numbers on it is a colour. Anything between the numbers is
+ * a separator, and anything after the third is ignored, which covers the names in gimp palettes
+ */
+void PaletteFile::readText(const wxByte *data, size_t size, size_t pos, int base, bool comments) {
+	size_t start = 0;
+	size_t end = 0;
+	while (nextLine(data, size, pos, start, end)) {
+		if (comments && (start < end) && (data[start] == '#')) {
+			continue;
+		}
+
+		int values[3] = {0, 0, 0};
+		int found = 0;
+		size_t c = start;
+		while ((c < end) && (found < 3)) {
+			if (digitValue(data[c], base) == -1) {
+				c++;
+				continue;
+			}
+
+			int value = 0;
+			while ((c < end) && (digitValue(data[c], base) != -1)) {
+				value = (value * base) + digitValue(data[c], base);
+				c++;
+			}
+			values[found] = (value > 0xFF) ? 0xFF : value;
+			found++;
+		}
+
+		if (found == 3) {
+			_rgb.push_back(values[0]);
+			_rgb.push_back(values[1]);
+			_rgb.push_back(values[2]);
+		}
+	}
+}
+
+// The colours go through the same tables as the palette view, as 5 bits per channel with red first
+void PaletteFile::readBinary(const wxByte *data, size_t size) {
+	int count = size / 2;
+	wxVector<wxByte> raw(count * 3);
+	_rgb.resize(count * 3);
+	if (count > 0) {
+		decodeColours(ColourFormat(5, kColourRGB), data, count, &raw[0]);
+		expandColours(ColourFormat(5, kColourRGB), &raw[0], count, &_rgb[0]);
+	}
+}
+
+bool PaletteFile::load(wxString path) {
+	MappedFile file;
+	if (!file.open(path)) {
+		_error = "Could not open the palette file";
+		return false;
+	}
+
+	const wxByte *data = file.data();
+	size_t size = file.size();
+	size_t pos = 0;
+	_rgb.clear();
+
+	// JASC and GIMP palettes say what they are in the first line
+	if (startsWith(data, size, 0, "JASC-PAL")) {
+		// After the header is the version and then the number of colours, which we don't need to read every line
+		_format = kPalFileJASC;
+		size_t start = 0;
+		size_t end = 0;
+		for (int i = 0; i < 3; i++) {
+			nextLine(data, size, pos, start, end);
+		}
+		readText(data, size, pos, 10, false);
+
+	} else if (startsWith(data, size, 0, "GIMP Palette")) {
+		// The header can have a name and column count after it, and the name can easily have numbers in it
+		_format = kPalFileGIMP;
+		size_t start = 0;
+		size_t end = 0;
+		nextLine(data, size, pos, start, end);
+		while (startsWith(data, size, pos, "Name:") || startsWith(data, size, pos, "Columns:")) {
+			nextLine(data, size, pos, start, end);
+		}
+		readText(data, size, pos, 10, true);
+
+	} else {
+		/* Anything else is a comma palette, unless it has bytes that could never be in a text file.
+		 * Text with anything else in it (like # comments or 0x) is some other kind of palette,
+		 * which would only give back garbage if it was read as colours
+		 */
+		_format = kPalFileComma;
+		bool text = true;
+		for (size_t i = 0; i < size; i++) {
+			wxByte c = data[i];
+			bool space = (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+			if (!space && ((c < 0x20) || (c > 0x7E))) {
+				_format = kPalFileBGR555;
+				break;
+			}
+			if (!space && (c != ',') && (digitValue(c, 16) == -1)) {
+				text = false;
+			}
+		}
+
+		if ((_format == kPalFileComma) && !text) {
+			_error = "The palette file is text, but not in a format that can be read";
+			return false;
+
+		} else if (_format == kPalFileComma) {
+			readText(data, size, pos, 16, false);
+		} else {
+			readBinary(data, size);
+		}
+	}
+
+	if (_rgb.empty()) {
+		_error = "The palette file does not have any colours in it";
+		return false;
+	}
+	return true;
+}
+
+bool PaletteFile::save(wxString path, int format) {
+	int colours = count();
+
+	// The whole file is put together first, so it can be written all at once
+	wxVector<wxByte> out;
+	if (format == kPalFileBGR555) {
+		wxVector<wxByte> raw(colours * 3);
+		out.resize(colours * 2);
+		if (colours > 0) {
+			reduceColours(ColourFormat(5, kColourRGB), &_rgb[0], colours, &raw[0]);
+			encodeColours(ColourFormat(5, kColourRGB), &raw[0], colours, &out[0]);
+		}
+
+	} else {
+		wxString text;
+		if (format == kPalFileJASC) {
+			text << "JASC-PAL\r\n0100\r\n" << colours << "\r\n";
+
+		} else if (format == kPalFileGIMP) {
+			text << "GIMP Palette\nName: " << wxFileName(path).GetName() << "\nColumns: 16\n#\n";
+		}
+
+		for (int i = 0; i < colours; i++) {
+			int r = _rgb[(i * 3)];
+			int g = _rgb[(i * 3) + 1];
+			int b = _rgb[(i * 3) + 2];
+			switch (format) {
+			case kPalFileJASC:
+				text << wxString::Format("%d %d %d\r\n", r, g, b);
+				break;
+
+			case kPalFileGIMP:
+				text << wxString::Format("%3d %3d %3d\tIndex %d\n", r, g, b, i);
+				break;
+
+			default:
+				text << wxString::Format("%02X,%02X,%02X\n", r, g, b);
+				break;
+			}
+		}
+
+		wxScopedCharBuffer utf8 = text.utf8_str();
+		out.assign((const wxByte *) utf8.data(), (const wxByte *) utf8.data() + utf8.length());
+	}
+
+	wxFFile file(path, "wb");
+	if (!file.IsOpened()) {
+		_error = "Could not create the palette file";
+		return false;
+	}
+
+	if (!out.empty() && (file.Write(&out[0], out.size()) != out.size())) {
+		_error = "Could not write the whole palette file";
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,48 @@
+#ifndef HEXER_PALETTEFILE_H
+#define HEXER_PALETTEFILE_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+
+// In the same order as the file types in the import and export dialogs
+enum PaletteFileFormat {
+	kPalFileComma,							// RR,GG,BB in hex on every line, like palettes/greyscale.pal
+	kPalFileJASC,							// JASC-PAL, a header and then R G B in decimal on every line
+	kPalFileGIMP,							// GIMP Palette, a header and then R G B in decimal followed by an optional name
+	kPalFileBGR555,							// Raw 2 byte little endian colours, with red in the lowest 5 bits
+	kPalFileFormats
+};
+
+/* Hexer Palette File
+ * Reads and writes a whole palette at once in any of the formats above.
+ * The colours are always held as 24bit RGB triples, so they can go
+ * straight through the colour format tables to and from the rom.
+ * The format of a file being loaded is worked out from its contents.
+ */
+class PaletteFile {
+public:
+	bool load(wxString path);						// Replaces the colours with the ones in the file
+	bool save(wxString path, int format);			// Writes every colour to the file in format
+
+	int count() { return _rgb.size() / 3; }
+	int format() { return _format; }				// The format of the last file loaded
+
+	static wxString wildcard();						// The file types for a file dialog, in PaletteFileFormat order
+
+	wxVector<wxByte> _rgb;							// count() colours of red, green and blue
+	wxString _error;								// Why the last load or save failed
+
+private:
+	int _format = kPalFileComma;
+
+	void readText(const wxByte *data, size_t size, size_t pos, int base, bool comments);
+	void readBinary(const wxByte *data, size_t size);
+};
+
+#endif
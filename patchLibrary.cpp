@@ -0,0 +1,334 @@
+#include "patchLibrary.h"
+
+#include <wx/ffile.h>
+#include <wx/textfile.h>
+#include <wx/tokenzr.h>
+#include <cstring>
+
+static wxUint32 get32(const wxByte *data) {
+	return data[0] | (data[1] << 8) | (data[2] << 16) | ((wxUint32) data[3] << 24);
+}
+
+static void put32(wxVector<wxByte> &out, wxUint32 value) {
+	out.push_back(value & 0xFF);
+	out.push_back((value >> 8) & 0xFF);
+	out.push_back((value >> 16) & 0xFF);
+	out.push_back((value >> 24) & 0xFF);
+}
+
+// Adds a string to the text section, and gives back where it went and how long it is
+static void putText(wxVector<wxByte> &text, const wxString &s, wxUint32 &at, wxUint32 &length) {
+	wxScopedCharBuffer utf8 = s.utf8_str();
+	at = text.size();
+	length = utf8.length();
+	text.insert(text.end(), (const wxByte *) utf8.data(), (const wxByte *) utf8.data() + length);
+}
+
+/* Nothing is copied out of the file except the names and the bytes, which the grid and the
+ * patch states need right away. Every record is checked against the size of the file first,
+ * so a broken library is turned away instead of being read past its end
+ */
+bool PatchLibrary::open(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches) {
+	_error = "";
+	close();
+	if (!_file.open(path)) {
+		_error = "Could not open " + path;
+		return false;
+	}
+
+	const wxByte *data = _file.data();
+	size_t size = _file.size();
+	if ((size < kLibraryHeaderSize) || (memcmp(data, "HXPL", 4) != 0) || (get32(data + 4) != kLibraryVersion)) {
+		_error = "Not a patch library";
+		close();
+		return false;
+	}
+
+	size_t catCount = get32(data + 8);
+	size_t patchCount = get32(data + 12);
+	size_t indexStart = get32(data + 16);
+	size_t payloadStart = get32(data + 20);
+	size_t textStart = get32(data + 24);
+	if ((catCount == 0) || (indexStart < (kLibraryHeaderSize + (catCount * kLibraryCatSize))) || ((indexStart + (patchCount * kLibraryIndexSize)) > payloadStart)
+	 || (payloadStart > textStart) || (textStart > size)) {
+		_error = "The patch library is broken";
+		close();
+		return false;
+	}
+
+	size_t textSize = size - textStart;
+	cats.clear();
+	for (size_t c = 0; c < catCount; c++) {
+		const wxByte *record = data + kLibraryHeaderSize + (c * kLibraryCatSize);
+		size_t at = get32(record);
+		size_t length = get32(record + 4);
+		if ((at + length) > textSize) {
+			_error = "The patch library is broken";
+			close();
+			return false;
+		}
+		cats.push_back(wxString::FromUTF8((const char *) data + textStart + at, length));
+	}
+
+	patches.clear();
+	patches.resize(catCount);
+	for (size_t p = 0; p < patchCount; p++) {
+		const wxByte *record = data + indexStart + (p * kLibraryIndexSize);
+		size_t cat = get32(record);
+		size_t pos = payloadStart + get32(record + 4);
+		size_t ranges = get32(record + 8);
+		size_t nameAt = get32(record + 12);
+		size_t nameLength = get32(record + 16);
+		size_t descAt = get32(record + 20);
+		size_t descLength = get32(record + 24);
+		if ((cat >= catCount) || ((nameAt + nameLength) > textSize) || ((descAt + descLength) > textSize)) {
+			_error = "The patch library is broken";
+			close();
+			return false;
+		}
+
+		Entry e;
+		e._cat = cat;
+		e._name = wxString::FromUTF8((const char *) data + textStart + nameAt, nameLength);
+		e._descAt = textStart + descAt;
+		e._descLength = descLength;
+
+		for (size_t r = 0; r < ranges; r++) {
+			if ((pos + kLibraryRangeSize) > textStart) {
+				_error = "The patch library is broken";
+				close();
+				return false;
+			}
+
+			PatchBytes bytes;
+			bytes._offset = get32(data + pos);
+			size_t newLength = get32(data + pos + 4);
+			size_t oldLength = get32(data + pos + 8);
+			pos += kLibraryRangeSize;
+			if ((pos + newLength + oldLength) > textStart) {
+				_error = "The patch library is broken";
+				close();
+				return false;
+			}
+
+			bytes._newBytes.assign(data + pos, data + pos + newLength);
+			pos += newLength;
+			bytes._oldBytes.assign(data + pos, data + pos + oldLength);
+			pos += oldLength;
+			e._bytes.push_back(bytes);
+		}
+		patches[cat].push_back(e);
+	}
+	return true;
+}
+
+wxString PatchLibrary::description(Entry &e) {
+	if (e._descAt < 0) {
+		return e._desc;
+	}
+
+	if (isOpen() && ((e._descAt + e._descLength) <= _file.size())) {
+		e._desc = wxString::FromUTF8((const char *) _file.data() + e._descAt, e._descLength);
+	}
+	e._descAt = -1;
+	return e._desc;
+}
+
+/* The sections are built in memory first, since where each one starts has to be in the header,
+ * and then the whole file is written in one go
+ */
+bool PatchLibrary::save(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches) {
+	_error = "";
+
+	wxVector<wxByte> index;
+	wxVector<wxByte> payload;
+	wxVector<wxByte> text;
+	wxVector<wxByte> catTable;
+	wxUint32 at = 0;
+	wxUint32 length = 0;
+	int patchCount = 0;
+
+	for (int c = 0; c < cats.size(); c++) {
+		putText(text, cats[c], at, length);
+		put32(catTable, at);
+		put32(catTable, length);
+	}
+
+	for (int c = 0; c < patches.size(); c++) {
+		for (int i = 0; i < patches[c].size(); i++) {
+			Entry &e = patches[c][i];
+			put32(index, c);
+			put32(index, payload.size());
+			put32(index, e._bytes.size());
+			putText(text, e._name, at, length);
+			put32(index, at);
+			put32(index, length);
+			putText(text, e._desc, at, length);
+			put32(index, at);
+			put32(index, length);
+
+			for (int b = 0; b < e._bytes.size(); b++) {
+				put32(payload, e._bytes[b]._offset);
+				put32(payload, e._bytes[b]._newBytes.size());
+				put32(payload, e._bytes[b]._oldBytes.size());
+				payload.insert(payload.end(), e._bytes[b]._newBytes.begin(), e._bytes[b]._newBytes.end());
+				payload.insert(payload.end(), e._bytes[b]._oldBytes.begin(), e._bytes[b]._oldBytes.end());
+			}
+			patchCount++;
+		}
+	}
+
+	wxVector<wxByte> header;
+	header.push_back('H');
+	header.push_back('X');
+	header.push_back('P');
+	header.push_back('L');
+	put32(header, kLibraryVersion);
+	put32(header, cats.size());
+	put32(header, patchCount);
+	put32(header, kLibraryHeaderSize + catTable.size());
+	put32(header, kLibraryHeaderSize + catTable.size() + index.size());
+	put32(header, kLibraryHeaderSize + catTable.size() + index.size() + payload.size());
+	put32(header, 0);
+
+	wxFFile file(path, "wb");
+	if (!file.IsOpened()) {
+		_error = "Could not write to " + path;
+		return false;
+	}
+
+	bool written = (file.Write(&header[0], header.size()) == header.size());
+	written = written && (catTable.empty() || (file.Write(&catTable[0], catTable.size()) == catTable.size()));
+	written = written && (index.empty() || (file.Write(&index[0], index.size()) == index.size()));
+	written = written && (payload.empty() || (file.Write(&payload[0], payload.size()) == payload.size()));
+	written = written && (text.empty() || (file.Write(&text[0], text.size()) == text.size()));
+	if (!written) {
+		_error = "Could not write to " + path;
+	}
+	return written;
+}
+
+/* The first line is the category names, and every line after that is one patch, as:
+ * category|title|offsets|new bytes|old bytes|description
+ * The offsets and bytes are comma separated hex, and a description in quotes can go over several lines
+ */
+bool PatchLibrary::readText(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches) {
+	_error = "";
+	wxTextFile file(path);
+	if (!file.Open()) {
+		_error = "Could not load " + path;
+		return false;
+	}
+
+	cats.clear();
+	wxStringTokenizer catTokenizer(file.GetFirstLine(), "|");
+	while (catTokenizer.HasMoreTokens()) {
+		cats.push_back(catTokenizer.GetNextToken());
+	}
+
+	patches.clear();
+	patches.resize(cats.size());
+	for (wxString line = file.GetNextLine(); !file.Eof(); line = file.GetNextLine()) {
+		Entry e;
+		wxStringTokenizer lineTokenizer(line, "|");
+
+		e._cat = wxAtoi(lineTokenizer.GetNextToken());
+		e._name = lineTokenizer.GetNextToken();
+		wxString lineOffsets = lineTokenizer.GetNextToken();
+		wxString lineNewBytes = lineTokenizer.GetNextToken();
+		wxString lineOldBytes = lineTokenizer.GetNextToken();
+		e._desc = lineTokenizer.GetNextToken();
+
+		// To properly capture multi-line descriptions, the whole string is contained in "" instead of always being one line per entry
+		if (!e._desc.IsEmpty() && (e._desc[0] == '\"')) {
+			wxString longLine = line;
+			while (longLine[longLine.size() - 1] != '\"') {
+				longLine = file.GetNextLine();
+				e._desc << '\n' << longLine;
+			}
+		}
+
+		// Each of the offset/byte lines is deliniated by commas
+		wxStringTokenizer offsetTokenizer(lineOffsets, ",");
+		wxStringTokenizer newByteTokenizer(lineNewBytes, ",");
+		wxStringTokenizer oldByteTokenizer(lineOldBytes, ",");
+
+		while (offsetTokenizer.HasMoreTokens()) {
+			PatchBytes offsetBytes;
+			sscanf(offsetTokenizer.GetNextToken().c_str(), "%x", &offsetBytes._offset);
+
+			wxString newBytes = newByteTokenizer.GetNextToken();
+			wxString oldBytes = oldByteTokenizer.GetNextToken();
+
+			for (int i = 0; i < newBytes.size(); i += 2) {
+				int newByte;
+				sscanf(newBytes.SubString(i, i + 1).c_str(), "%x", &newByte);
+				offsetBytes._newBytes.push_back(newByte);
+
+				int oldByte;
+				sscanf(oldBytes.SubString(i, i + 1).c_str(), "%x", &oldByte);
+				offsetBytes._oldBytes.push_back(oldByte);
+			}
+			e._bytes.push_back(offsetBytes);
+		}
+
+		if ((e._cat < 0) || (e._cat >= patches.size())) {
+			continue;
+		}
+		patches[e._cat].push_back(e);
+	}
+	return true;
+}
+
+bool PatchLibrary::writeText(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches) {
+	_error = "";
+	wxTextFile file(path);
+	if (file.Exists() ? !file.Open() : !file.Create()) {
+		_error = "Could not write to " + path;
+		return false;
+	}
+
+	file.Clear();
+	wxString catLine = "";
+	for (int i = 0; i < cats.size(); i++) {
+		catLine << cats[i];
+		if (i != cats.size() - 1) {
+			catLine << "|";
+		}
+	}
+	file.AddLine(catLine);
+
+	for (int i = 0; i < patches.size(); i++) {
+		for (int j = 0; j < patches[i].size(); j++) {
+			Entry &e = patches[i][j];
+			wxString editLine = "";
+			editLine << i << "|";
+			editLine << e._name << "|";
+
+			wxString sOffsets = "";
+			wxString sOldBytes = "";
+			wxString sNewBytes = "";
+			for (int k = 0; k < e._bytes.size(); k++) {
+				// For every offset, we add an offset to the offset string, and the byte strings to old/newbytes
+				sOffsets << wxString::Format("%X", e._bytes[k]._offset);
+				for (int l = 0; l < e._bytes[k]._oldBytes.size(); l++) {
+					sOldBytes << wxString::Format("%02X", e._bytes[k]._oldBytes[l]);
+					sNewBytes << wxString::Format("%02X", e._bytes[k]._newBytes[l]);
+				}
+				if (k != e._bytes.size() - 1) {
+					// Separated by commas
+					sOffsets << ",";
+					sOldBytes << ",";
+					sNewBytes << ",";
+				}
+			}
+			editLine << sOffsets << "|";
+			editLine << sNewBytes << "|";
+			editLine << sOldBytes << "|";
+			editLine << e._desc;
+
+			file.AddLine(editLine);
+		}
+	}
+	return file.Write();
+}
@@ -0,0 +1,50 @@
+#ifndef HEXER_PATCHLIBRARY_H
+#define HEXER_PATCHLIBRARY_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+
+#include "entryTable.h"
+#include "mappedFile.h"
+
+enum PatchLibraryLayout {
+	kLibraryVersion    = 1,
+	kLibraryHeaderSize = 32,				// 'HXPL', version, categories, patches, and where the index, payload and text start
+	kLibraryCatSize    = 8,					// Where the name is in the text, and its length
+	kLibraryIndexSize  = 28,				// Category, where the ranges are, how many, and where the name and description are
+	kLibraryRangeSize  = 12					// Offset, new length and old length, followed by the new and then old bytes
+};
+
+/* Hexer Patch Library
+ * The patches in a binary file that can be opened without parsing any text. After a fixed
+ * header is a table of categories and an index with one fixed size record per patch, then the
+ * bytes of every patch, and then all of the text. Every number is 4 bytes, little endian.
+ * The file stays mapped while it is open, and descriptions are only read out of it when they
+ * are needed, so an entry just keeps where its description is until then.
+ * The pipe separated text format can be read and written too, for importing and exporting.
+ */
+class PatchLibrary {
+public:
+	bool open(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches);
+	void close() { _file.close(); }
+	bool isOpen() { return _file.isOpen(); }
+
+	wxString description(Entry &e);			// Reads the description of the entry the first time, and keeps it in the entry
+
+	bool save(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches);	// Every description has to be read first
+	bool readText(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches);
+	bool writeText(wxString path, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &patches);
+
+	wxString _error;						// Why the last open, read or write failed
+
+private:
+	MappedFile _file;
+};
+
+#endif
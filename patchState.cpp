@@ -0,0 +1,276 @@
+#include "patchState.h"
+
+#include <algorithm>
+#include <cstring>
+#include <climits>
+
+PatchStates::PatchStates(Rom *rom, wxVector< wxVector<Entry> > *patches) {
+	_rom = rom;
+	_patches = patches;
+	rebuild();
+	_rom->addListener(this);
+}
+
+PatchStates::~PatchStates() {
+	_rom->removeListener(this);
+}
+
+void PatchStates::rebuild() {
+	_index.clear();
+	_list.clear();
+	_queue.clear();
+
+	for (int c = 0; c < _patches->size(); c++) {
+		for (int i = 0; i < (*_patches)[c].size(); i++) {
+			const Entry &e = (*_patches)[c][i];
+			for (int b = 0; b < e._bytes.size(); b++) {
+				_index.add(e._bytes[b]._offset, e._bytes[b]._offset + e._bytes[b]._newBytes.size(), _list.size());
+			}
+			_list.push_back(std::make_pair(c, i));
+			_queue.insert(std::make_pair(c, i));
+		}
+	}
+	_index.build();
+
+	// With the index built, any patch with a range that overlaps a range of a different patch is in conflict
+	_conflicts = 0;
+	for (int p = 0; p < _list.size(); p++) {
+		(*_patches)[_list[p].first][_list[p].second]._conflict = false;
+		checkConflict(p);
+	}
+}
+
+// Works out again whether a patch overlaps any other, keeping the count of conflicts up to date
+void PatchStates::checkConflict(int id) {
+	if (_list[id].first == -1) {
+		return;
+	}
+
+	Entry &e = (*_patches)[_list[id].first][_list[id].second];
+	bool conflict = false;
+	wxVector<int> ids;
+	for (int b = 0; (b < e._bytes.size()) && !conflict; b++) {
+		ids.clear();
+		_index.find(e._bytes[b]._offset, e._bytes[b]._offset + e._bytes[b]._newBytes.size(), ids);
+		for (int i = 0; i < ids.size(); i++) {
+			if (ids[i] != id) {
+				conflict = true;
+				break;
+			}
+		}
+	}
+
+	if (conflict != e._conflict) {
+		_conflicts += conflict ? 1 : -1;
+		e._conflict = conflict;
+	}
+}
+
+int PatchStates::idOf(int cat, int index) {
+	for (int p = 0; p < _list.size(); p++) {
+		if ((_list[p].first == cat) && (_list[p].second == index)) {
+			return p;
+		}
+	}
+	return -1;
+}
+
+void PatchStates::indexRanges(int id, std::set<int> &touched) {
+	const Entry &e = (*_patches)[_list[id].first][_list[id].second];
+	for (int b = 0; b < e._bytes.size(); b++) {
+		_index.insert(e._bytes[b]._offset, e._bytes[b]._offset + e._bytes[b]._newBytes.size(), id);
+	}
+
+	wxVector<int> ids;
+	for (int b = 0; b < e._bytes.size(); b++) {
+		_index.find(e._bytes[b]._offset, e._bytes[b]._offset + e._bytes[b]._newBytes.size(), ids);
+	}
+	touched.insert(ids.begin(), ids.end());
+}
+
+// The ranges come out of the index first, so the patches they overlapped can be found without them
+void PatchStates::unindexRanges(int id, std::set<int> &touched) {
+	wxVector<Interval> removed;
+	_index.remove(id, &removed);
+
+	wxVector<int> ids;
+	for (int i = 0; i < removed.size(); i++) {
+		_index.find(removed[i]._start, removed[i]._end, ids);
+	}
+	touched.insert(ids.begin(), ids.end());
+}
+
+void PatchStates::add(int cat, int index) {
+	int id = _list.size();
+	_list.push_back(std::make_pair(cat, index));
+	(*_patches)[cat][index]._conflict = false;
+
+	std::set<int> touched;
+	indexRanges(id, touched);
+	touched.insert(id);
+	for (std::set<int>::iterator it = touched.begin(); it != touched.end(); it++) {
+		checkConflict(*it);
+	}
+	_queue.insert(std::make_pair(cat, index));
+}
+
+void PatchStates::update(int cat, int index) {
+	int id = idOf(cat, index);
+	if (id == -1) {
+		add(cat, index);
+		return;
+	}
+
+	// The patch might overlap different patches now, and the ones it used to overlap might not conflict any more
+	std::set<int> touched;
+	unindexRanges(id, touched);
+	indexRanges(id, touched);
+	touched.insert(id);
+	for (std::set<int>::iterator it = touched.begin(); it != touched.end(); it++) {
+		checkConflict(*it);
+	}
+	_queue.insert(std::make_pair(cat, index));
+}
+
+void PatchStates::remove(int cat, int index) {
+	int id = idOf(cat, index);
+	if (id == -1) {
+		return;
+	}
+
+	std::set<int> touched;
+	unindexRanges(id, touched);
+
+	Entry &e = (*_patches)[cat][index];
+	if (e._conflict) {
+		_conflicts--;
+		e._conflict = false;
+	}
+	_list[id] = std::make_pair(-1, -1);
+
+	// This is done while the patch is still in its category, so the others are still where _list says they are
+	for (std::set<int>::iterator it = touched.begin(); it != touched.end(); it++) {
+		checkConflict(*it);
+	}
+
+	// Everything after it in the category moves up one
+	for (int p = 0; p < _list.size(); p++) {
+		if ((_list[p].first == cat) && (_list[p].second > index)) {
+			_list[p].second--;
+		}
+	}
+
+	std::set< std::pair<int, int> > queue;
+	for (std::set< std::pair<int, int> >::iterator it = _queue.begin(); it != _queue.end(); it++) {
+		if (it->first != cat) {
+			queue.insert(*it);
+
+		} else if (it->second > index) {
+			queue.insert(std::make_pair(cat, it->second - 1));
+
+		} else if (it->second < index) {
+			queue.insert(*it);
+		}
+	}
+	_queue.swap(queue);
+}
+
+void PatchStates::patchesAt(int offset, int length, wxVector< std::pair<int, int> > &patches) {
+	wxVector<int> ids;
+	_index.find(offset, offset + length, ids);
+
+	// A patch with more than one range over the bytes is only given once
+	std::sort(ids.begin(), ids.end());
+	for (int i = 0; i < ids.size(); i++) {
+		if ((i == 0) || (ids[i] != ids[i - 1])) {
+			patches.push_back(_list[ids[i]]);
+		}
+	}
+}
+
+void PatchStates::conflictsWith(int cat, int index, wxVector< std::pair<int, int> > &patches) {
+	if ((cat >= _patches->size()) || (index >= (*_patches)[cat].size())) {
+		return;
+	}
+
+	wxVector< std::pair<int, int> > found;
+	const Entry &e = (*_patches)[cat][index];
+	for (int b = 0; b < e._bytes.size(); b++) {
+		patchesAt(e._bytes[b]._offset, e._bytes[b]._newBytes.size(), found);
+	}
+
+	std::sort(found.begin(), found.end());
+	for (int i = 0; i < found.size(); i++) {
+		if ((found[i] != std::make_pair(cat, index)) && ((i == 0) || (found[i] != found[i - 1]))) {
+			patches.push_back(found[i]);
+		}
+	}
+}
+
+/* A range that is all new bytes is applied, and all old bytes is not. If every range is one or
+ * the other the patch is only applied when all of them are, and anything else is mismatched
+ */
+int PatchStates::patchState(const Entry &e) {
+	int state = kPatchOn;
+	for (int b = 0; b < e._bytes.size(); b++) {
+		const PatchBytes &bytes = e._bytes[b];
+		int length = bytes._newBytes.size();
+		if (length == 0) {
+			continue;
+		}
+
+		if (_buffer.size() < length) {
+			_buffer.resize(length);
+		}
+
+		// The state is what is really in the rom, not what a preview is showing over it
+		if (_rom->readBuffer(bytes._offset, &_buffer[0], length) != length) {
+			return kPatchMixed;
+		}
+
+		if (memcmp(&_buffer[0], &bytes._newBytes[0], length) == 0) {
+			continue;
+		}
+
+		if ((bytes._oldBytes.size() == length) && (memcmp(&_buffer[0], &bytes._oldBytes[0], length) == 0)) {
+			state = kPatchOff;
+			continue;
+		}
+		return kPatchMixed;
+	}
+	return state;
+}
+
+int PatchStates::evaluate(int budget) {
+	int changed = 0;
+	while (!_queue.empty() && (budget > 0)) {
+		std::pair<int, int> next = *_queue.begin();
+		_queue.erase(_queue.begin());
+		budget--;
+
+		if ((next.first >= _patches->size()) || (next.second >= (*_patches)[next.first].size())) {
+			continue;
+		}
+
+		Entry &e = (*_patches)[next.first][next.second];
+		int state = patchState(e);
+		if (state != e._state) {
+			e._state = state;
+			changed++;
+		}
+	}
+	return changed;
+}
+
+void PatchStates::onRomWrite(int offset, int length) {
+	wxVector<int> ids;
+	_index.find(offset, offset + length, ids);
+	for (int i = 0; i < ids.size(); i++) {
+		_queue.insert(_list[ids[i]]);
+	}
+}
+
+void PatchStates::onRomResize(int offset, int change) {
+	// The offsets of the patches stay the same, but the bytes at them might not be, so everything after the change gets checked again
+	onRomWrite(offset, INT_MAX - offset);
+}
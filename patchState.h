@@ -0,0 +1,71 @@
+#ifndef HEXER_PATCHSTATE_H
+#define HEXER_PATCHSTATE_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <set>
+
+#include "rom.h"
+#include "entryTable.h"
+#include "intervalIndex.h"
+
+/* Hexer Patch States
+ * Works out whether each patch is applied, not applied, or neither, by comparing
+ * each of its ranges against the new and old bytes with memcmp. Patches are queued
+ * and evaluated a few at a time (from the frame's idle event), so loading a big
+ * patch file doesn't wait on it. The state is kept in the entry until a write
+ * touches one of its ranges, which queues just the patches over that write again.
+ * Every range is also kept in an interval index, which is how patches that write
+ * to the same bytes as each other are found, and how the hex view knows what is patched.
+ * Adding, editing or removing a patch only changes the ranges of that patch, and only
+ * that patch and the ones its ranges overlap have their state or conflicts checked again.
+ */
+class PatchStates : public RomListener {
+public:
+	PatchStates(Rom *rom, wxVector< wxVector<Entry> > *patches);
+	~PatchStates();
+
+	void rebuild();								// Indexes every range and queues every patch, for when the patches are loaded
+
+	// These keep the states matching the patches. A patch is added after it is put in its category, and removed before it is taken out
+	void add(int cat, int index);
+	void update(int cat, int index);
+	void remove(int cat, int index);
+	 int evaluate(int budget);					// Evaluates up to budget queued patches, returns how many changed state
+	bool pending() { return !_queue.empty(); }
+
+	int patchState(const Entry &e);				// Compares every range of a patch against the rom right now
+
+	// (category, index) of every patch that writes to any of [offset, offset + length)
+	void patchesAt(int offset, int length, wxVector< std::pair<int, int> > &patches);
+	// And of every other patch that writes to the same bytes as a patch
+	void conflictsWith(int cat, int index, wxVector< std::pair<int, int> > &patches);
+	 int conflicts() { return _conflicts; }		// How many patches conflict with at least one other
+
+	IntervalIndex *index() { return &_index; }
+
+	void onRomWrite(int offset, int length) wxOVERRIDE;
+	void onRomResize(int offset, int change) wxOVERRIDE;
+
+private:
+	Rom *_rom;
+	wxVector< wxVector<Entry> > *_patches;
+
+	IntervalIndex _index;						// Every range of every patch, with the position of the patch in _list as its id
+	wxVector< std::pair<int, int> > _list;		// (category, index) of every patch, or (-1, -1) for a patch that was removed
+	int _conflicts = 0;
+	std::set< std::pair<int, int> > _queue;		// (category, index) of each patch that needs evaluating
+	wxVector<wxByte> _buffer;
+
+	 int idOf(int cat, int index);
+	void indexRanges(int id, std::set<int> &touched);	// Also adds every patch that overlaps the ranges to touched
+	void unindexRanges(int id, std::set<int> &touched);
+	void checkConflict(int id);
+};
+
+#endif
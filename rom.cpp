@@ -1,29 +1,161 @@
 #include "rom.h"
 
+#include <wx/filefn.h>
+#include <algorithm>
+
 Rom::Rom(wxString path) {
 	_rom = new wxFile(path, wxFile::read_write);
+	_dataBuffer = nullptr;
+	_path = path;
 	
 	if (_rom->IsOpened()) {
-		_dataBuffer = (wxByte *) malloc(_rom->Length());
-		_rom->Read(_dataBuffer, _rom->Length());
+		_size = _rom->Length();
+		_dataBuffer = (wxByte *) malloc(_size);
+		_rom->Read(_dataBuffer, _size);
 
 	} else {
 		wxLogError("File could not be opened!");
 	}
 
+	// The rom starts out as one piece, which is all of the data buffer
+	if (_size > 0) {
+		RomPiece piece;
+		piece._length = _size;
+		_pieces.push_back(piece);
+	}
+	updatePieceStarts();
+
 	wxFileName name(path);
 	_name = name.GetName();
 }
 
+/* The rom is written to a new file which is then renamed over it, so stopping part way through
+ * never leaves a rom that is only half written (and a wxFile can't be made shorter anyway)
+ */
 void Rom::saveToRom() {
-	_rom->Seek(0);
-	_rom->Write(_dataBuffer, _rom->Length());
+	wxString tmp = _path + ".tmp";
+	wxFile file;
+	if (!file.Create(tmp, true)) {
+		wxLogError("Could not create " + tmp + ", so the rom was not saved");
+		return;
+	}
+
+	bool written = true;
+	for (int i = 0; i < _pieces.size(); i++) {
+		written = written && (file.Write(pieceData(i), _pieces[i]._length) == _pieces[i]._length);
+	}
+	written = file.Flush() && written;
+	file.Close();
+
+	if (!written) {
+		wxRemoveFile(tmp);
+		wxLogError("Could not write all of " + tmp + ", so the rom was not saved");
+		return;
+	}
+
+	// The rom has to be let go of before anything can be renamed over it
+	_rom->Close();
+	bool renamed = wxRenameFile(tmp, _path, true);
+	_rom->Open(_path, wxFile::read_write);
+	if (!renamed) {
+		wxRemoveFile(tmp);
+		wxLogError("Could not replace " + _path + ", so the rom was not saved");
+		return;
+	}
+
+	// Now that the file matches, the pieces can be put back together so that reading is direct again
+	flatten();
 	std::cout << "data buffer written over the rom" << std::endl;
 }
 
+wxByte *Rom::pieceData(int index) {
+	RomPiece &piece = _pieces[index];
+	if (piece._added) {
+		return &_addBuffer[piece._start];
+	}
+	return &_dataBuffer[piece._start];
+}
+
+// Returns the index of the piece that has the byte at offset
+int Rom::findPiece(int offset) {
+	int low = 0;
+	int high = _pieces.size() - 1;
+	while (low < high) {
+		int mid = (low + high + 1) / 2;
+		if (_pieceStarts[mid] <= offset) {
+			low = mid;
+		} else {
+			high = mid - 1;
+		}
+	}
+	return low;
+}
+
+// Makes sure a piece starts at offset, and returns its index (or the number of pieces if offset is the end of the rom)
+int Rom::splitAt(int offset) {
+	if (offset >= _size) {
+		return _pieces.size();
+	}
+
+	int index = findPiece(offset);
+	int inside = offset - _pieceStarts[index];
+	if (inside == 0) {
+		return index;
+	}
+
+	RomPiece second = _pieces[index];
+	second._start += inside;
+	second._length -= inside;
+	_pieces[index]._length = inside;
+
+	_pieces.insert(_pieces.begin() + index + 1, second);
+	_pieceStarts.insert(_pieceStarts.begin() + index + 1, offset);
+	return index + 1;
+}
+
+void Rom::updatePieceStarts() {
+	_pieceStarts.resize(_pieces.size());
+	int offset = 0;
+	for (int i = 0; i < _pieces.size(); i++) {
+		_pieceStarts[i] = offset;
+		offset += _pieces[i]._length;
+	}
+	_size = offset;
+	_flat = (_pieces.size() == 1) && !_pieces[0]._added && (_pieces[0]._start == 0);
+}
+
+void Rom::flatten() {
+	if (_flat || (_size == 0)) {
+		return;
+	}
+
+	wxByte *buffer = (wxByte *) malloc(_size);
+	readBuffer(0, buffer, _size);
+
+	free(_dataBuffer);
+	_dataBuffer = buffer;
+	_addBuffer.clear();
+
+	_pieces.clear();
+	RomPiece piece;
+	piece._length = _size;
+	_pieces.push_back(piece);
+	updatePieceStarts();
+}
+
 wxByte Rom::getByte(int offset) {
-	if (offset < _rom->Length()) {
-		return _dataBuffer[offset];
+	if ((offset >= 0) && (offset < _size)) {
+		wxByte byte;
+		if ((_preview != nullptr) && _preview->byteAt(offset, byte)) {
+			return byte;
+		}
+
+		if (_flat) {
+			return _dataBuffer[offset];
+		}
+
+		int index = findPiece(offset);
+		return pieceData(index)[offset - _pieceStarts[index]];
 
 	} else {
 		std::cout << "invalid offset! Can't access offset, returning 0xFF instead " << offset << std::endl;
@@ -31,25 +163,213 @@ wxByte Rom::getByte(int offset) {
 	}
 }
 
+int Rom::readBytes(int offset, wxByte *dest, int length) {
+	length = readBuffer(offset, dest, length);
+	if ((_preview != nullptr) && (length > 0)) {
+		_preview->apply(offset, dest, length);
+	}
+	return length;
+}
+
+int Rom::readBuffer(int offset, wxByte *dest, int length) {
+	if ((offset < 0) || (offset >= _size) || (length <= 0)) {
+		return 0;
+	}
+
+	// Anything past the end of the rom just doesn't get copied
+	if ((offset + length) > _size) {
+		length = _size - offset;
+	}
+
+	if (_flat) {
+		memcpy(dest, _dataBuffer + offset, length);
+		return length;
+	}
+
+	// Otherwise we copy from each piece in turn
+	int index = findPiece(offset);
+	int copied = 0;
+	while (copied < length) {
+		int inside = (offset + copied) - _pieceStarts[index];
+		int amount = _pieces[index]._length - inside;
+		if (amount > (length - copied)) {
+			amount = length - copied;
+		}
+		memcpy(dest + copied, pieceData(index) + inside, amount);
+		copied += amount;
+		index++;
+	}
+	return length;
+}
+
 void Rom::setByte(int offset, wxByte byte) {
-	if (offset >= _rom->Length()) {
+	if ((offset < 0) || (offset >= _size)) {
 		std::cout << "invalid offset! Can't access offset " << offset << std::endl;
 		return;
 	}
 
-	_dataBuffer[offset] = byte;
+	if (_flat) {
+		_dataBuffer[offset] = byte;
+
+	} else {
+		int index = findPiece(offset);
+		pieceData(index)[offset - _pieceStarts[index]] = byte;
+	}
+	_generation++;
+	notifyWrite(offset, 1);
 }
 
 void Rom::setBytes(int offset, wxVector<wxByte> bytes) {
-	if ((offset + bytes.size()) >= _rom->Length()) {
+	if ((offset < 0) || ((offset + bytes.size()) > _size)) {
 				std::cout << "invalid offset! Can't access offset and/or number of bytes " << offset << std::endl;
 
 		return;
 	}
 
-	for (int i = 0; i < bytes.size(); i++) {
-		_dataBuffer[offset + i] = bytes[i];
+	if (bytes.empty()) {
+		return;
 	}
+
+	writeAt(offset, &bytes[0], bytes.size());
+	_generation++;
+	notifyWrite(offset, bytes.size());
+}
+
+/* Every write is done before any listener hears about it, and writes that touch each other
+ * are given to the listeners as one write, so anything built from the rom is only updated
+ * once for a whole set of patches instead of once per range. The writes are done in the order
+ * they were given, so where any of them overlap, the last one given is what ends up in the rom.
+ * A write that doesn't fit in the rom is skipped, and its index is added to rejected.
+ */
+bool Rom::writeBatch(const wxVector<RomWrite> &writes, wxVector<int> *rejected) {
+	wxVector< std::pair<int, int> > ranges;		// [start, end) of each write
+	bool all = true;
+	for (int i = 0; i < writes.size(); i++) {
+		int offset = writes[i]._offset;
+		int length = writes[i]._bytes.size();
+		if ((offset < 0) || ((offset + length) > _size)) {
+			std::cout << "invalid offset! Can't access offset and/or number of bytes " << offset << std::endl;
+			if (rejected != nullptr) {
+				rejected->push_back(i);
+			}
+			all = false;
+			continue;
+		}
+
+		if (length == 0) {
+			continue;
+		}
+
+		writeAt(offset, &writes[i]._bytes[0], length);
+		ranges.push_back(std::make_pair(offset, offset + length));
+	}
+
+	if (ranges.empty()) {
+		return all;
+	}
+
+	// Only the listeners need the writes in offset order, to join the ones that touch into runs
+	std::sort(ranges.begin(), ranges.end());
+	wxVector< std::pair<int, int> > runs;
+	for (int i = 0; i < ranges.size(); i++) {
+		if (!runs.empty() && (ranges[i].first <= runs.back().second)) {
+			runs.back().second = std::max(runs.back().second, ranges[i].second);
+
+		} else {
+			runs.push_back(ranges[i]);
+		}
+	}
+
+	_generation++;
+	for (int i = 0; i < runs.size(); i++) {
+		notifyWrite(runs[i].first, runs[i].second - runs[i].first);
+	}
+	return all;
+}
+
+// Writing over bytes doesn't change the pieces, so the bytes are written straight into whichever buffer they are in
+void Rom::writeAt(int offset, const wxByte *bytes, int length) {
+	int index = findPiece(offset);
+	int written = 0;
+	while (written < length) {
+		int inside = (offset + written) - _pieceStarts[index];
+		int amount = _pieces[index]._length - inside;
+		if (amount > (length - written)) {
+			amount = length - written;
+		}
+		memcpy(pieceData(index) + inside, bytes + written, amount);
+		written += amount;
+		index++;
+	}
+}
+
+bool Rom::insertBytes(int offset, wxVector<wxByte> bytes) {
+	if ((offset < 0) || (offset > _size) || bytes.empty()) {
+		std::cout << "invalid offset! Can't insert at offset " << offset << std::endl;
+		return false;
+	}
+
+	// The preview is laid over offsets that are about to move, so it goes away instead
+	discardPreview();
+
+	int index = splitAt(offset);
+
+	// If this is right after the last bytes that were inserted (like when typing), that piece just gets longer
+	if ((index > 0) && _pieces[index - 1]._added && ((_pieces[index - 1]._start + _pieces[index - 1]._length) == _addBuffer.size())) {
+		_pieces[index - 1]._length += bytes.size();
+
+	} else {
+		RomPiece piece;
+		piece._added = true;
+		piece._start = _addBuffer.size();
+		piece._length = bytes.size();
+		_pieces.insert(_pieces.begin() + index, piece);
+	}
+
+	_addBuffer.insert(_addBuffer.end(), bytes.begin(), bytes.end());
+	updatePieceStarts();
+
+	_generation++;
+	notifyResize(offset, bytes.size());
+	return true;
+}
+
+bool Rom::deleteBytes(int offset, int length) {
+	if ((offset < 0) || (length <= 0) || ((offset + length) > _size)) {
+		std::cout << "invalid offset! Can't delete offset and/or number of bytes " << offset << std::endl;
+		return false;
+	}
+
+	discardPreview();
+
+	int first = splitAt(offset);
+	int last = splitAt(offset + length);
+	_pieces.erase(_pieces.begin() + first, _pieces.begin() + last);
+	updatePieceStarts();
+
+	_generation++;
+	notifyResize(offset, -length);
+	return true;
+}
+
+bool Rom::expand(int size, wxByte filler) {
+	if (size <= _size) {
+		return false;
+	}
+	return insertBytes(_size, wxVector<wxByte>(size - _size, filler));
+}
+
+bool Rom::expandToPowerOfTwo(wxByte filler) {
+	// Roms are usually a power of two already, so expanding one means doubling it
+	long long size = 1;
+	while (size <= _size) {
+		size <<= 1;
+	}
+
+	if (size > INT_MAX) {
+		return false;
+	}
+	return expand(size, filler);
 }
 
 int Rom::searchByte(wxByte b) {
@@ -68,18 +388,73 @@ void Rom::mountUndoCodeRead() {
 	wxLogError(wxString("This is a great name for a function"));
 }
 
+// Anything built from the bytes under the preview has to be made again whenever it changes
+void Rom::notifyPreview() {
+	if (_preview == nullptr) {
+		return;
+	}
 
+	_generation++;
+	const std::map< int, wxVector<wxByte> > &runs = _preview->runs();
+	for (std::map< int, wxVector<wxByte> >::const_iterator run = runs.begin(); run != runs.end(); run++) {
+		notifyWrite(run->first, run->second.size());
+	}
+}
 
+void Rom::setPreview(RomOverlay *preview) {
+	notifyPreview();
+	delete _preview;
+	_preview = preview;
 
+	if ((_preview != nullptr) && _preview->empty()) {
+		delete _preview;
+		_preview = nullptr;
+	}
+	notifyPreview();
+}
 
+// The preview is taken away first, so that the writes are what the listeners see afterwards
+void Rom::commitPreview() {
+	if (_preview == nullptr) {
+		return;
+	}
 
+	RomOverlay *preview = _preview;
+	_preview = nullptr;
 
+	wxVector<RomWrite> writes;
+	const std::map< int, wxVector<wxByte> > &runs = preview->runs();
+	for (std::map< int, wxVector<wxByte> >::const_iterator run = runs.begin(); run != runs.end(); run++) {
+		RomWrite write;
+		write._offset = run->first;
+		write._bytes = run->second;
+		writes.push_back(write);
+	}
+	delete preview;
+	writeBatch(writes);
+}
 
+void Rom::addListener(RomListener *listener) {
+	_listeners.push_back(listener);
+}
 
+void Rom::removeListener(RomListener *listener) {
+	for (int i = 0; i < _listeners.size(); i++) {
+		if (_listeners[i] == listener) {
+			_listeners.erase(_listeners.begin() + i);
+			return;
+		}
+	}
+}
 
+void Rom::notifyWrite(int offset, int length) {
+	for (int i = 0; i < _listeners.size(); i++) {
+		_listeners[i]->onRomWrite(offset, length);
+	}
+}
 
-
-
-
-
-
+void Rom::notifyResize(int offset, int change) {
+	for (int i = 0; i < _listeners.size(); i++) {
+		_listeners[i]->onRomResize(offset, change);
+	}
+}
\ No newline at end of file
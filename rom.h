@@ -11,10 +11,44 @@
 #include <wx/vector.h>
 #include <wx/wfstream.h>
 #include <wx/filename.h>
+#include <climits>
+
+#include "romOverlay.h"
+
+/* Anything that keeps information built from the rom data
+ * (like an index of free space) can listen for writes to the
+ * buffer, so that it only has to update the part that changed
+ */
+class RomListener {
+public:
+	virtual ~RomListener() {}
+	virtual void onRomWrite(int offset, int length) = 0;
+	virtual void onRomResize(int offset, int change) = 0;	// Bytes were inserted (change > 0) or deleted (change < 0) at offset
+};
+
+/* A piece of the rom, which is a run of bytes from
+ * either the original data buffer or the add buffer
+ */
+struct RomPiece {
+	bool _added = false;					// Whether the bytes are in the add buffer instead of the data buffer
+	int _start = 0;							// Where the bytes start in that buffer
+	int _length = 0;
+};
+
+/* One write in a batch of writes to the rom,
+ * which are sorted by where they go
+ */
+struct RomWrite {
+	int _offset = 0;
+	wxVector<wxByte> _bytes;
+};
 
 /* Hexer Rom handler
  * This class handles the actual I/O
- * for the rom being edited
+ * for the rom being edited.
+ * The rom is a piece table, so that bytes can be inserted and deleted
+ * without moving everything after them. Until that happens, the rom is
+ * a single piece of the data buffer and is read from it directly.
  */
 class Rom {
 public:
@@ -24,14 +58,53 @@ public:
 	wxFile *_rom;							// The Rom itself
 	wxByte *_dataBuffer;					// A mutable buffer of the rom data
 	wxString _name;							// The name of the rom file
+	wxString _path;							// And where it is
+	unsigned int _generation = 0;			// Goes up by one every time the buffer is written to
 
 	void saveToRom();						// Replaces the rom contents with the dataBuffer contents, ie. Applies the changes
+	   int size() { return _size; }			// The current size of the rom, which can be different from the file
 	wxByte getByte(int offset);				// Gets a single byte from the rom at offset
+	   int readBytes(int offset, wxByte *dest, int length);	// Copies up to length bytes at offset into dest, returns the number copied
+	   int readBuffer(int offset, wxByte *dest, int length);	// The same, but without the preview over it
 	void setByte(int offset, wxByte byte);	// Sets the byte at offset in the buffer to byte
 	void setBytes(int offset, wxVector<wxByte> bytes);	// Sets the bytes at offset in the buffer to bytes
+	bool writeBatch(const wxVector<RomWrite> &writes, wxVector<int> *rejected = nullptr);	// Does every write in order, and only then tells the listeners. False if any didn't fit
+	bool insertBytes(int offset, wxVector<wxByte> bytes);	// Inserts bytes before offset (or at the end if offset is the size)
+	bool deleteBytes(int offset, int length);	// Removes length bytes starting at offset
+	bool expand(int size, wxByte filler);	// Pads the end of the rom with filler up to size
+	bool expandToPowerOfTwo(wxByte filler);	// Pads the end of the rom up to the next power of two
 	 int searchByte(wxByte);				// Search for a single byte, returns -1 if not found, offset if found
 	 int searchBytes(wxVector<wxByte>);		// Search for an array of bytes, returns -1 if not found, offset if found
 	void mountUndoCodeRead();
+
+	// Reads go through the preview, but nothing in it is written until it is committed
+	RomOverlay *preview() { return _preview; }
+	void setPreview(RomOverlay *preview);	// The rom owns the preview from then on
+	void commitPreview();
+	void discardPreview() { setPreview(nullptr); }
+	void addListener(RomListener *listener);
+	void removeListener(RomListener *listener);
+
+private:
+	int _size = 0;
+	bool _flat = true;						// True while the rom is just the data buffer, as it was loaded
+	wxVector<wxByte> _addBuffer;			// Every inserted byte, in the order they were inserted
+	wxVector<RomPiece> _pieces;
+	wxVector<int> _pieceStarts;				// The offset in the rom of each piece
+
+	RomOverlay *_preview = nullptr;
+
+	wxVector<RomListener *> _listeners;
+	void notifyPreview();
+	void notifyWrite(int offset, int length);
+	void notifyResize(int offset, int change);
+
+	wxByte *pieceData(int index);
+	  void writeAt(int offset, const wxByte *bytes, int length);
+	   int findPiece(int offset);
+	   int splitAt(int offset);
+	  void updatePieceStarts();
+	  void flatten();
 };
 
 #endif
\ No newline at end of file
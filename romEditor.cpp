@@ -32,6 +32,13 @@ int RomEditorTable::GetNumberRows() {
 	}
 }
 
+int RomEditorTable::gfxDepth() {
+	if (_gfxType->GetSelection() == kGfxTypeRGB) {
+		return _gfxRGBFormat->GetSelection();
+	}
+	return _gfxCtrl->GetValue();
+}
+
 /* Whenever any cell is shown or
  * selected, a value must be returned from the table
  */
@@ -108,16 +115,23 @@ wxString RomEditorTable::GetValue(int row, int col) {
 				return "><";
 			}
 
-			// Otherwise we want to grab the first byte, which will be used to get the string table equivalent
-			wxString byte = printByte(_rom->getByte(byteIndex));
+			// In stream mode every cell is a single byte, and the text comes from the decoded block it is in
+			if (_stringStream) {
+				return getStreamText(byteIndex);
+			}
 
-			// Then, we add another byte to the string for as many bytes as the string needs
-			for (int i = 1; i < _stringByteSize; i++) {
-				byte << printByte(_rom->getByte(byteIndex + i));
+			// Otherwise we want to grab the bytes of the character, which will be used to get the string table equivalent
+			wxByte key[4];
+			for (int i = 0; i < _stringByteSize; i++) {
+				key[i] = _rom->getByte(byteIndex + i);
 			}
 
-			// And finally we return the equivalent string from our string table dictionary
-			return _stringTable[byte];
+			// And finally we return the equivalent string from our string table
+			int entry = _stringTable.find(key, _stringByteSize);
+			if (entry == -1) {
+				return "";
+			}
+			return _stringTable.entry(entry)._text;
 
 		/*** Palettes ***
 		 */
@@ -132,50 +146,13 @@ wxString RomEditorTable::GetValue(int row, int col) {
 				return "><";
 			}
 
-			// And the bitdepth of the colour data
-			int bitDepth = _formatCtrl->GetValue();
-
-			// We need to extract the red/green/blue bits based on the bitdepth
-			int redBits   = bitDepth;
-			int greenBits = bitDepth;
-			int blueBits  = bitDepth;
-
+			// Palettes need to return a string representation of their colour (so you can copy/paste, etc.)
 			int red   = 0;
 			int green = 0;
 			int blue  = 0;
+			getPaletteColour(byteIndex, red, green, blue);
 
-			wxByte clrByte = 0;
-			wxByte bit = 0;
-
-			// Palettes need to return a string representation of their colour (so the colour picker can use it, you can copy/paste, etc.)
-			// So we need to extract the colour out of the bytes here
-			for (int i = 0; i < _palByteSize; i++) {
-				clrByte = _rom->getByte(byteIndex + i);
-
-				for (int b = 0; b < 8; b++) {
-					if (redBits > 0) {
-						bit = clrByte & 1;
-						bit <<= (bitDepth - redBits);
-						red |= bit;
-						redBits--;
-
-					} else if (greenBits > 0) {
-						bit = clrByte & 1;
-						bit <<= (bitDepth - greenBits);
-						green |= bit;
-						greenBits--;
-					
-					} else if (blueBits > 0) {
-						bit = clrByte & 1;
-						bit <<= (bitDepth - blueBits);
-						blue |= bit;
-						blueBits--;
-					}
-					clrByte >>= 1;	
-				}
-			}
-
-			// Return a string made of the colours delineated by spaces
+			// Return a string made of the colours delineated by commas
 			return printByte(red) + "," + printByte(green) + "," + printByte(blue);
 
 		/*** Graphics ***
@@ -209,6 +186,81 @@ wxString RomEditorTable::GetValue(int row, int col) {
 	}
 }
 
+/* Cells with any byte that a patch writes to get a different background, and so do cells in the preview
+ * and cells with a doc over them. Finding any of them is one lookup in an index, so it is cheap enough
+ * to do for every cell drawn
+ */
+wxGridCellAttr *RomEditorTable::GetAttr(int row, int col, wxGridCellAttr::wxAttrKind kind) {
+	wxGridCellAttr *attr = wxGridTableBase::GetAttr(row, col, kind);
+	if ((col == 0) || (_viewType == kViewTypeGfx)) {
+		return attr;
+	}
+
+	int byteWidth = 1;
+	if (_viewType == kViewTypeChars) {
+		byteWidth = _stringByteSize;
+
+	} else if (_viewType == kViewTypePal) {
+		byteWidth = _palByteSize;
+	}
+
+	// What the preview shows matters more than what a patch could write there
+	int offset = getOffset(row, col, _offset, byteWidth);
+	if (previewed(offset, byteWidth)) {
+		return highlight(attr, _previewAttr, wxColour(196, 224, 255));
+	}
+
+	if ((_patchIndex != nullptr) && _patchIndex->any(offset, offset + byteWidth)) {
+		return highlight(attr, _patchedAttr, wxColour(255, 236, 196));
+	}
+
+	if (documented(row, offset, byteWidth)) {
+		return highlight(attr, _docsAttr, wxColour(220, 240, 214));
+	}
+	return attr;
+}
+
+// Every cell of a row is drawn one after the other, so the docs over the whole row are looked up once for all of them
+bool RomEditorTable::documented(int row, int offset, int length) {
+	if (_docsMap == nullptr) {
+		return false;
+	}
+
+	int rowStart = getOffset(row, 1, _offset, length);
+	int rowEnd = rowStart + (16 * length);
+	if ((rowStart != _docsRowStart) || (rowEnd != _docsRowEnd) || (_docsMap->generation() != _docsGeneration)) {
+		_docsRowStart = rowStart;
+		_docsRowEnd = rowEnd;
+		_docsGeneration = _docsMap->generation();
+		_docsSpans.clear();
+		_docsMap->spans(rowStart, rowEnd, _docsSpans);
+	}
+
+	for (int i = 0; i < _docsSpans.size(); i++) {
+		if ((_docsSpans[i].first < (offset + length)) && (_docsSpans[i].second > offset)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Without a column attribute the same one can be given out every time, otherwise the colour goes on a copy of the column's
+wxGridCellAttr *RomEditorTable::highlight(wxGridCellAttr *attr, wxGridCellAttr *&shared, wxColour colour) {
+	if (attr == nullptr) {
+		if (shared == nullptr) {
+			shared = new wxGridCellAttr();
+			shared->SetBackgroundColour(colour);
+		}
+		shared->IncRef();
+		return shared;
+	}
+
+	wxGridCellAttr *copy = attr->Clone();
+	attr->DecRef();
+	copy->SetBackgroundColour(colour);
+	return copy;
+}
+
 void RomEditorTable::SetValue(int row, int col, const wxString &value) {
 	/* This needs to break up the selection data into multiple chunks and apply the data by calling this function recursively
 	 *
@@ -266,30 +318,17 @@ void RomEditorTable::SetValue(int row, int col, const wxString &value) {
 
 			// First check if we are at the start of a character, or if the data set ends before this square
 			if (!((byteIndex + _stringByteSize) > _size)) {
-				// For strings, we want to get the equivalent value,
-				wxString key = "";
-				int byte = -1;
+				// For strings, we want to get the table entry that is displayed as the input value
+				int entry = _stringTable.findText(value);
 
-				// so we start by looping through the string table looking for the input value
-				for (StringTable::iterator it = _stringTable.begin(); it != _stringTable.end(); ++it) {
-					// If the input string is one of the table entries, we set key to be that value
-					if (it->second.Cmp(value) == 0) {
-						key = it->first;
-					}
-				}
+				// If there is one, then we write it's key into the rom
+				if (entry != -1) {
+					int keyLength = _stringTable.entry(entry)._keyLength;
+					const wxByte *key = _stringTable.key(entry);
 
-				// If the key is not still empty, then we know it's a sequence of bytes from the table
-				if (key != "") {
-					for (int i = 0; i < _stringByteSize; i++) {
-						// For every byte of the string, we get the hexadecimal value (don't need 2X because we only grab 2 chars)
-						sscanf(key.Mid((i * 2), 2).c_str(), "%x", &byte);
-						
-						if (byte != -1) {
-							_rom->setByte(byteIndex + i, byte);						
-						
-						} else {
-							std::cout << "found a key, but it isn't a 2 digit hexadecimal value?!" << std::endl;
-							std::cout << byte << std::endl;
+					if (!((byteIndex + keyLength) > _size)) {
+						for (int i = 0; i < keyLength; i++) {
+							_rom->setByte(byteIndex + i, key[i]);
 						}
 					}
 				}
@@ -324,42 +363,11 @@ void RomEditorTable::SetValue(int row, int col, const wxString &value) {
 			sscanf(partsTokenizer.GetNextToken().c_str(), "%2x", &green);
 			sscanf(partsTokenizer.GetNextToken().c_str(), "%2x", &blue);
 
-			int bitDepthMax = _formatCtrl->GetValue() * 3;
-			int bitDepth = _formatCtrl->GetValue();
-			int bit = 0;
-
-			wxByte clrByte = 0;
-
-			// For every byte in the colour
-			for (int i = 0; i < _palByteSize; i++) {
-				clrByte = 0;
-
-				// For every bit in the byte
-				for (int b = 0; b < 8; b++) {
-					// If we're in the first third of the bits, it's red
-					if (bitDepthMax > (bitDepth * 2)) {
-						bit = (red & 1) << b;
-						red >>= 1;
-
-					// Second third is green
-					} else if (bitDepthMax > bitDepth) {
-						bit = (green & 1) << b;
-						green >>= 1;
-					
-					// Last third is blue
-					} else {
-						bit = (blue & 1) << b;
-						blue >>= 1;
-					}
-
-					// If we are still adding colour bits, we add the bit to the colour byte
-					if (bitDepthMax > 0) {
-						bitDepthMax--;
-						clrByte |= bit;
-					}
-				}
-				_rom->setByte(byteIndex + i, clrByte);
-			}
+			// The colour is packed into its bytes and written all at once
+			wxByte raw[3] = {(wxByte) red, (wxByte) green, (wxByte) blue};
+			wxVector<wxByte> clrBytes(_palByteSize, 0);
+			encodeColours(paletteFormat(), raw, 1, &clrBytes[0]);
+			_rom->setBytes(byteIndex, clrBytes);
 
 		} else if (_viewType == kViewTypeGfx) {
 			byteIndex = getOffset(row, col, _offset, _gfxByteSize);
@@ -385,104 +393,209 @@ void RomEditorTable::SetValue(int row, int col, const wxString &value) {
 	}
 }
 
-/* Render the data as graphics for any given cell
+/* In stream mode, the visible rom is decoded the same way a game would read it,
+ * one entry at a time using the longest key that matches. Since where an entry starts
+ * depends on everything before it, this has to be done a block at a time instead of per cell.
  */
-void RomEditorGfxRenderer::Draw(wxGrid& grid, wxGridCellAttr& attr, wxDC& dc, const wxRect& rect, int row, int col, bool isSelected) {
-	// We need the table of the grid first
-	RomEditorTable *table = (RomEditorTable *) grid.GetTable();
+wxString RomEditorTable::getStreamText(int offset) {
+	// Any write to the rom could change the decoding, so the blocks are only good for the generation they were made in
+	if (_textGeneration != _rom->_generation) {
+		_textBlocks.clear();
+		_textGeneration = _rom->_generation;
+	}
 
-	// If the cell is not the start of a tile, we want to use the string renderer to show the generic 'not part of the rom' symbol
-	if (grid.GetCellValue(row, col) == "><") {
-		wxGridCellStringRenderer::Draw(grid, attr, dc, rect, row, col, isSelected);
+	int start = offset - (offset % kTextBlockSize);
 
-	// If the cell is currently selected, just paint it the selection colour instead of drawing gfx
-	} else if (grid.IsThisEnabled() && isSelected && grid.HasFocus()) {
-		wxColour clr = grid.GetSelectionBackground();
-		dc.SetBackgroundMode( wxBRUSHSTYLE_SOLID );
-		dc.SetBrush(clr);
-		dc.SetPen( *wxTRANSPARENT_PEN );
-		dc.DrawRectangle(rect);
-
-	// If the cell is not selected, render the bytes as gfx
-	} else {
-		// First thing we need is the offset of the current cell
-		int offset = getOffset(row, col, table->_offset, table->_gfxByteSize);
+	std::map<int, TextBlock>::iterator it = _textBlocks.find(start);
+	if (it != _textBlocks.end()) {
+		return it->second._cells[offset - start];
+	}
 
-		// We need the bitdepth of the gfx
-		int bitDepth = table->_gfxCtrl->GetValue();
+	return decodeTextBlock(start)._cells[offset - start];
+}
 
-		// And the brightness for when we display them
-		int brightness = 8 - table->_gfxPalCtrl->GetValue();
+ColourFormat RomEditorTable::paletteFormat() {
+	return ColourFormat(_formatCtrl->GetValue(), _clrOrderCtrl->GetSelection());
+}
 
-		int gfxType = table->_gfxType->GetSelection();
+/* A whole row of colours is decoded at once, the first time any cell of it is drawn.
+ * Rows are thrown out when the rom is written to, or the colour format changes
+ */
+const PaletteRow &RomEditorTable::getPaletteRow(int start) {
+	ColourFormat format = paletteFormat();
+	if ((_paletteGeneration != _rom->_generation) || !(_paletteFormat == format) || (_paletteByteSize != _palByteSize)) {
+		_paletteRows.clear();
+		_paletteGeneration = _rom->_generation;
+		_paletteFormat = format;
+		_paletteByteSize = _palByteSize;
+	}
 
-		int yOffset = 0;
-		int byte = 0;
-		int nyble = 0;
-		int bit = 0;
-		int index = 0;
+	std::map<int, PaletteRow>::iterator it = _paletteRows.find(start);
+	if (it != _paletteRows.end()) {
+		return it->second;
+	}
 
-		wxImage *tile = new wxImage(8, 8, true);
+	// Just like text blocks, the row furthest from this one is thrown out if there are too many
+	if (_paletteRows.size() >= kPaletteRowLimit) {
+		std::map<int, PaletteRow>::iterator furthest = _paletteRows.begin();
+		std::map<int, PaletteRow>::iterator last = --_paletteRows.end();
+		if (abs(last->first - start) > abs(furthest->first - start)) {
+			furthest = last;
+		}
+		_paletteRows.erase(furthest);
+	}
 
-		// Planar gfx split the gfx data into separate bitplanes, each being a binary representation
-		if (gfxType == kGfxTypePlanar || gfxType == kGfxTypePlanarComp) {
+	PaletteRow &row = _paletteRows[start];
+	wxByte data[16 * 3];
+	int length = _rom->readBytes(start, data, 16 * _palByteSize);
 
-			int composite = (gfxType == kGfxTypePlanarComp) ? 2 : 1;
-			int yInc = 0;
-			int rowInc = 0;
-			// Handle odd numbered composite bitdepths here
+	row._count = length / _palByteSize;
+	decodeColours(format, data, row._count, row._raw);
+	shiftColours(format, row._raw, row._count, row._rgb);
+	return row;
+}
 
-			// the bits in a bitplane represent a tile in the same order you see the pixels
-			for (int y = 0; y < 8; y++) {
+bool RomEditorTable::getPaletteColour(int offset, int &red, int &green, int &blue) {
+	if ((offset < 0) || ((offset + _palByteSize) > _size)) {
+		return false;
+	}
 
-				// Which, counter intuitively, means they are stored from most to least significant
-				for (int x = 7; x >= 0; x--) {
+	wxByte data[3];
+	wxByte raw[3];
+	_rom->readBytes(offset, data, _palByteSize);
+	decodeColours(paletteFormat(), data, 1, raw);
+	red = raw[0];
+	green = raw[1];
+	blue = raw[2];
+	return true;
+}
 
-					index = 0;
+const TextBlock &RomEditorTable::decodeTextBlock(int start) {
+	// If we are about to go over the limit, we throw out whichever block is furthest from this one
+	if (_textBlocks.size() >= kTextBlockLimit) {
+		std::map<int, TextBlock>::iterator furthest = _textBlocks.begin();
+		std::map<int, TextBlock>::iterator last = --_textBlocks.end();
+		if (abs(last->first - start) > abs(furthest->first - start)) {
+			furthest = last;
+		}
+		_textBlocks.erase(furthest);
+	}
 
-					// For every pixel, we have anywhere from 1 to 8 bitplanes to combine
-					for (int bp = 0; bp < bitDepth; bp++) {
+	TextBlock &block = _textBlocks[start];
+	block._cells.assign(kTextBlockSize, "");
 
-						// And now where the magic happens
-						yInc = y * composite;
-						rowInc = (bp / composite) * (8 * composite);
-						yOffset = (bp & 1) * (composite - 1);
+	/* To know where the first entry in this block starts, we ideally continue from the block before it.
+	 * If we don't have that one, we start a little earlier than the block, which in practice
+	 * lines up with the real entries well before we get to the block itself.
+	 */
+	int pos = start - kTextBlockLookback;
+	std::map<int, TextBlock>::iterator prev = _textBlocks.find(start - kTextBlockSize);
+	if ((prev != _textBlocks.end()) && (prev->second._next >= start)) {
+		pos = prev->second._next;
+	}
+	if (pos < 0) {
+		pos = 0;
+	}
 
-						// With the 3 increment factors calculated, we can add them to byte offset and get the byte from the rom
-						byte = table->_rom->getByte(offset + yInc + rowInc + yOffset);
+	// We read everything we will need in one go, including enough for an entry that hangs off the end
+	int maxKey = (_stringTable.maxKeyLength() > 0) ? _stringTable.maxKeyLength() : 1;
+	int end = start + kTextBlockSize;
+	wxVector<wxByte> data((end - pos) + maxKey, 0);
+	int length = _rom->readBytes(pos, &data[0], data.size());
 
-						// Now we can extract the bit at the X position within the byte
-						bit = (byte & (1 << x)) >> x;
-						bit <<= bp;
+	int i = 0;
+	while ((pos + i) < end) {
+		if (i >= length) {
+			break;
+		}
 
-						// And add it to the index, which will be our pixel
-						index |= bit;
-					}
+		int entry = _stringTable.match(&data[i], length - i);
+		int size = 1;
+		if (entry != -1) {
+			size = _stringTable.entry(entry)._keyLength;
+		}
 
-					// Finally, the pixel is placed at x,y, and uses the pixel as an index to get a colour from the current palette
-					tile->SetRGB((7 - x), y, table->_gfxPalette[index].Red() << brightness, table->_gfxPalette[index].Green() << brightness, table->_gfxPalette[index].GetBlue() << brightness);
-				}
+		// Only the entries that start inside this block get a cell
+		if ((pos + i) >= start) {
+			if (entry != -1) {
+				block._cells[(pos + i) - start] = _stringTable.entry(entry)._text;
 			}
+		}
+		i += size;
+	}
 
-		} else if (gfxType == kGfxTypeLinear || gfxType == kGfxTypeLinearRev) {
-			for (int y = 0; y < 8; y++) {
-				for (int x = 7; x >= 0; x--) {
+	block._next = pos + i;
+	return block;
+}
 
-					// This is just, super complicated tbh
-					nyble = 2 - ((bitDepth - 1) / 4);
-					yOffset = (((x & 1) * 4) * (nyble - 1));
-					byte = table->_rom->getByte(offset + (((y * 8) + x) / nyble));
-					index = (byte & ((((int) pow(2, bitDepth) - 1) << ((8 / nyble) - bitDepth)) << yOffset)) >> yOffset;
+/* When bytes are inserted or deleted, the table takes the new size of the rom
+ * and tells the grid how many rows were added or taken away, so it doesn't have to be made again
+ */
+void RomEditorTable::onRomResize(int offset, int change) {
+	int oldRows = GetNumberRows();
+	_size = _rom->size();
+	int newRows = GetNumberRows();
+
+	// Every tile after the change is now made from different bytes
+	_tileCache.clear();
+	_gfxBackbuffer.clear();
+
+	wxGrid *grid = GetView();
+	if (grid == nullptr) {
+		return;
+	}
 
-					// And this time, we don't have to reverse the pixel drawing order
-					tile->SetRGB(x, y, table->_gfxPalette[index].Red() << brightness, table->_gfxPalette[index].Green() << brightness, table->_gfxPalette[index].GetBlue() << brightness);
-				}
-			}
-		}
-		wxBitmap *gfx = new wxBitmap(tile->Scale(rect.width, rect.height, wxIMAGE_QUALITY_NORMAL));
-		dc.DrawBitmap(*gfx, rect.x, rect.y, false);
+	if (newRows > oldRows) {
+		wxGridTableMessage message(this, wxGRIDTABLE_NOTIFY_ROWS_APPENDED, newRows - oldRows);
+		grid->ProcessTableMessage(message);
+
+	} else if (newRows < oldRows) {
+		wxGridTableMessage message(this, wxGRIDTABLE_NOTIFY_ROWS_DELETED, newRows, oldRows - newRows);
+		grid->ProcessTableMessage(message);
 	}
 
+	// Everything after the change has moved, so the whole grid needs to be redrawn either way
+	grid->ForceRefresh();
+}
+
+// Cells that draw over their whole background show that they are in the preview with an outline
+static void outlinePreview(wxDC &dc, const wxRect &rect) {
+	dc.SetBrush(*wxTRANSPARENT_BRUSH);
+	dc.SetPen(wxPen(wxColour(0, 120, 215), 2));
+	dc.DrawRectangle(rect.x + 1, rect.y + 1, rect.width - 1, rect.height - 1);
+}
+
+/* Render the data as graphics for any given cell
+ */
+void RomEditorGfxRenderer::Draw(wxGrid& grid, wxGridCellAttr& attr, wxDC& dc, const wxRect& rect, int row, int col, bool isSelected) {
+	// We need the table of the grid first
+	RomEditorTable *table = (RomEditorTable *) grid.GetTable();
+
+	// The offset of the cell tells us if it is part of the rom, without having to make the cell value
+	int offset = getOffset(row, col, table->_offset, table->_gfxByteSize);
+
+	// If the cell is not the start of a tile, we want to use the string renderer to show the generic 'not part of the rom' symbol
+	if ((offset + table->_gfxByteSize) > table->_size) {
+		wxGridCellStringRenderer::Draw(grid, attr, dc, rect, row, col, isSelected);
+
+	// If the cell is currently selected, just paint it the selection colour instead of drawing gfx
+	} else if (grid.IsThisEnabled() && isSelected && grid.HasFocus()) {
+		wxColour clr = grid.GetSelectionBackground();
+		dc.SetBackgroundMode( wxBRUSHSTYLE_SOLID );
+		dc.SetBrush(clr);
+		dc.SetPen( *wxTRANSPARENT_PEN );
+		dc.DrawRectangle(rect);
+
+	// If the cell is not selected, the tile is copied out of the backbuffer (which is only redrawn if it needs to be)
+	} else {
+		table->_gfxBackbuffer.prepare(grid, table);
+		table->_gfxBackbuffer.draw(dc, rect, row, col);
+
+		// The tile fills the cell, so a tile with bytes in the preview is outlined instead
+		if (table->previewed(offset, table->_gfxByteSize)) {
+			outlinePreview(dc, rect);
+		}
+	}
 }
 
 /* Render the data as a palette for any given cell
@@ -504,32 +617,17 @@ void RomEditorPalRenderer::Draw(wxGrid& grid, wxGridCellAttr& attr, wxDC& dc, co
 			// We need the table of the grid first
 			RomEditorTable *table = (RomEditorTable *) grid.GetTable();
 
-			if (grid.GetCellValue(row, col) == "><") {
+			// The colours of the whole row are decoded (and brightened to 24bit) together, so the cell just picks its own out
+			int start = getOffset(row, 1, table->_offset, table->_palByteSize);
+			const PaletteRow &colours = table->getPaletteRow(start);
+
+			if ((col - 1) >= colours._count) {
 				wxGridCellStringRenderer::Draw(grid, attr, dc, rect, row, col, isSelected);
 				return;
-			
-			} else {
-				// 'Brightness' is the number of bits that the colour value can be shifted higher within a 24bit colour, effectively making it brighter
-				int brightness = 8 - table->_formatCtrl->GetValue();
-
-				// The colour gets extracted from the bytes in the getValue method, so here we just need to extract from the string
-				wxStringTokenizer colourTokenizer(grid.GetCellValue(row, col), ",");
-
-				wxString inputRed   = colourTokenizer.GetNextToken();
-				wxString inputGreen = colourTokenizer.GetNextToken();
-				wxString inputBlue  = colourTokenizer.GetNextToken();
-
-				int red;
-				int green;
-				int blue;
-
-				sscanf(inputRed.c_str(),   "%2x", &red);
-				sscanf(inputGreen.c_str(), "%2x", &green);
-				sscanf(inputBlue.c_str(),  "%2x", &blue);
-
-				// Bit shift by the 'brightness' to fill out remaining bits to increase brightness
-				clr = wxColour(red << brightness, green << brightness, blue << brightness);
 			}
+
+			const wxByte *rgb = &colours._rgb[(col - 1) * 3];
+			clr = wxColour(rgb[0], rgb[1], rgb[2]);
 		}
 	
 	} else {
@@ -540,4 +638,10 @@ void RomEditorPalRenderer::Draw(wxGrid& grid, wxGridCellAttr& attr, wxDC& dc, co
 	dc.SetBrush(clr);
 	dc.SetPen( *wxTRANSPARENT_PEN );
 	dc.DrawRectangle(rect);
+
+	// The same goes for colours, which fill the cell
+	RomEditorTable *table = (RomEditorTable *) grid.GetTable();
+	if (!isSelected && table->previewed(getOffset(row, col, table->_offset, table->_palByteSize), table->_palByteSize)) {
+		outlinePreview(dc, rect);
+	}
 }
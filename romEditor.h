@@ -19,10 +19,16 @@
 #include "wx/generic/grideditors.h"
 #include <wx/spinctrl.h>
 #include <wx/tokenzr.h>
+#include <map>
 
 #include "rom.h"
-
-WX_DECLARE_STRING_HASH_MAP(wxString, StringTable);
+#include "colourFormat.h"
+#include "intervalIndex.h"
+#include "docsMap.h"
+#include "stringTable.h"
+#include "tileCache.h"
+#include "tilePrefetch.h"
+#include "gfxBackbuffer.h"
 
 enum ViewType {
 	kViewTypeBytes,
@@ -36,9 +42,41 @@ enum GfxType {
 	kGfxTypePlanarComp,
 	kGfxTypeLinear,
 	kGfxTypeLinearRev,
-	kGfxTypeRGB
+	kGfxTypeRGB,
+	kGfxTypePlanarRow					// Every plane of a row before the next row (Master System, Game Gear)
+};
+
+enum TextBlockSize {
+	kTextBlockSize     = 256,			// The number of bytes decoded together in stream mode
+	kTextBlockLookback = 64,			// How far back decoding starts when the previous block isn't known
+	kTextBlockLimit    = 64				// How many decoded blocks are kept around
+};
+
+enum PaletteRowSize {
+	kPaletteRowLimit = 256				// How many decoded rows of colours are kept around
 };
 
+/* One row of the palette view, decoded once for as long as the rom and format don't change.
+ * The raw channels are what the cells show as text, and the RGB is what gets drawn
+ */
+struct PaletteRow {
+	wxByte _raw[16 * 3];
+	wxByte _rgb[16 * 3];
+	int _count = 0;						// How many cells of the row are whole colours
+};
+
+/* A block of the rom decoded as a stream of table entries.
+ * Every byte of the block has a cell, which holds the text of the entry
+ * that starts on that byte, or nothing if the byte is part of an earlier entry
+ */
+struct TextBlock {
+	wxVector<wxString> _cells;
+	int _next = 0;						// Where the first entry that starts after the block begins
+};
+
+// The offset of the data in a cell, for a table starting at offset with byteWidth bytes per cell
+int getOffset(int row, int col, int offset, int byteWidth);
+
 class RomEditorGfxRenderer : public wxGridCellStringRenderer {
 public:
     virtual void Draw(wxGrid& grid, wxGridCellAttr& attr, wxDC& dc, const wxRect& rect, int row, int col, bool isSelected) wxOVERRIDE;
@@ -51,7 +89,7 @@ public:
 };
 
 
-class RomEditorTable : public wxGridTableBase {
+class RomEditorTable : public wxGridTableBase, public RomListener {
 public:
 	long _size;
 	int _offset = 0;
@@ -63,8 +101,29 @@ public:
 	int _gfxByteSize = 8;
 
 	StringTable _stringTable;
+	bool _stringStream = false;
+
+	// Stream mode decodes whole blocks at once, and keeps them until the rom or table changes
+	std::map<int, TextBlock> _textBlocks;
+	unsigned int _textGeneration = 0;
+	// Palette rows are decoded straight from the bytes, and kept until the rom or format changes
+	std::map<int, PaletteRow> _paletteRows;
+	unsigned int _paletteGeneration = 0;
+	ColourFormat _paletteFormat;
+	int _paletteByteSize = 0;
+
 	wxVector<wxColour> _indexedPalette;
 	wxVector<wxColour> _gfxPalette;
+	unsigned int _gfxPaletteId = 0;		// Goes up every time the gfx palette changes, so cached tiles know they are out of date
+
+	// Decoded tiles are kept until the bytes they came from are written to
+	TileCache _tileCache;
+
+	// Which are also filled ahead of where the view is scrolling (this has to come after the cache, so the threads stop first)
+	TilePrefetcher _prefetcher;
+
+	// And the visible tiles are drawn from one buffer
+	GfxBackbuffer _gfxBackbuffer;
 
 	double _fontSizeBytes = 0;
 	double _fontSizeChars = 0;
@@ -78,20 +137,50 @@ public:
 	wxSpinCtrl *_stringCtrl;
 
 	wxSpinCtrl *_formatCtrl;
+	  wxChoice *_clrOrderCtrl;
 	wxCheckBox *_clrIndexCheck;
 
 	wxSpinCtrl *_gfxCtrl;
 	wxSpinCtrl *_gfxPalCtrl;
 	  wxChoice *_gfxType;
+	  wxChoice *_gfxRGBFormat;
 
 	wxBitmap *_tileImage;				// Will be used later
 
 	Rom *_rom = nullptr;
 
+	// Bytes written by any patch are highlighted, if there are patches, and so are bytes in the preview
+	IntervalIndex *_patchIndex = nullptr;
+	wxGridCellAttr *_patchedAttr = nullptr;
+	wxGridCellAttr *_previewAttr = nullptr;
+
+	// As are bytes with a doc over them, which are found once for each row and kept until the row or docs change
+	DocsMap *_docsMap = nullptr;
+	wxGridCellAttr *_docsAttr = nullptr;
+	wxVector< std::pair<int, int> > _docsSpans;
+	int _docsRowStart = -1;
+	int _docsRowEnd = -1;
+	unsigned int _docsGeneration = 0;
+
 	RomEditorTable(long size, Rom *rom, int viewType) {
 		_rom = rom;
 		_size = size;
 		_viewType = viewType;
+		_prefetcher.setCache(&_tileCache);
+		_rom->addListener(this);
+	}
+
+	~RomEditorTable() {
+		_rom->removeListener(this);
+		if (_patchedAttr != nullptr) {
+			_patchedAttr->DecRef();
+		}
+		if (_previewAttr != nullptr) {
+			_previewAttr->DecRef();
+		}
+		if (_docsAttr != nullptr) {
+			_docsAttr->DecRef();
+		}
 	}
 
 	int GetNumberRows() wxOVERRIDE;
@@ -99,6 +188,32 @@ public:
 	wxString GetValue(int row, int col) wxOVERRIDE;
 	void SetValue(int row, int col, const wxString &value) wxOVERRIDE;
 	bool IsEmptyCell(int row, int col) wxOVERRIDE { return false; }
+	wxGridCellAttr *GetAttr(int row, int col, wxGridCellAttr::wxAttrKind kind) wxOVERRIDE;
+	wxGridCellAttr *highlight(wxGridCellAttr *attr, wxGridCellAttr *&shared, wxColour colour);
+
+	bool previewed(int offset, int length) { return (_rom->preview() != nullptr) && _rom->preview()->covers(offset, offset + length); }
+	bool documented(int row, int offset, int length);
+
+	// For RGB gfx the depth is which direct colour format is used, instead of the bits per pixel
+	int gfxDepth();
+
+	ColourFormat paletteFormat();		// The format of the palette view, from its controls
+	const PaletteRow &getPaletteRow(int start);
+	bool getPaletteColour(int offset, int &red, int &green, int &blue);	// The raw channels of the colour at an offset
+
+	wxString getStreamText(int offset);
+	const TextBlock &decodeTextBlock(int start);
+	void clearTextBlocks() { _textBlocks.clear(); }
+
+	/* A write only throws out the cached tiles and backbuffer rows made from those bytes (the grid
+	 * redraws itself), while inserting or deleting bytes changes the number of rows and moves every
+	 * tile after it, so the caches are cleared and the grid is told about the new rows
+	 */
+	void onRomWrite(int offset, int length) wxOVERRIDE {
+		_tileCache.invalidate(offset, length);
+		_gfxBackbuffer.invalidate(offset, length);
+	}
+	void onRomResize(int offset, int change) wxOVERRIDE;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "romOverlay.h"
+#include "mappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+void RomOverlay::clear() {
+	_runs.clear();
+	_first = 0;
+	_last = 0;
+}
+
+/* Any run the new bytes overlap is cut back to what is outside of them. A run that
+ * sticks out past the end of the new bytes keeps that part as a run of its own
+ */
+void RomOverlay::add(int offset, const wxVector<wxByte> &bytes) {
+	if ((offset < 0) || bytes.empty()) {
+		return;
+	}
+
+	int end = offset + bytes.size();
+	std::map< int, wxVector<wxByte> >::iterator run = _runs.lower_bound(offset);
+	if (run != _runs.begin()) {
+		std::map< int, wxVector<wxByte> >::iterator before = run;
+		before--;
+		int beforeEnd = before->first + before->second.size();
+		if (beforeEnd > offset) {
+			if (beforeEnd > end) {
+				_runs[end] = wxVector<wxByte>(before->second.begin() + (end - before->first), before->second.end());
+			}
+			before->second.resize(offset - before->first);
+		}
+	}
+
+	while ((run != _runs.end()) && (run->first < end)) {
+		int runEnd = run->first + run->second.size();
+		if (runEnd > end) {
+			_runs[end] = wxVector<wxByte>(run->second.begin() + (end - run->first), run->second.end());
+		}
+		_runs.erase(run++);
+	}
+	_runs[offset] = bytes;
+
+	_first = _runs.begin()->first;
+	_last = std::max(_last, end);
+}
+
+bool RomOverlay::covers(int start, int end) {
+	if (_runs.empty() || (end <= _first) || (start >= _last)) {
+		return false;
+	}
+
+	// The last run starting before the end is the only one that can reach into the range
+	std::map< int, wxVector<wxByte> >::iterator run = _runs.lower_bound(end);
+	if (run == _runs.begin()) {
+		return false;
+	}
+	run--;
+	return (int) (run->first + run->second.size()) > start;
+}
+
+bool RomOverlay::byteAt(int offset, wxByte &byte) {
+	if (_runs.empty() || (offset < _first) || (offset >= _last)) {
+		return false;
+	}
+
+	std::map< int, wxVector<wxByte> >::iterator run = _runs.upper_bound(offset);
+	if (run == _runs.begin()) {
+		return false;
+	}
+	run--;
+	if (offset >= (int) (run->first + run->second.size())) {
+		return false;
+	}
+	byte = run->second[offset - run->first];
+	return true;
+}
+
+void RomOverlay::apply(int offset, wxByte *dest, int length) {
+	int end = offset + length;
+	if (_runs.empty() || (end <= _first) || (offset >= _last)) {
+		return;
+	}
+
+	// Starting from the run the read begins in (or the first one after it), each run is copied over the part of the read it covers
+	std::map< int, wxVector<wxByte> >::iterator run = _runs.upper_bound(offset);
+	if (run != _runs.begin()) {
+		run--;
+	}
+
+	for (; (run != _runs.end()) && (run->first < end); run++) {
+		int start = std::max(offset, run->first);
+		int stop = std::min(end, (int) (run->first + run->second.size()));
+		if (start < stop) {
+			memcpy(dest + (start - offset), &run->second[start - run->first], stop - start);
+		}
+	}
+}
+
+/* An IPS patch is 'PATCH', then records of a 3 byte offset and 2 byte length (both big endian)
+ * followed by that many bytes, until an offset of 'EOF'. A length of 0 is a run instead, with
+ * a 2 byte count and then the byte to repeat. Anything after the end marker is a size to cut
+ * the file down to, which is ignored here since the overlay doesn't change the size of the rom
+ */
+bool RomOverlay::loadIPS(wxString path, int romSize) {
+	_error = "";
+	_clipped = 0;
+
+	MappedFile file;
+	if (!file.open(path)) {
+		_error = "Could not open " + path;
+		return false;
+	}
+
+	const wxByte *data = file.data();
+	size_t size = file.size();
+	if ((size < 5) || (memcmp(data, "PATCH", 5) != 0)) {
+		_error = "Not an IPS patch";
+		return false;
+	}
+
+	size_t pos = 5;
+	wxVector<wxByte> bytes;
+	while (true) {
+		if ((pos + 3) > size) {
+			_error = "The patch ends before its EOF marker";
+			return false;
+		}
+
+		if (memcmp(&data[pos], "EOF", 3) == 0) {
+			break;
+		}
+
+		if ((pos + 5) > size) {
+			_error = "The patch ends in the middle of a record";
+			return false;
+		}
+
+		int offset = (data[pos] << 16) | (data[pos + 1] << 8) | data[pos + 2];
+		int length = (data[pos + 3] << 8) | data[pos + 4];
+		pos += 5;
+
+		if (length == 0) {
+			if ((pos + 3) > size) {
+				_error = "The patch ends in the middle of a record";
+				return false;
+			}
+			bytes.assign((data[pos] << 8) | data[pos + 1], data[pos + 2]);
+			pos += 3;
+
+		} else {
+			if ((pos + length) > size) {
+				_error = "The patch ends in the middle of a record";
+				return false;
+			}
+			bytes.assign(data + pos, data + pos + length);
+			pos += length;
+		}
+
+		// Anything past the end of the rom would need the rom to be expanded first
+		if ((offset + (int) bytes.size()) > romSize) {
+			int inside = std::max(0, romSize - offset);
+			_clipped += bytes.size() - inside;
+			bytes.resize(inside);
+		}
+		add(offset, bytes);
+	}
+	return true;
+}
@@ -0,0 +1,46 @@
+#ifndef HEXER_ROMOVERLAY_H
+#define HEXER_ROMOVERLAY_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+#include <map>
+
+/* Hexer Rom Overlay
+ * Bytes laid over the rom without being written to it, which is how patches are previewed.
+ * The overlay is an interval map of runs of bytes that never overlap each other, keyed by
+ * where they start, so anything added over an earlier run replaces just the part it covers.
+ * The rom copies the runs over whatever it reads, but only after checking that the read
+ * falls inside the overlay at all, so reading anywhere else costs the same as without one.
+ */
+class RomOverlay {
+public:
+	void clear();
+	void add(int offset, const wxVector<wxByte> &bytes);	// Goes over anything already in the overlay
+	bool loadIPS(wxString path, int romSize);				// Adds every record of an IPS patch, up to the end of the rom
+
+	bool empty() { return _runs.empty(); }
+	 int count() { return _runs.size(); }
+	 int clipped() { return _clipped; }						// How many bytes of the last IPS patch were past the end of the rom
+
+	bool covers(int start, int end);						// Whether any of [start, end) is in the overlay
+	bool byteAt(int offset, wxByte &byte);					// Gives the byte at offset if it is in the overlay
+	void apply(int offset, wxByte *dest, int length);		// Copies the overlay over length bytes read from offset into dest
+
+	const std::map< int, wxVector<wxByte> > &runs() { return _runs; }
+
+	wxString _error;										// Why the last patch couldn't be loaded
+
+private:
+	std::map< int, wxVector<wxByte> > _runs;
+	int _first = 0;											// The start of the first run and end of the last, so most reads are turned away right away
+	int _last = 0;
+	int _clipped = 0;
+};
+
+#endif
@@ -0,0 +1,483 @@
+#include "script.h"
+#include "mappedFile.h"
+
+#include <wx/tokenzr.h>
+#include <unordered_map>
+#include <algorithm>
+#include <string>
+
+enum ScriptValues {
+	kScriptChunk      = 4096,				// How much of the rom is read at a time when decoding
+	kScriptFlushSize  = 65536,				// How much text is built up before it is written to the file
+	kScriptMaxString  = 65536				// The longest a string can be before we assume it has no end code
+};
+
+// The layout line is always the same length, so it can be written once the string region is known
+static wxString printLayout(ScriptLayout &layout) {
+	if (layout._pointers) {
+		char sign = (layout._adjust < 0) ? '-' : '+';
+		long adjust = (layout._adjust < 0) ? -layout._adjust : layout._adjust;
+		return wxString::Format("#SCRIPT POINTERS $%08X %8d %d %c%08lX $%08X $%08X $%08X\n", layout._table, layout._count, layout._pointerSize, sign, adjust, layout._start, layout._end, layout._bankSize);
+	}
+	return wxString::Format("#SCRIPT RANGE $%08X $%08X\n", layout._start, layout._end);
+}
+
+static int readHex(wxString s) {
+	int value = 0;
+	if (s.StartsWith("$")) {
+		s = s.Mid(1);
+	}
+	sscanf(s.c_str(), "%x", &value);
+	return value;
+}
+
+// The offset in the rom that pointer i of the table points to
+static int pointerAt(const ScriptLayout &layout, const wxVector<wxByte> &pointers, int i) {
+	long value = 0;
+	for (int b = layout._pointerSize - 1; b >= 0; b--) {
+		value = (value << 8) | pointers[(i * layout._pointerSize) + b];
+	}
+	return value + layout._adjust;
+}
+
+bool Script::readLayout(wxString line, ScriptLayout &layout) {
+	wxStringTokenizer tokenizer(line, " ");
+	if (tokenizer.GetNextToken() != "#SCRIPT") {
+		return false;
+	}
+
+	wxString type = tokenizer.GetNextToken();
+	if (type == "POINTERS") {
+		if (tokenizer.CountTokens() < 6) {
+			return false;
+		}
+		layout._pointers = true;
+		layout._table = readHex(tokenizer.GetNextToken());
+		layout._count = wxAtoi(tokenizer.GetNextToken());
+		layout._pointerSize = wxAtoi(tokenizer.GetNextToken());
+		tokenizer.GetNextToken().ToLong(&layout._adjust, 16);
+		layout._start = readHex(tokenizer.GetNextToken());
+		layout._end = readHex(tokenizer.GetNextToken());
+
+		// Scripts from before there was a bank size have no banks
+		layout._bankSize = tokenizer.HasMoreTokens() ? readHex(tokenizer.GetNextToken()) : 0;
+		return (layout._pointerSize >= 1) && (layout._pointerSize <= 4) && (layout._bankSize >= 0);
+
+	} else if (type == "RANGE") {
+		if (tokenizer.CountTokens() < 2) {
+			return false;
+		}
+		layout._pointers = false;
+		layout._start = readHex(tokenizer.GetNextToken());
+		layout._end = readHex(tokenizer.GetNextToken());
+		return true;
+	}
+	return false;
+}
+
+/* Decodes the string at offset, stopping after the end code or at limit,
+ * and returns the offset just after the string
+ */
+int Script::decodeString(int offset, int limit, wxString &out) {
+	int maxKey = (_table->maxKeyLength() > 0) ? _table->maxKeyLength() : 1;
+	wxVector<wxByte> data(kScriptChunk + maxKey);
+
+	int pos = offset;
+	while (pos < limit) {
+		int want = ((limit - pos) < (int) data.size()) ? (limit - pos) : data.size();
+		int length = _rom->readBytes(pos, &data[0], want);
+		if (length <= 0) {
+			break;
+		}
+
+		// An entry can hang off the end of the chunk, so unless this is the last of the data we leave room for the longest key
+		int stop = (length == (int) data.size()) ? kScriptChunk : length;
+
+		int i = 0;
+		while (i < stop) {
+			int entry = _table->match(&data[i], length - i);
+			if (entry == -1) {
+				out << wxString::Format("<$%02X>", data[i]);
+				i++;
+				continue;
+			}
+
+			const TableEntry &e = _table->entry(entry);
+			i += e._keyLength;
+
+			if (e._type == kTableEntryEnd) {
+				return pos + i;
+			}
+
+			out << e._text;
+			if (e._type == kTableEntryLine) {
+				out << "\n";
+			}
+		}
+		pos += i;
+	}
+	return pos;
+}
+
+int Script::dump(ScriptLayout layout, wxString path) {
+	if (_table->endEntry() == -1) {
+		_error = "The string table has no end of string code (/XX)";
+		return -1;
+	}
+
+	wxFFile file(path, "wb");
+	if (!file.IsOpened()) {
+		_error = "Could not create the script file";
+		return -1;
+	}
+
+	int romSize = _rom->size();
+	int count = 0;
+
+	// The layout line goes first, but for pointers we don't know the region until every string is read, so it gets rewritten at the end
+	file.Write(printLayout(layout), wxConvUTF8);
+
+	wxString buffer;
+	if (layout._pointers) {
+		// We read the whole pointer table in one go
+		wxVector<wxByte> pointers(layout._count * layout._pointerSize, 0);
+		if (!pointers.empty()) {
+			_rom->readBytes(layout._table, &pointers[0], pointers.size());
+		}
+
+		layout._start = romSize;
+		layout._end = 0;
+
+		for (int i = 0; i < layout._count; i++) {
+			int offset = pointerAt(layout, pointers, i);
+			buffer << wxString::Format("#STRING %d $%06X\n", i, offset);
+
+			if ((offset >= 0) && (offset < romSize)) {
+				int limit = ((offset + kScriptMaxString) < romSize) ? (offset + kScriptMaxString) : romSize;
+				int end = decodeString(offset, limit, buffer);
+				buffer << "\n";
+
+				if (offset < layout._start) {
+					layout._start = offset;
+				}
+				if (end > layout._end) {
+					layout._end = end;
+				}
+			}
+			count++;
+
+			if (buffer.Len() > kScriptFlushSize) {
+				file.Write(buffer, wxConvUTF8);
+				buffer.clear();
+			}
+		}
+
+		if (layout._start > layout._end) {
+			layout._start = layout._end;
+		}
+
+	} else {
+		// For a range, each string simply starts where the last one ended
+		int end = (layout._end < romSize) ? layout._end : romSize;
+		int pos = layout._start;
+		while (pos < end) {
+			buffer << wxString::Format("#STRING %d $%06X\n", count, pos);
+			pos = decodeString(pos, end, buffer);
+			buffer << "\n";
+			count++;
+
+			if (buffer.Len() > kScriptFlushSize) {
+				file.Write(buffer, wxConvUTF8);
+				buffer.clear();
+			}
+		}
+	}
+
+	file.Write(buffer, wxConvUTF8);
+
+	// And now that the region is known, the layout line can be filled in
+	file.Seek(0);
+	file.Write(printLayout(layout), wxConvUTF8);
+	file.Close();
+	return count;
+}
+
+/* Reads the pointer table, and finds the bytes the strings it points to take up right now.
+ * Those are the only bytes that are known to be strings, so anything between them (other tables,
+ * code, or padding) is left alone. Pointers outside of the rom get an offset of -1
+ */
+void Script::findStrings(const ScriptLayout &layout, wxVector<wxByte> &pointers, wxVector<int> &offsets, wxVector< std::pair<int, int> > &spans) {
+	int romSize = _rom->size();
+	pointers.assign(layout._count * layout._pointerSize, 0);
+	if (!pointers.empty()) {
+		_rom->readBytes(layout._table, &pointers[0], pointers.size());
+	}
+
+	wxVector< std::pair<int, int> > strings;
+	offsets.assign(layout._count, -1);
+	for (int i = 0; i < layout._count; i++) {
+		int offset = pointerAt(layout, pointers, i);
+		if ((offset < 0) || (offset >= romSize)) {
+			continue;
+		}
+		offsets[i] = offset;
+
+		wxString text;
+		int limit = ((offset + kScriptMaxString) < romSize) ? (offset + kScriptMaxString) : romSize;
+		strings.push_back(std::make_pair(offset, decodeString(offset, limit, text)));
+	}
+
+	// Strings that overlap or touch (like ones that share an ending) are all one span
+	std::sort(strings.begin(), strings.end());
+	spans.clear();
+	for (int i = 0; i < strings.size(); i++) {
+		if (!spans.empty() && (strings[i].first <= spans.back().second)) {
+			if (strings[i].second > spans.back().second) {
+				spans.back().second = strings[i].second;
+			}
+		} else {
+			spans.push_back(strings[i]);
+		}
+	}
+}
+
+int Script::insert(wxString path) {
+	if (_table->endEntry() == -1) {
+		_error = "The string table has no end of string code (/XX)";
+		return -1;
+	}
+
+	MappedFile file;
+	if (!file.open(path)) {
+		_error = "Could not open the script file";
+		return -1;
+	}
+
+	const char *data = (const char *) file.data();
+	size_t size = file.size();
+	size_t pos = 0;
+
+	ScriptLayout layout;
+	bool hasLayout = false;
+
+	wxVector<wxString> texts;
+	wxVector<int> indices;
+
+	// Each line is either a #SCRIPT or #STRING line, or text that belongs to the last #STRING
+	while (pos < size) {
+		size_t lineStart = pos;
+		while ((pos < size) && (data[pos] != '\n')) {
+			pos++;
+		}
+		size_t lineEnd = pos;
+		pos++;
+
+		if ((lineEnd > lineStart) && (data[lineEnd - 1] == '\r')) {
+			lineEnd--;
+		}
+
+		size_t length = lineEnd - lineStart;
+		if ((length >= 8) && (strncmp(&data[lineStart], "#SCRIPT ", 8) == 0)) {
+			hasLayout = readLayout(wxString::FromUTF8(&data[lineStart], length), layout);
+			if (!hasLayout) {
+				_error = "The #SCRIPT line of the script is not valid";
+				return -1;
+			}
+
+		} else if ((length >= 8) && (strncmp(&data[lineStart], "#STRING ", 8) == 0)) {
+			texts.push_back("");
+			indices.push_back(atoi(&data[lineStart + 8]));
+
+		} else if (!texts.empty()) {
+			texts.back() << wxString::FromUTF8(&data[lineStart], length);
+		}
+	}
+
+	if (!hasLayout) {
+		_error = "The script has no #SCRIPT line";
+		return -1;
+	}
+
+	// Every string gets encoded with the end code on the end
+	const wxByte *endKey = _table->key(_table->endEntry());
+	int endLength = _table->entry(_table->endEntry())._keyLength;
+
+	wxVector< wxVector<wxByte> > encoded(texts.size());
+	int missing = 0;
+	for (int i = 0; i < texts.size(); i++) {
+		missing += _table->encode(texts[i], encoded[i]);
+		encoded[i].insert(encoded[i].end(), endKey, endKey + endLength);
+	}
+
+	if (missing > 0) {
+		_error = wxString::Format("%d characters in the script have no entry in the string table", missing);
+		return -1;
+	}
+
+	/* For pointers, the strings are put back in pointer order into the bytes the old strings took up,
+	 * and every pointer that pointed into the rom needs a string. The others are left as they are.
+	 * For a range, the strings simply go one after another from the start of it
+	 */
+	wxVector<int> order;
+	wxVector<int> offsets;
+	wxVector<wxByte> pointers;
+	wxVector< std::pair<int, int> > spans;
+	if (layout._pointers) {
+		findStrings(layout, pointers, offsets, spans);
+
+		order.assign(layout._count, -1);
+		for (int i = 0; i < indices.size(); i++) {
+			if ((indices[i] >= 0) && (indices[i] < layout._count)) {
+				order[indices[i]] = i;
+			}
+		}
+		for (int i = 0; i < order.size(); i++) {
+			if (offsets[i] == -1) {
+				order[i] = -1;
+
+			} else if (order[i] == -1) {
+				_error = wxString::Format("The script is missing string %d", i);
+				return -1;
+			}
+		}
+
+	} else {
+		if ((layout._end < layout._start) || (layout._end > _rom->size())) {
+			_error = "The region of the script is not inside the rom";
+			return -1;
+		}
+		spans.push_back(std::make_pair(layout._start, layout._end));
+
+		for (int i = 0; i < texts.size(); i++) {
+			order.push_back(i);
+		}
+		offsets.assign(order.size(), 0);
+	}
+
+	// Each span is filled in on top of what is already there, so whatever is left over at the end of one stays the same
+	int regionSize = 0;
+	wxVector< wxVector<wxByte> > regions(spans.size());
+	wxVector<int> used(spans.size(), 0);
+	for (int s = 0; s < spans.size(); s++) {
+		regions[s].resize(spans[s].second - spans[s].first);
+		if (!regions[s].empty()) {
+			_rom->readBytes(spans[s].first, &regions[s][0], regions[s].size());
+		}
+		regionSize += regions[s].size();
+	}
+
+	/* Now the strings get packed one after another, each into the first span with room for it.
+	 * Strings that are exactly the same are only written once, and share a pointer.
+	 */
+	std::unordered_map<std::string, int> packed;
+	wxVector<int> overflow;
+	int needed = 0;
+	int open = 0;
+
+	for (int i = 0; i < order.size(); i++) {
+		if (order[i] == -1) {
+			continue;
+		}
+
+		wxVector<wxByte> &bytes = encoded[order[i]];
+		std::string key((const char *) &bytes[0], bytes.size());
+
+		std::unordered_map<std::string, int>::iterator it = packed.find(key);
+		if (layout._pointers && (it != packed.end())) {
+			offsets[i] = it->second;
+			continue;
+		}
+
+		needed += bytes.size();
+		int s = open;
+		while ((s < spans.size()) && ((used[s] + (int) bytes.size()) > (int) regions[s].size())) {
+			s++;
+		}
+
+		if (s < spans.size()) {
+			memcpy(&regions[s][used[s]], &bytes[0], bytes.size());
+			offsets[i] = spans[s].first + used[s];
+			packed[key] = offsets[i];
+			used[s] += bytes.size();
+
+			while ((open < spans.size()) && (used[open] == (int) regions[open].size())) {
+				open++;
+			}
+
+		} else {
+			overflow.push_back(i);
+		}
+	}
+
+	/* Strings that didn't fit can only be moved somewhere else if they have a pointer to change,
+	 * and the new place has to be somewhere the pointer can actually reach
+	 */
+	if (!overflow.empty() && (!layout._pointers || (_freeSpace == nullptr))) {
+		_error = wxString::Format("The script is %d bytes larger than the space it came from", needed - regionSize);
+		return -1;
+	}
+
+	int low = (layout._adjust > 0) ? layout._adjust : 0;
+	int high = INT_MAX;
+	if (layout._pointerSize < 4) {
+		long reach = layout._adjust + (1L << (layout._pointerSize * 8));
+		high = (reach < INT_MAX) ? reach : INT_MAX;
+	}
+
+	wxVector<int> moved;
+	for (int i = 0; i < overflow.size(); i++) {
+		wxVector<wxByte> &bytes = encoded[order[overflow[i]]];
+		std::string key((const char *) &bytes[0], bytes.size());
+
+		// A string that was already moved might be the same as this one
+		std::unordered_map<std::string, int>::iterator it = packed.find(key);
+		if (it != packed.end()) {
+			offsets[overflow[i]] = it->second;
+			continue;
+		}
+
+		int offset = 0;
+		if (!_freeSpace->allocate(bytes.size(), layout._bankSize, offset, low, high)) {
+			for (int m = 0; m < moved.size(); m++) {
+				_freeSpace->release(offsets[moved[m]], encoded[order[moved[m]]].size());
+			}
+			_error = wxString::Format("The script is %d bytes larger than the space it came from, and there is not enough free space for the rest", needed - regionSize);
+			return -1;
+		}
+
+		offsets[overflow[i]] = offset;
+		packed[key] = offset;
+		moved.push_back(overflow[i]);
+	}
+
+	/* Everything is ready, so the strings and then the pointers are each written in one go (other than strings that were moved).
+	 * The moved strings go first, while the free space index still has their space reserved
+	 */
+	for (int m = 0; m < moved.size(); m++) {
+		_rom->setBytes(offsets[moved[m]], encoded[order[moved[m]]]);
+	}
+
+	for (int s = 0; s < spans.size(); s++) {
+		if (!regions[s].empty()) {
+			_rom->setBytes(spans[s].first, regions[s]);
+		}
+	}
+
+	if (layout._pointers) {
+		for (int i = 0; i < layout._count; i++) {
+			if (order[i] == -1) {
+				continue;
+			}
+
+			long value = offsets[i] - layout._adjust;
+			for (int b = 0; b < layout._pointerSize; b++) {
+				pointers[(i * layout._pointerSize) + b] = (value >> (b * 8)) & 0xFF;
+			}
+		}
+		if (!pointers.empty()) {
+			_rom->setBytes(layout._table, pointers);
+		}
+	}
+
+	return order.size();
+}
@@ -0,0 +1,68 @@
+#ifndef HEXER_SCRIPT_H
+#define HEXER_SCRIPT_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+#include <wx/ffile.h>
+
+#include "rom.h"
+#include "stringTable.h"
+#include "freeSpace.h"
+
+/* Where the strings of a script live in the rom.
+ * Either a table of pointers to the strings, or a range
+ * of the rom that is just one string after another
+ */
+struct ScriptLayout {
+	bool _pointers = true;
+	int  _table = 0;						// Offset of the pointer table
+	int  _count = 0;						// Number of pointers in the table
+	int  _pointerSize = 2;					// Bytes per pointer (little endian)
+	long _adjust = 0;						// Added to a pointer to get the offset of the string in the rom
+	int  _bankSize = 0;						// A moved string can't cross a multiple of this in the rom (0 if there are no banks)
+	int  _start = 0;						// The region of the rom that holds the strings
+	int  _end = 0;
+};
+
+/* Hexer Script
+ * Dumps the strings of the rom to a script file using the string table,
+ * and inserts an edited script back in. A script looks like:
+ *
+ * #SCRIPT POINTERS $table count size adjust $start $end $bank	(or #SCRIPT RANGE $start $end)
+ * #STRING 0 $offset
+ * text of the string, where line break codes are followed by a newline
+ * #STRING 1 $offset
+ * ...
+ *
+ * The end code of each string is left out, and bytes with no table entry are written as <$XX>
+ */
+class Script {
+public:
+	Script(Rom *rom, StringTable *table, FreeSpaceIndex *freeSpace = nullptr) {
+		_rom = rom;
+		_table = table;
+		_freeSpace = freeSpace;
+	}
+
+	int dump(ScriptLayout layout, wxString path);	// Writes the script, returns the number of strings or -1
+	int insert(wxString path);						// Encodes and writes the script into the rom, returns the number of strings or -1
+
+	wxString _error;								// Why the last dump or insert failed
+
+private:
+	Rom *_rom;
+	StringTable *_table;
+	FreeSpaceIndex *_freeSpace;					// If there is one, strings that don't fit in their region are moved into free space
+
+	int decodeString(int offset, int limit, wxString &out);
+	void findStrings(const ScriptLayout &layout, wxVector<wxByte> &pointers, wxVector<int> &offsets, wxVector< std::pair<int, int> > &spans);
+	bool readLayout(wxString line, ScriptLayout &layout);
+};
+
+#endif
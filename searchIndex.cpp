@@ -0,0 +1,368 @@
+#include "searchIndex.h"
+
+#include <algorithm>
+#include <cwctype>
+
+static std::wstring lowered(const wxString &s) {
+	return s.Lower().ToStdWstring();
+}
+
+static wxUint64 trigram(const std::wstring &s, size_t i) {
+	return ((wxUint64) s[i] << 42) | ((wxUint64) s[i + 1] << 21) | (wxUint64) s[i + 2];
+}
+
+// The ids going into these are always sorted, since new docs are only ever added to the end
+static void intersect(wxVector<int> &ids, const wxVector<int> &other) {
+	wxVector<int> both;
+	std::set_intersection(ids.begin(), ids.end(), other.begin(), other.end(), std::back_inserter(both));
+	ids.swap(both);
+}
+
+SearchIndex::SearchIndex() {
+	for (int b = 0; b < kSearchBooks; b++) {
+		_built[b] = false;
+	}
+}
+
+void SearchIndex::invalidate(int book) {
+	for (int c = 0; c < _slots[book].size(); c++) {
+		for (int i = 0; i < _slots[book][c].size(); i++) {
+			kill(_slots[book][c][i]);
+		}
+	}
+	_slots[book].clear();
+	_cats[book].clear();
+	_built[book] = false;
+	compact();
+}
+
+void SearchIndex::build(int book, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries) {
+	invalidate(book);
+
+	for (int c = 0; c < cats.size(); c++) {
+		_cats[book].push_back(lowered(cats[c]));
+	}
+	_slots[book].resize(cats.size());
+
+	for (int c = 0; (c < entries.size()) && (c < cats.size()); c++) {
+		for (int i = 0; i < entries[c].size(); i++) {
+			_slots[book][c].push_back(insert(book, c, i, entries[c][i]));
+		}
+	}
+	_built[book] = true;
+}
+
+int SearchIndex::insert(int book, int cat, int index, const Entry &e) {
+	SearchDoc doc;
+	doc._book = book;
+	doc._cat = cat;
+	doc._index = index;
+	doc._live = true;
+	doc._fields[kFieldName] = lowered(e._name);
+	doc._fields[kFieldAddr] = lowered(e._addr);
+	doc._fields[kFieldType] = lowered(e._type);
+	doc._fields[kFieldDesc] = lowered(e._desc);
+	_docs.push_back(doc);
+
+	indexDoc(_docs.size() - 1);
+	return _docs.size() - 1;
+}
+
+static const int weights[kSearchFields] = { kWeightName, kWeightAddr, kWeightType, kWeightDesc };
+
+// A word counts for more at the start of a field, and if it is in more than one field, only the best one counts
+static int weighWord(const std::wstring *fields, const std::wstring &word) {
+	int best = 0;
+	for (int f = 0; f < kSearchFields; f++) {
+		size_t at = fields[f].find(word);
+		if (at != std::wstring::npos) {
+			best = std::max(best, (at == 0) ? (weights[f] * 2) : weights[f]);
+		}
+	}
+	return best;
+}
+
+// Sorts hits by doc (they usually already are), keeping just the best hit for each
+static void mergeHits(wxVector<SearchHit> &hits) {
+	if (!std::is_sorted(hits.begin(), hits.end())) {
+		std::sort(hits.begin(), hits.end());
+	}
+	int kept = 0;
+	for (int i = 0; i < hits.size(); i++) {
+		if ((kept > 0) && (hits[kept - 1]._id == hits[i]._id)) {
+			hits[kept - 1]._weight = std::max(hits[kept - 1]._weight, hits[i]._weight);
+		} else {
+			hits[kept++] = hits[i];
+		}
+	}
+	hits.resize(kept);
+}
+
+// A run of three is only added once for each doc, and never across two fields
+void SearchIndex::indexDoc(int id) {
+	SearchDoc &doc = _docs[id];
+
+	wxVector<wxUint64> runs;
+	std::map<std::wstring, int> words;
+	for (int f = 0; f < kSearchFields; f++) {
+		const std::wstring &s = doc._fields[f];
+		for (size_t i = 0; (i + 2) < s.size(); i++) {
+			runs.push_back(trigram(s, i));
+		}
+
+		size_t start = 0;
+		while (start < s.size()) {
+			while ((start < s.size()) && !std::iswalnum(s[start])) {
+				start++;
+			}
+			size_t end = start;
+			while ((end < s.size()) && std::iswalnum(s[end])) {
+				end++;
+			}
+			if (end > start) {
+				int &weight = words[s.substr(start, end - start)];
+				weight = std::max(weight, (start == 0) ? (weights[f] * 2) : weights[f]);
+			}
+			start = end;
+		}
+	}
+
+	std::sort(runs.begin(), runs.end());
+	for (int i = 0; i < runs.size(); i++) {
+		if ((i == 0) || (runs[i] != runs[i - 1])) {
+			_trigrams[runs[i]].push_back(id);
+		}
+	}
+
+	for (std::map<std::wstring, int>::iterator it = words.begin(); it != words.end(); it++) {
+		SearchHit hit;
+		hit._id = id;
+		hit._weight = it->second;
+		_words[it->first].push_back(hit);
+	}
+}
+
+void SearchIndex::kill(int id) {
+	if (_docs[id]._live) {
+		_docs[id]._live = false;
+		_dead++;
+	}
+}
+
+// Only the docs still in use are kept, in the same order, so every list stays sorted
+void SearchIndex::compact() {
+	if ((_dead < kSearchCompact) || (_dead < (_docs.size() / 2))) {
+		return;
+	}
+
+	wxVector<SearchDoc> docs;
+	docs.swap(_docs);
+	_trigrams.clear();
+	_words.clear();
+	_dead = 0;
+
+	for (int i = 0; i < docs.size(); i++) {
+		if (docs[i]._live) {
+			_docs.push_back(docs[i]);
+			int id = _docs.size() - 1;
+			_slots[docs[i]._book][docs[i]._cat][docs[i]._index] = id;
+			indexDoc(id);
+		}
+	}
+}
+
+void SearchIndex::add(int book, int cat, const Entry &e) {
+	if (!_built[book] || (cat >= _slots[book].size())) {
+		return;
+	}
+	_slots[book][cat].push_back(insert(book, cat, _slots[book][cat].size(), e));
+}
+
+void SearchIndex::update(int book, int cat, int index, const Entry &e) {
+	if (!_built[book] || (cat >= _slots[book].size()) || (index >= _slots[book][cat].size())) {
+		return;
+	}
+	kill(_slots[book][cat][index]);
+	_slots[book][cat][index] = insert(book, cat, index, e);
+	compact();
+}
+
+void SearchIndex::remove(int book, int cat, int index) {
+	if (!_built[book] || (cat >= _slots[book].size()) || (index >= _slots[book][cat].size())) {
+		return;
+	}
+	kill(_slots[book][cat][index]);
+
+	// Everything after it in the category moves up one
+	wxVector<int> &slots = _slots[book][cat];
+	slots.erase(slots.begin() + index);
+	for (int i = index; i < slots.size(); i++) {
+		_docs[slots[i]]._index = i;
+	}
+	compact();
+}
+
+void SearchIndex::addCategory(int book, wxString name) {
+	if (_built[book]) {
+		_cats[book].push_back(lowered(name));
+		_slots[book].resize(_cats[book].size());
+	}
+}
+
+void SearchIndex::renameCategory(int book, int cat, wxString name) {
+	if (_built[book] && (cat < _cats[book].size())) {
+		_cats[book][cat] = lowered(name);
+	}
+}
+
+/* Every doc that has the word in it somewhere, or is in a category that does. Docs with a
+ * word that starts with it are found straight away, which leaves the runs of three for when
+ * it is in the middle of a word. Those lists only say a doc has each of the runs, not that
+ * they are next to each other, so anything they find is checked properly
+ */
+void SearchIndex::matchWord(const std::wstring &word, wxVector<SearchHit> &hits) {
+	std::map< std::wstring, wxVector<SearchHit> >::iterator it = _words.lower_bound(word);
+	for (; (it != _words.end()) && (it->first.compare(0, word.size(), word) == 0); it++) {
+		hits.insert(hits.end(), it->second.begin(), it->second.end());
+	}
+	mergeHits(hits);
+
+	if (word.size() >= 3) {
+		wxVector<const wxVector<int> *> lists;
+		for (size_t i = 0; (i + 2) < word.size(); i++) {
+			std::unordered_map< wxUint64, wxVector<int> >::iterator found = _trigrams.find(trigram(word, i));
+			if (found == _trigrams.end()) {
+				lists.clear();
+				break;
+			}
+			lists.push_back(&found->second);
+		}
+
+		if (!lists.empty()) {
+			// Starting with the shortest list keeps every step after it just as short
+			std::sort(lists.begin(), lists.end(), [](const wxVector<int> *a, const wxVector<int> *b) { return a->size() < b->size(); });
+			wxVector<int> candidates = *lists[0];
+			for (int l = 1; (l < lists.size()) && !candidates.empty(); l++) {
+				intersect(candidates, *lists[l]);
+			}
+
+			// Only the docs that weren't already found by a whole word need checking
+			wxVector<SearchHit> inside;
+			int h = 0;
+			for (int i = 0; i < candidates.size(); i++) {
+				while ((h < hits.size()) && (hits[h]._id < candidates[i])) {
+					h++;
+				}
+				if ((h < hits.size()) && (hits[h]._id == candidates[i])) {
+					continue;
+				}
+
+				const SearchDoc &doc = _docs[candidates[i]];
+				if (doc._live) {
+					SearchHit hit;
+					hit._id = candidates[i];
+					hit._weight = weighWord(doc._fields, word);
+					if (hit._weight > 0) {
+						inside.push_back(hit);
+					}
+				}
+			}
+			hits.insert(hits.end(), inside.begin(), inside.end());
+		}
+	}
+
+	// There aren't many categories, so they are just gone through one by one
+	for (int b = 0; b < kSearchBooks; b++) {
+		for (int c = 0; c < _cats[b].size(); c++) {
+			size_t at = _cats[b][c].find(word);
+			if (at == std::wstring::npos) {
+				continue;
+			}
+
+			SearchHit hit;
+			hit._weight = (at == 0) ? (kWeightCategory * 2) : kWeightCategory;
+			for (int i = 0; i < _slots[b][c].size(); i++) {
+				hit._id = _slots[b][c][i];
+				hits.push_back(hit);
+			}
+		}
+	}
+
+	mergeHits(hits);
+}
+
+void SearchIndex::find(wxString query, int limit, wxVector<SearchResult> &results) {
+	std::wstring lower = lowered(query.Strip(wxString::both));
+
+	wxVector<std::wstring> words;
+	size_t start = 0;
+	while (start < lower.size()) {
+		size_t end = lower.find(L' ', start);
+		if (end == std::wstring::npos) {
+			end = lower.size();
+		}
+		if (end > start) {
+			words.push_back(lower.substr(start, end - start));
+		}
+		start = end + 1;
+	}
+
+	if (words.empty()) {
+		return;
+	}
+
+	// Every word has to be in the entry somewhere, and the score is what each of them counts for added up
+	wxVector<SearchHit> hits;
+	matchWord(words[0], hits);
+	for (int w = 1; (w < words.size()) && !hits.empty(); w++) {
+		wxVector<SearchHit> more;
+		matchWord(words[w], more);
+
+		int kept = 0;
+		int m = 0;
+		for (int i = 0; i < hits.size(); i++) {
+			while ((m < more.size()) && (more[m]._id < hits[i]._id)) {
+				m++;
+			}
+			if ((m < more.size()) && (more[m]._id == hits[i]._id)) {
+				hits[kept] = hits[i];
+				hits[kept++]._weight += more[m]._weight;
+			}
+		}
+		hits.resize(kept);
+	}
+
+	wxVector<SearchResult> found;
+	for (int i = 0; i < hits.size(); i++) {
+		const SearchDoc &doc = _docs[hits[i]._id];
+		if (!doc._live) {
+			continue;
+		}
+
+		SearchResult result;
+		result._book = doc._book;
+		result._cat = doc._cat;
+		result._index = doc._index;
+		result._score = hits[i]._weight;
+		if (doc._fields[kFieldName] == lower) {
+			result._score += kWeightExact;
+		}
+		found.push_back(result);
+	}
+
+	// Best first, and otherwise in the order they are in the notebooks
+	limit = std::min(limit, (int) found.size());
+	std::partial_sort(found.begin(), found.begin() + limit, found.end(), [](const SearchResult &a, const SearchResult &b) {
+		if (a._score != b._score) {
+			return a._score > b._score;
+		}
+		if (a._book != b._book) {
+			return a._book < b._book;
+		}
+		if (a._cat != b._cat) {
+			return a._cat < b._cat;
+		}
+		return a._index < b._index;
+	});
+	results.insert(results.end(), found.begin(), found.begin() + limit);
+}
@@ -0,0 +1,113 @@
+#ifndef HEXER_SEARCHINDEX_H
+#define HEXER_SEARCHINDEX_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "entryTable.h"
+
+enum SearchBook {
+	kSearchPatches,
+	kSearchDocs,
+	kSearchBooks
+};
+
+enum SearchField {
+	kFieldName,
+	kFieldAddr,
+	kFieldType,
+	kFieldDesc,
+	kSearchFields
+};
+
+// How much a word found in each part of an entry counts for, which is doubled when the word is at the start of it
+enum SearchWeights {
+	kWeightName     = 8,
+	kWeightCategory = 4,
+	kWeightAddr     = 4,
+	kWeightType     = 2,
+	kWeightDesc     = 1,
+	kWeightExact    = 32,					// For a name that is the whole search
+	kSearchCompact  = 1024					// How many replaced or removed entries can build up before the index is made again
+};
+
+// A doc a word is in, and how much it counts for there
+struct SearchHit {
+	int _id;
+	int _weight;
+
+	bool operator<(const SearchHit &other) const { return _id < other._id; }
+};
+
+struct SearchResult {
+	int _book;
+	int _cat;
+	int _index;
+	int _score;
+};
+
+/* Hexer Search Index
+ * An inverted index over the names, addresses, types and descriptions of the patches and
+ * the docs, along with the names of their categories. Every run of three characters in an
+ * entry maps to the entries it is in, so a word of three or more characters is found by
+ * going through the shortest of those lists for its runs and checking just what is left.
+ * Each whole word in an entry also maps to the entries it is in (and how much it counts for
+ * in each), and those are kept sorted, so a word that is the start of others (like a search
+ * that is still being typed) is one range of them, which doesn't need checking at all.
+ * Changes are made one entry at a time, and a changed entry is added again rather than
+ * taken out of every list it was in, so the lists are only made again once enough of
+ * them have built up.
+ */
+class SearchIndex {
+public:
+	SearchIndex();
+
+	bool built(int book) { return _built[book]; }
+	void build(int book, wxVector<wxString> &cats, wxVector< wxVector<Entry> > &entries);	// Descriptions have to be read first
+	void invalidate(int book);				// For when the whole notebook is loaded again, it is built again when it is next searched
+
+	// These keep the index matching the notebook, and do nothing until it has been built
+	void add(int book, int cat, const Entry &e);
+	void update(int book, int cat, int index, const Entry &e);
+	void remove(int book, int cat, int index);
+	void addCategory(int book, wxString name);
+	void renameCategory(int book, int cat, wxString name);
+
+	// Every entry with all of the words of the query, best first, up to limit of them
+	void find(wxString query, int limit, wxVector<SearchResult> &results);
+
+private:
+	struct SearchDoc {
+		int _book;
+		int _cat;
+		int _index;
+		bool _live;
+		std::wstring _fields[kSearchFields];
+	};
+
+	wxVector<SearchDoc> _docs;
+	int _dead = 0;
+	bool _built[kSearchBooks];
+	wxVector<std::wstring> _cats[kSearchBooks];
+	wxVector< wxVector<int> > _slots[kSearchBooks];				// The doc for each entry of each category
+	std::unordered_map< wxUint64, wxVector<int> > _trigrams;	// Every doc each run of three characters is in, in order
+	std::map< std::wstring, wxVector<SearchHit> > _words;		// Every doc each word is in, sorted so a prefix is one range
+
+	 int insert(int book, int cat, int index, const Entry &e);
+	void indexDoc(int id);
+	void kill(int id);
+	void compact();
+	void matchWord(const std::wstring &word, wxVector<SearchHit> &hits);
+};
+
+#endif
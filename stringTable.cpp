@@ -0,0 +1,318 @@
+#include "stringTable.h"
+#include "mappedFile.h"
+
+// Returns the value of a single hex digit, or -1 if it isn't one
+static int hexDigit(int c) {
+	if ((c >= '0') && (c <= '9')) {
+		return c - '0';
+	} else if ((c >= 'A') && (c <= 'F')) {
+		return c - 'A' + 10;
+	} else if ((c >= 'a') && (c <= 'f')) {
+		return c - 'a' + 10;
+	}
+	return -1;
+}
+
+StringTable::StringTable() {
+	clear();
+}
+
+void StringTable::clear() {
+	_entries.clear();
+	_keyPool.clear();
+	_children.clear();
+	_nodeSlots.clear();
+	_nodeEntry.clear();
+	_textIndex.clear();
+	_keyLengthCount.clear();
+	_maxKeyLength = 0;
+	_maxTextLength = 0;
+	_endEntry = -1;
+	_textLengths.clear();
+
+	// The root node always exists
+	newNode();
+}
+
+int StringTable::newNode() {
+	_nodeSlots.push_back(-1);
+	_nodeEntry.push_back(-1);
+	return _nodeEntry.size() - 1;
+}
+
+void StringTable::addEntry(const wxByte *key, int keyLength, wxString text, int type) {
+	// Walk down the trie, making any nodes that don't exist yet
+	int node = 0;
+	for (int i = 0; i < keyLength; i++) {
+		int next = child(node, key[i]);
+		if (next == 0) {
+			// The slots of a node are only made once it has a child
+			if (_nodeSlots[node] == -1) {
+				_nodeSlots[node] = _children.size();
+				_children.resize(_children.size() + 256, 0);
+			}
+			next = newNode();
+			_children[_nodeSlots[node] + key[i]] = next;
+		}
+		node = next;
+	}
+
+	// If the key is already in the table, the later line wins (just like the old hashmap did)
+	int index = _nodeEntry[node];
+	if (index == -1) {
+		TableEntry e;
+		e._keyStart = _keyPool.size();
+		e._keyLength = keyLength;
+		_keyPool.insert(_keyPool.end(), key, key + keyLength);
+
+		index = _entries.size();
+		_entries.push_back(e);
+		_nodeEntry[node] = index;
+
+		if (_keyLengthCount.size() <= keyLength) {
+			_keyLengthCount.resize(keyLength + 1, 0);
+		}
+		_keyLengthCount[keyLength]++;
+
+		if (keyLength > _maxKeyLength) {
+			_maxKeyLength = keyLength;
+		}
+	}
+
+	// A key that is given new text can't be found by its old text any more, unless another entry has that text too
+	wxString oldText = _entries[index]._text;
+	if ((oldText != text) && (findText(oldText) == index)) {
+		_textIndex.erase(oldText);
+		for (int i = 0; i < _entries.size(); i++) {
+			if ((i != index) && (_entries[i]._text == oldText)) {
+				_textIndex[oldText] = i;
+				break;
+			}
+		}
+	}
+
+	_entries[index]._text = text;
+	_entries[index]._type = type;
+
+	if ((type == kTableEntryEnd) && (_endEntry == -1)) {
+		_endEntry = index;
+	}
+
+	// The text index is only used for going from text back to bytes, so the first entry for any text is kept
+	if (_textIndex.find(text) == _textIndex.end()) {
+		_textIndex[text] = index;
+	}
+
+	if (text.Len() > _maxTextLength) {
+		_maxTextLength = text.Len();
+	}
+}
+
+bool StringTable::load(wxString path) {
+	MappedFile file;
+	if (!file.open(path)) {
+		return false;
+	}
+
+	clear();
+
+	const wxByte *data = file.data();
+	size_t size = file.size();
+	size_t pos = 0;
+
+	// Skip a UTF-8 byte order mark if the table has one
+	if ((size >= 3) && (data[0] == 0xEF) && (data[1] == 0xBB) && (data[2] == 0xBF)) {
+		pos = 3;
+	}
+
+	wxVector<wxByte> key;
+
+	// Every line is one of:   XXXX=text   /XX=text   *XX=text   (the =text being optional for the last two)
+	while (pos < size) {
+		// Find the end of the line, ignoring the \r of windows line endings
+		size_t lineStart = pos;
+		while ((pos < size) && (data[pos] != '\n')) {
+			pos++;
+		}
+		size_t lineEnd = pos;
+		pos++;
+
+		if ((lineEnd > lineStart) && (data[lineEnd - 1] == '\r')) {
+			lineEnd--;
+		}
+
+		if (lineEnd == lineStart) {
+			continue;
+		}
+
+		size_t c = lineStart;
+		int type = kTableEntryNormal;
+		if (data[c] == '/') {
+			type = kTableEntryEnd;
+			c++;
+
+		} else if (data[c] == '*') {
+			type = kTableEntryLine;
+			c++;
+		}
+
+		// The key is a string of hex digit pairs
+		key.clear();
+		bool valid = true;
+		while ((c < lineEnd) && (data[c] != '=')) {
+			int high = hexDigit(data[c]);
+			int low = ((c + 1) < lineEnd) ? hexDigit(data[c + 1]) : -1;
+			if ((high == -1) || (low == -1)) {
+				valid = false;
+				break;
+			}
+			key.push_back((high << 4) | low);
+			c += 2;
+		}
+
+		if (!valid || key.empty()) {
+			continue;
+		}
+
+		// Everything after the first = is the text, even if it is another =
+		wxString text = "";
+		if ((c < lineEnd) && (data[c] == '=')) {
+			c++;
+			const char *start = (const char *) &data[c];
+			size_t length = lineEnd - c;
+			text = wxString::FromUTF8(start, length);
+
+			// Not every table is UTF-8, so if it didn't decode we take the bytes as they are
+			if (text.IsEmpty() && (length > 0)) {
+				text = wxString(start, wxConvISO8859_1, length);
+			}
+
+		} else if (type == kTableEntryNormal) {
+			// A normal entry without any text is not an entry
+			continue;
+		}
+
+		if (text.Cmp("EQU") == 0) {
+			text = "=";
+		}
+
+		// Control codes still need something to show in the editor
+		if (text.IsEmpty()) {
+			text = (type == kTableEntryEnd) ? "[END]" : "[LINE]";
+		}
+
+		addEntry(&key[0], key.size(), text, type);
+	}
+
+	// Encoding only needs to try the text lengths that actually exist in the table
+	wxVector<bool> hasLength(_maxTextLength + 1, false);
+	for (int i = 0; i < _entries.size(); i++) {
+		hasLength[_entries[i]._text.Len()] = true;
+	}
+	for (int i = _maxTextLength; i > 0; i--) {
+		if (hasLength[i]) {
+			_textLengths.push_back(i);
+		}
+	}
+
+	return true;
+}
+
+int StringTable::find(const wxByte *key, int length) {
+	int node = 0;
+	for (int i = 0; i < length; i++) {
+		node = child(node, key[i]);
+		if (node == 0) {
+			return -1;
+		}
+	}
+	return _nodeEntry[node];
+}
+
+int StringTable::match(const wxByte *data, int length) {
+	// We keep walking for as long as the trie has a path, remembering the last node that was a full entry
+	int node = 0;
+	int found = -1;
+	for (int i = 0; i < length; i++) {
+		node = child(node, data[i]);
+		if (node == 0) {
+			break;
+		}
+		if (_nodeEntry[node] != -1) {
+			found = _nodeEntry[node];
+		}
+	}
+	return found;
+}
+
+int StringTable::findText(const wxString &text) {
+	StringTableTextIndex::iterator it = _textIndex.find(text);
+	if (it == _textIndex.end()) {
+		return -1;
+	}
+	return it->second;
+}
+
+int StringTable::encode(const wxString &text, wxVector<wxByte> &out) {
+	int missing = 0;
+	int i = 0;
+	int length = text.Len();
+
+	while (i < length) {
+		// Newlines in a script are only there to make it readable, the line break entries are what go in the rom
+		if ((text[i] == '\n') || (text[i] == '\r')) {
+			i++;
+			continue;
+		}
+
+		// Bytes that have no entry are written as <$XX>
+		if ((text[i] == '<') && ((i + 4) < length) && (text[i + 1] == '$') && (text[i + 4] == '>')) {
+			int high = hexDigit(text[i + 2].GetValue());
+			int low  = hexDigit(text[i + 3].GetValue());
+			if ((high != -1) && (low != -1)) {
+				out.push_back((high << 4) | low);
+				i += 5;
+				continue;
+			}
+		}
+
+		// Otherwise we look for the longest piece of text that has an entry
+		int found = -1;
+		int foundLength = 0;
+		for (int l = 0; l < _textLengths.size(); l++) {
+			if ((i + _textLengths[l]) > length) {
+				continue;
+			}
+
+			found = findText(text.Mid(i, _textLengths[l]));
+			if (found != -1) {
+				foundLength = _textLengths[l];
+				break;
+			}
+		}
+
+		if (found == -1) {
+			missing++;
+			i++;
+			continue;
+		}
+
+		const wxByte *k = key(found);
+		out.insert(out.end(), k, k + _entries[found]._keyLength);
+		i += foundLength;
+	}
+
+	return missing;
+}
+
+int StringTable::commonKeyLength() {
+	int common = 1;
+	int count = 0;
+	for (int i = 1; i < _keyLengthCount.size(); i++) {
+		if (_keyLengthCount[i] > count) {
+			count = _keyLengthCount[i];
+			common = i;
+		}
+	}
+	return common;
+}
@@ -0,0 +1,78 @@
+#ifndef HEXER_STRINGTABLE_H
+#define HEXER_STRINGTABLE_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+#include <wx/hashmap.h>
+
+WX_DECLARE_STRING_HASH_MAP(int, StringTableTextIndex);
+
+enum TableEntryType {
+	kTableEntryNormal,
+	kTableEntryEnd,							// '/' entries, which end a string
+	kTableEntryLine							// '*' entries, which break a line within a string
+};
+
+struct TableEntry {
+	wxString _text;							// What the bytes are displayed as
+	int _type = kTableEntryNormal;
+	int _keyStart = 0;						// Where the key bytes start in the key pool
+	int _keyLength = 0;						// And how many bytes the key has
+};
+
+/* Hexer String Table
+ * A character table (.tbl) loaded into a byte trie. Every node with
+ * children has a slot for each possible next byte, so finding the
+ * longest entry at any point in the rom is just a walk down the trie,
+ * and entries of any key length can live in the same table. Most nodes
+ * are the last byte of a key and have no children, so they get no slots.
+ */
+class StringTable {
+public:
+	StringTable();
+
+	bool load(wxString path);				// Loads a table file, returns false if it could not be read
+	void clear();
+
+	int size() { return _entries.size(); }
+	const TableEntry &entry(int index) { return _entries[index]; }
+	const wxByte *key(int index) { return &_keyPool[_entries[index]._keyStart]; }
+
+	int find(const wxByte *key, int length);		// The entry with exactly this key, or -1
+	int match(const wxByte *data, int length);		// The entry with the longest key at the start of data, or -1
+	int findText(const wxString &text);				// The entry displayed as text, or -1
+	int encode(const wxString &text, wxVector<wxByte> &out);	// Appends the keys for text to out, returns the number of characters with no entry
+	int endEntry() { return _endEntry; }			// The first end of string entry, or -1 if the table has none
+
+	int maxKeyLength() { return _maxKeyLength; }
+	int commonKeyLength();					// The key length used by the most entries
+	int maxTextLength() { return _maxTextLength; }
+
+private:
+	wxVector<TableEntry> _entries;
+	wxVector<wxByte> _keyPool;
+
+	// The trie is stored flat, 256 child slots for each node that has children, where 0 means there is no child (the root is never a child)
+	wxVector<int> _children;
+	wxVector<int> _nodeSlots;				// Where the slots of each node start in _children, or -1 if it has no children yet
+	wxVector<int> _nodeEntry;
+
+	StringTableTextIndex _textIndex;
+	wxVector<int> _keyLengthCount;
+	int _maxKeyLength = 0;
+	int _maxTextLength = 0;
+	int _endEntry = -1;
+	wxVector<int> _textLengths;				// Every length of text in the table, longest first
+
+	int newNode();
+	int child(int node, wxByte b) { return (_nodeSlots[node] == -1) ? 0 : _children[_nodeSlots[node] + b]; }
+	void addEntry(const wxByte *key, int keyLength, wxString text, int type);
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "tileCache.h"
+
+/* What one tile really costs, which is more than its entry. Each container it is in allocates
+ * a node for it, with the links that container needs (a list node has two, a hash node has the
+ * next node and the hash, and a tree node has a parent, two children and a colour), and the hash
+ * table has about one bucket for each tile
+ */
+enum TileCacheOverhead {
+	kTileEntryBytes = sizeof(TileCacheEntry) + (2 * sizeof(void *))
+					+ sizeof(std::pair<const TileKey, TileCacheIterator>) + sizeof(void *) + sizeof(size_t) + sizeof(void *)
+					+ sizeof(std::pair<const int, TileCacheIterator>) + (4 * sizeof(void *))
+};
+
+bool TileCache::find(const TileKey &key, unsigned char *rgb) {
+	wxCriticalSectionLocker locker(_lock);
+	std::unordered_map<TileKey, TileCacheIterator, TileKeyHash>::iterator it = _index.find(key);
+	if (it == _index.end()) {
+		return false;
+	}
+
+	// Using a tile moves it to the front, which doesn't invalidate any iterators
+	_entries.splice(_entries.begin(), _entries, it->second);
+	memcpy(rgb, it->second->_rgb, kTileRGBBytes);
+	return true;
+}
+
+bool TileCache::contains(const TileKey &key) {
+	wxCriticalSectionLocker locker(_lock);
+	return _index.find(key) != _index.end();
+}
+
+void TileCache::add(const TileKey &key, const unsigned char *rgb, int length) {
+	wxCriticalSectionLocker locker(_lock);
+	insert(key, rgb, length);
+}
+
+unsigned int TileCache::writes() {
+	wxCriticalSectionLocker locker(_lock);
+	return _writes;
+}
+
+void TileCache::addIfUnchanged(const TileKey &key, const unsigned char *rgb, int length, unsigned int writes) {
+	wxCriticalSectionLocker locker(_lock);
+	if (writes == _writes) {
+		insert(key, rgb, length);
+	}
+}
+
+int TileCache::size() {
+	wxCriticalSectionLocker locker(_lock);
+	return _entries.size();
+}
+
+long TileCache::memory() {
+	wxCriticalSectionLocker locker(_lock);
+	return _memory;
+}
+
+void TileCache::insert(const TileKey &key, const unsigned char *rgb, int length) {
+	std::unordered_map<TileKey, TileCacheIterator, TileKeyHash>::iterator it = _index.find(key);
+	if (it != _index.end()) {
+		remove(it->second);
+	}
+
+	// Make room for the new tile by throwing out the ones that haven't been used for the longest
+	while (!_entries.empty() && ((_memory + (long) kTileEntryBytes) > kTileCacheBudget)) {
+		TileCacheIterator last = _entries.end();
+		last--;
+		remove(last);
+	}
+
+	_entries.push_front(TileCacheEntry());
+	TileCacheIterator entry = _entries.begin();
+	entry->_key = key;
+	memcpy(entry->_rgb, rgb, kTileRGBBytes);
+	entry->_length = length;
+	entry->_byOffset = _byOffset.insert(std::make_pair(key._offset, entry));
+
+	_index[key] = entry;
+	_memory += kTileEntryBytes;
+}
+
+void TileCache::remove(TileCacheIterator entry) {
+	_index.erase(entry->_key);
+	_byOffset.erase(entry->_byOffset);
+	_memory -= kTileEntryBytes;
+	_entries.erase(entry);
+}
+
+void TileCache::invalidate(int offset, int length) {
+	wxCriticalSectionLocker locker(_lock);
+	_writes++;
+
+	// No tile is longer than the largest tile, so only tiles starting that far back can reach the write
+	std::multimap<int, TileCacheIterator>::iterator it = _byOffset.lower_bound(offset - kGfxMaxTileBytes + 1);
+	while ((it != _byOffset.end()) && (it->first < (offset + length))) {
+		TileCacheIterator entry = it->second;
+		it++;
+		if ((entry->_key._offset + entry->_length) > offset) {
+			remove(entry);
+		}
+	}
+}
+
+void TileCache::clear() {
+	wxCriticalSectionLocker locker(_lock);
+	_writes++;
+	_entries.clear();
+	_index.clear();
+	_byOffset.clear();
+	_memory = 0;
+}
@@ -0,0 +1,97 @@
+#ifndef HEXER_TILECACHE_H
+#define HEXER_TILECACHE_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/thread.h>
+
+#include <list>
+#include <map>
+#include <unordered_map>
+
+#include "gfxDecode.h"
+
+enum TileCacheSize {
+	kTileCacheBudget = 16 * 1024 * 1024,	// How many bytes the cache can use, counting what it takes to keep track of each tile
+	kTileRGBBytes    = kGfxTilePixels * 3	// Every tile is 8x8 pixels of RGB
+};
+
+// Everything that changes what a tile looks like
+struct TileKey {
+	int _offset = 0;
+	int _bitDepth = 0;
+	int _gfxType = 0;
+	unsigned int _palette = 0;				// The id of the palette, which changes every time a palette is loaded
+	int _brightness = 0;
+
+	bool operator==(const TileKey &other) const {
+		return (_offset == other._offset) && (_bitDepth == other._bitDepth) && (_gfxType == other._gfxType)
+			&& (_palette == other._palette) && (_brightness == other._brightness);
+	}
+};
+
+struct TileKeyHash {
+	size_t operator()(const TileKey &key) const {
+		size_t hash = key._offset;
+		hash = (hash * 31) + key._bitDepth;
+		hash = (hash * 31) + key._gfxType;
+		hash = (hash * 31) + key._palette;
+		hash = (hash * 31) + key._brightness;
+		return hash;
+	}
+};
+
+struct TileCacheEntry;
+typedef std::list<TileCacheEntry>::iterator TileCacheIterator;
+
+struct TileCacheEntry {
+	TileKey _key;
+	unsigned char _rgb[kTileRGBBytes];
+	int _length = 0;						// How many bytes of the rom the tile was made from
+	std::multimap<int, TileCacheIterator>::iterator _byOffset;
+};
+
+/* Hexer Tile Cache
+ * Keeps decoded tiles as RGB, ready to be copied into the gfx backbuffer, so that
+ * a tile that was shown recently doesn't have to be decoded again. The least recently
+ * used tiles are thrown out once the cache goes over the memory budget, and any tile
+ * made from bytes that get written to is thrown out straight away.
+ * Prefetch threads add tiles too, so everything is done under a lock, and tiles
+ * are copied out instead of handing out pointers that another thread could free.
+ */
+class TileCache {
+public:
+	bool find(const TileKey &key, unsigned char *rgb);	// Copies the RGB of the tile into rgb, returns false if it isn't cached
+	bool contains(const TileKey &key);
+	void add(const TileKey &key, const unsigned char *rgb, int length);
+
+	/* A tile decoded from bytes read before a write could be out of date, so a
+	 * thread that read the bytes at some point only adds the tile if nothing was written since
+	 */
+	unsigned int writes();
+	void addIfUnchanged(const TileKey &key, const unsigned char *rgb, int length, unsigned int writes);
+
+	void invalidate(int offset, int length);	// Throws out every tile made from any of these bytes
+	void clear();
+
+	int size();
+	long memory();
+
+private:
+	std::list<TileCacheEntry> _entries;			// Most recently used first
+	std::unordered_map<TileKey, TileCacheIterator, TileKeyHash> _index;
+	std::multimap<int, TileCacheIterator> _byOffset;
+	long _memory = 0;
+	unsigned int _writes = 0;
+	wxCriticalSection _lock;
+
+	void insert(const TileKey &key, const unsigned char *rgb, int length);
+	void remove(TileCacheIterator entry);
+};
+
+#endif
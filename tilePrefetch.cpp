@@ -0,0 +1,163 @@
+#include "tilePrefetch.h"
+#include "gfxDecode.h"
+#include "romEditor.h"
+
+wxThread::ExitCode TilePrefetchThread::Entry() {
+	while (_prefetcher->runJob()) {}
+	return (wxThread::ExitCode) 0;
+}
+
+TilePrefetcher::TilePrefetcher() : _condition(_mutex) {}
+
+TilePrefetcher::~TilePrefetcher() {
+	{
+		wxMutexLocker locker(_mutex);
+		_stopping = true;
+		_jobs.clear();
+		_condition.Broadcast();
+	}
+
+	for (int i = 0; i < _threads.size(); i++) {
+		_threads[i]->Wait();
+		delete _threads[i];
+	}
+}
+
+void TilePrefetcher::start() {
+	// One core is left for the UI thread, which is still drawing the visible tiles
+	int count = wxThread::GetCPUCount() - 1;
+	if (count < 1) {
+		count = 1;
+	}
+	if (count > kPrefetchMaxThreads) {
+		count = kPrefetchMaxThreads;
+	}
+
+	for (int i = 0; i < count; i++) {
+		TilePrefetchThread *thread = new TilePrefetchThread(this);
+		if (thread->Run() != wxTHREAD_NO_ERROR) {
+			delete thread;
+			break;
+		}
+		thread->SetPriority(wxPRIORITY_MIN);
+		_threads.push_back(thread);
+	}
+}
+
+void TilePrefetcher::scrolled(int firstRow) {
+	// The history is just shifted along, since it is only a few entries
+	if (_scrollCount == kPrefetchHistory) {
+		for (int i = 1; i < kPrefetchHistory; i++) {
+			_scrollTimes[i - 1] = _scrollTimes[i];
+			_scrollRows[i - 1] = _scrollRows[i];
+		}
+		_scrollCount--;
+	}
+
+	_scrollTimes[_scrollCount] = wxGetLocalTimeMillis();
+	_scrollRows[_scrollCount] = firstRow;
+	_scrollCount++;
+}
+
+int TilePrefetcher::rowsAhead(int visibleRows) {
+	// Without a recent scroll, we prefetch one screen in whichever direction the view last went
+	double speed = 0;
+	if (_scrollCount >= 2) {
+		wxLongLong now = wxGetLocalTimeMillis();
+		int newest = _scrollCount - 1;
+		int oldest = newest;
+		while ((oldest > 0) && ((now - _scrollTimes[oldest - 1]) < kPrefetchWindow)) {
+			oldest--;
+		}
+
+		int rows = _scrollRows[newest] - _scrollRows[oldest];
+		double time = (_scrollTimes[newest] - _scrollTimes[oldest]).ToDouble();
+		if (rows != 0) {
+			_direction = (rows > 0) ? 1 : -1;
+		}
+		if (time > 0) {
+			speed = abs(rows) / time;
+		}
+	}
+
+	// Faster scrolling gets more screens ahead, enough to cover about half a second
+	int screens = 1 + (int) ((speed * kPrefetchWindow) / wxMax(visibleRows, 1));
+	if (screens > kPrefetchMaxScreens) {
+		screens = kPrefetchMaxScreens;
+	}
+	return _direction * screens * visibleRows;
+}
+
+void TilePrefetcher::queue(wxVector<PrefetchJob> &jobs) {
+	if (_threads.empty()) {
+		start();
+	}
+
+	wxMutexLocker locker(_mutex);
+	_generation++;
+	_jobs.clear();
+	for (int i = 0; i < jobs.size(); i++) {
+		jobs[i]._generation = _generation;
+		_jobs.push_back(jobs[i]);
+	}
+	_condition.Broadcast();
+}
+
+void TilePrefetcher::cancel() {
+	wxMutexLocker locker(_mutex);
+	_generation++;
+	_jobs.clear();
+	_scrollCount = 0;
+}
+
+bool TilePrefetcher::isStale(unsigned int generation) {
+	wxMutexLocker locker(_mutex);
+	return generation != _generation;
+}
+
+bool TilePrefetcher::runJob() {
+	PrefetchJob job;
+	{
+		wxMutexLocker locker(_mutex);
+		while (_jobs.empty() && !_stopping) {
+			_condition.Wait();
+		}
+		if (_stopping) {
+			return false;
+		}
+		job = _jobs.front();
+		_jobs.pop_front();
+	}
+
+	TileDecoder decoder = getTileDecoder(job._key._gfxType, job._key._bitDepth);
+	DirectDecoder direct = (job._key._gfxType == kGfxTypeRGB) ? getDirectDecoder(job._key._bitDepth) : nullptr;
+	if (((decoder == nullptr) && (direct == nullptr)) || (_cache == nullptr)) {
+		return true;
+	}
+
+	TileKey key = job._key;
+	wxByte pixels[kGfxTilePixels];
+	unsigned char rgb[kTileRGBBytes];
+	for (int t = 0; t < job._tiles; t++) {
+		// If the view jumped or scrolled somewhere else, the rest of the row isn't wanted anymore
+		if (isStale(job._generation)) {
+			return true;
+		}
+
+		key._offset = job._offset + (t * job._stride);
+		if (_cache->contains(key)) {
+			continue;
+		}
+
+		if (direct != nullptr) {
+			direct(&job._bytes[t * job._stride], rgb, kGfxTilePixels);
+		} else {
+			decoder(&job._bytes[t * job._stride], pixels);
+			for (int i = 0; i < kGfxTilePixels; i++) {
+				memcpy(&rgb[i * 3], &job._colours[pixels[i] * 3], 3);
+			}
+		}
+		_cache->addIfUnchanged(key, rgb, job._tileBytes, job._writes);
+	}
+	return true;
+}
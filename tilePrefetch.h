@@ -0,0 +1,92 @@
+#ifndef HEXER_TILEPREFETCH_H
+#define HEXER_TILEPREFETCH_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+#include <wx/thread.h>
+#include <deque>
+
+#include "tileCache.h"
+
+enum TilePrefetchValues {
+	kPrefetchHistory    = 8,				// How many scroll events are remembered
+	kPrefetchWindow     = 500,				// And how recent (in ms) they have to be to count towards the speed
+	kPrefetchMaxScreens = 4,				// The most screens of tiles that are decoded ahead
+	kPrefetchMaxThreads = 4
+};
+
+// One row of tiles to decode, with the bytes already read from the rom
+struct PrefetchJob {
+	TileKey _key;							// Everything about the tiles except the offset
+	int _offset = 0;						// Offset of the first tile in the row
+	int _stride = 0;
+	int _tileBytes = 0;
+	int _tiles = 0;							// How many tiles of the row are part of the rom
+	wxVector<wxByte> _bytes;
+	unsigned int _generation = 0;			// Which round of prefetching the job is from
+	unsigned int _writes = 0;				// How many writes the cache had seen when the bytes were read
+	unsigned char _colours[256 * 3];
+};
+
+class TilePrefetcher;
+
+class TilePrefetchThread : public wxThread {
+public:
+	TilePrefetchThread(TilePrefetcher *prefetcher) : wxThread(wxTHREAD_JOINABLE) {
+		_prefetcher = prefetcher;
+	}
+
+protected:
+	ExitCode Entry() wxOVERRIDE;
+
+private:
+	TilePrefetcher *_prefetcher;
+};
+
+/* Hexer Tile Prefetcher
+ * Watches how fast and which way the gfx view is scrolling, and decodes the
+ * next few screens of tiles into the tile cache on background threads. The visible
+ * tiles are always drawn on the UI thread, so they never wait on prefetching,
+ * and a new round of prefetching (or a jump to a new offset) throws out any work that
+ * hasn't started. The threads never touch the rom, only bytes read for them ahead of time.
+ */
+class TilePrefetcher {
+public:
+	TilePrefetcher();
+	~TilePrefetcher();
+
+	void setCache(TileCache *cache) { _cache = cache; }
+
+	void scrolled(int firstRow);			// Remembers where and when the view scrolled to
+	 int rowsAhead(int visibleRows);		// How many rows should be prefetched, negative meaning above the view
+	void queue(wxVector<PrefetchJob> &jobs);	// Replaces any jobs that are still waiting
+	void cancel();							// Drops all of the waiting jobs and the scroll history
+
+	bool runJob();							// Called by the threads, returns false when they should stop
+
+private:
+	TileCache *_cache = nullptr;
+	wxVector<TilePrefetchThread *> _threads;
+
+	wxMutex _mutex;
+	wxCondition _condition;
+	std::deque<PrefetchJob> _jobs;
+	bool _stopping = false;
+	unsigned int _generation = 0;
+
+	wxLongLong _scrollTimes[kPrefetchHistory];
+	int _scrollRows[kPrefetchHistory];
+	int _scrollCount = 0;
+	int _direction = 1;
+
+	void start();
+	bool isStale(unsigned int generation);
+};
+
+#endif
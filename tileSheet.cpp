@@ -0,0 +1,347 @@
+#include "tileSheet.h"
+#include "gfxDecode.h"
+#include "gfxBackbuffer.h"
+
+// Width and height in tiles of each block arrangement
+static const int kBlockWidth[3]  = {1, 1, 2};
+static const int kBlockHeight[3] = {1, 2, 2};
+
+TileSheet::TileSheet(wxWindow *parent, RomEditorTable *table) : wxScrolledCanvas(parent, wxID_ANY) {
+	_table = table;
+	_rom = table->_rom;
+	_layout._offset = table->_offset;
+	SetBackgroundColour(wxColour(64, 64, 64));
+
+	buildMap();
+	_rom->addListener(this);
+}
+
+TileSheet::~TileSheet() {
+	_rom->removeListener(this);
+}
+
+void TileSheet::setLayout(const TileSheetLayout &layout) {
+	if (layout == _layout) {
+		return;
+	}
+	_layout = layout;
+	buildMap();
+	Refresh();
+}
+
+int TileSheet::layoutStride() {
+	if (!isBitmap()) {
+		return _table->_gfxByteSize;
+	}
+	if (_layout._lineBytes > 0) {
+		return _layout._lineBytes;
+	}
+
+	// Bitmaps are only direct colour, so anything else is treated as a byte per pixel (and not drawn)
+	int pixelBytes = (_table->_gfxType->GetSelection() == kGfxTypeRGB) ? gfxPixelBytes(_table->gfxDepth()) : 1;
+	return _layout._width * wxMax(1, pixelBytes);
+}
+
+/* Works out where every tile goes. Blocks fill the rows of the sheet left to right, and
+ * the tiles of a block go across then down (or down then across if it is column major)
+ */
+void TileSheet::buildMap() {
+	_stride = layoutStride();
+	if (isBitmap()) {
+		_count = 0;
+		if ((_stride > 0) && (_layout._offset < _rom->size())) {
+			_count = (_rom->size() - _layout._offset) / _stride;
+		}
+		_columns = _layout._width;
+		_rows = _count;
+
+		SetScrollRate(8 * _layout._zoom, 8 * _layout._zoom);
+		SetVirtualSize(_columns * _layout._zoom, _rows * _layout._zoom);
+		_bufferValid = false;
+		return;
+	}
+
+	_blockWidth = kBlockWidth[_layout._arrangement];
+	_blockHeight = kBlockHeight[_layout._arrangement];
+	int blockTiles = _blockWidth * _blockHeight;
+
+	_count = 0;
+	if ((_stride > 0) && (_layout._offset < _rom->size())) {
+		_count = (_rom->size() - _layout._offset) / _stride;
+	}
+
+	_blocksPerRow = wxMax(1, _layout._tilesPerRow / _blockWidth);
+	int blocks = (_count + blockTiles - 1) / blockTiles;
+	_columns = _blocksPerRow * _blockWidth;
+	_rows = ((blocks + _blocksPerRow - 1) / _blocksPerRow) * _blockHeight;
+
+	for (int i = 0; i < blockTiles; i++) {
+		int x = 0;
+		int y = 0;
+		if (_layout._columnMajor) {
+			x = i / _blockHeight;
+			y = i % _blockHeight;
+		} else {
+			x = i % _blockWidth;
+			y = i / _blockWidth;
+		}
+		_inBlock[(y * _blockWidth) + x] = i;
+	}
+
+	int tileSize = 8 * _layout._zoom;
+	SetScrollRate(tileSize, tileSize);
+	SetVirtualSize(_columns * tileSize, _rows * tileSize);
+	_bufferValid = false;
+}
+
+int TileSheet::tileAt(int x, int y) {
+	int block = ((y / _blockHeight) * _blocksPerRow) + (x / _blockWidth);
+	int index = (block * _blockWidth * _blockHeight) + _inBlock[((y % _blockHeight) * _blockWidth) + (x % _blockWidth)];
+	return (index < _count) ? index : -1;
+}
+
+void TileSheet::OnDraw(wxDC &dc) {
+	// The gfx panel can change the depth or palette at any time, which we only find out about when drawing
+	TileKey format;
+	format._bitDepth = _table->gfxDepth();
+	format._gfxType = _table->_gfxType->GetSelection();
+	format._palette = _table->_gfxPaletteId;
+	format._brightness = 8 - _table->_gfxPalCtrl->GetValue();
+
+	if (_stride != layoutStride()) {
+		buildMap();
+	}
+	if (!(format == _format)) {
+		_format = format;
+		_bufferValid = false;
+	}
+
+	// The buffer only needs to cover the tiles (or pixels) that are at least partly visible
+	int tileSize = positionSize();
+	int x = 0;
+	int y = 0;
+	CalcUnscrolledPosition(0, 0, &x, &y);
+	wxSize client = GetClientSize();
+
+	wxRect tiles;
+	tiles.x = x / tileSize;
+	tiles.y = y / tileSize;
+	tiles.width = wxMin(_columns, ((x + client.GetWidth() + tileSize - 1) / tileSize)) - tiles.x;
+	tiles.height = wxMin(_rows, ((y + client.GetHeight() + tileSize - 1) / tileSize)) - tiles.y;
+	if ((tiles.width <= 0) || (tiles.height <= 0)) {
+		return;
+	}
+
+	if (!_bufferValid || (tiles != _bufferTiles)) {
+		if (isBitmap()) {
+			renderBitmap(tiles);
+		} else {
+			renderBuffer(tiles);
+		}
+	}
+	dc.DrawBitmap(_bitmap, _bufferTiles.x * tileSize, _bufferTiles.y * tileSize);
+}
+
+void TileSheet::renderBuffer(const wxRect &tiles) {
+	int zoom = _layout._zoom;
+	int tileSize = 8 * zoom;
+	int width = tiles.width * tileSize;
+
+	// Positions without a tile are left the same grey as the background
+	_rgb.assign(width * tiles.height * tileSize * 3, 64);
+
+	TileDecoder decoder = getTileDecoder(_format._gfxType, _format._bitDepth);
+	DirectDecoder direct = (_format._gfxType == kGfxTypeRGB) ? getDirectDecoder(_format._bitDepth) : nullptr;
+	if ((decoder != nullptr) || (direct != nullptr)) {
+		int tileBytes = gfxTileBytes(_format._gfxType, _format._bitDepth);
+		unsigned char colours[256 * 3];
+		gfxColours(_table, _format._brightness, colours);
+
+		TileKey key = _format;
+		unsigned char tile[kTileRGBBytes];
+		wxVector<unsigned char> line(tileSize * 3);
+
+		for (int row = 0; row < tiles.height; row++) {
+			for (int col = 0; col < tiles.width; col++) {
+				int index = tileAt(tiles.x + col, tiles.y + row);
+				if (index == -1) {
+					continue;
+				}
+
+				key._offset = _layout._offset + (index * _stride);
+				gfxTileRGB(_table, key, decoder, direct, tileBytes, colours, tile);
+
+				// Each line of the tile is widened once, and then copied for as many lines as the zoom
+				for (int ty = 0; ty < 8; ty++) {
+					for (int tx = 0; tx < 8; tx++) {
+						for (int z = 0; z < zoom; z++) {
+							memcpy(&line[((tx * zoom) + z) * 3], &tile[((ty * 8) + tx) * 3], 3);
+						}
+					}
+
+					for (int z = 0; z < zoom; z++) {
+						int py = (row * tileSize) + (ty * zoom) + z;
+						memcpy(&_rgb[((py * width) + (col * tileSize)) * 3], &line[0], tileSize * 3);
+					}
+				}
+			}
+		}
+	}
+
+	wxImage image(width, tiles.height * tileSize, &_rgb[0], true);
+	_bitmap = wxBitmap(image);
+	_bufferTiles = tiles;
+	_bufferValid = true;
+}
+
+void TileSheet::renderBitmap(const wxRect &pixels) {
+	int zoom = _layout._zoom;
+	int width = pixels.width * zoom;
+	_rgb.assign(width * pixels.height * zoom * 3, 64);
+
+	DirectDecoder direct = (_format._gfxType == kGfxTypeRGB) ? getDirectDecoder(_format._bitDepth) : nullptr;
+	if (direct != nullptr) {
+		// Only the visible part of each line is read and decoded, all in one go
+		int pixelBytes = gfxPixelBytes(_format._bitDepth);
+		wxVector<wxByte> data(pixels.width * pixelBytes);
+		wxVector<unsigned char> rgb(pixels.width * 3);
+		wxVector<unsigned char> line(width * 3);
+
+		for (int y = 0; y < pixels.height; y++) {
+			int offset = _layout._offset + ((pixels.y + y) * _stride) + (pixels.x * pixelBytes);
+			int length = _rom->readBytes(offset, &data[0], data.size());
+			if (length < pixelBytes) {
+				continue;
+			}
+
+			int count = length / pixelBytes;
+			direct(&data[0], &rgb[0], count);
+
+			if (zoom == 1) {
+				memcpy(&_rgb[(y * width) * 3], &rgb[0], count * 3);
+				continue;
+			}
+
+			// The line is widened once, and then copied for as many lines as the zoom
+			for (int x = 0; x < count; x++) {
+				for (int z = 0; z < zoom; z++) {
+					memcpy(&line[((x * zoom) + z) * 3], &rgb[x * 3], 3);
+				}
+			}
+			for (int z = 0; z < zoom; z++) {
+				memcpy(&_rgb[(((y * zoom) + z) * width) * 3], &line[0], count * zoom * 3);
+			}
+		}
+	}
+
+	wxImage image(width, pixels.height * zoom, &_rgb[0], true);
+	_bitmap = wxBitmap(image);
+	_bufferTiles = pixels;
+	_bufferValid = true;
+}
+
+void TileSheet::onRomWrite(int offset, int length) {
+	// The cache throws out the old tiles by itself, we just have to draw again if the write was on the sheet
+	int end = _layout._offset + (_count * _stride) + kGfxMaxTileBytes;
+	if ((offset < end) && ((offset + length) > _layout._offset)) {
+		_bufferValid = false;
+		Refresh();
+	}
+}
+
+void TileSheet::onRomResize(int offset, int change) {
+	buildMap();
+	Refresh();
+}
+
+TileSheetFrame::TileSheetFrame(wxWindow *parent, RomEditorTable *table) : wxFrame(parent, wxID_ANY, "Tile Sheet", wxDefaultPosition, wxSize(640, 600)) {
+	wxPanel *panel = new wxPanel(this);
+	_sheet = new TileSheet(panel, table);
+
+	// The controls go along the top of the window
+	wxBoxSizer *controls = new wxBoxSizer(wxHORIZONTAL);
+
+	wxStaticText *offsetTxt = new wxStaticText(panel, wxID_ANY, "Offset $");
+	_offsetCtrl = new wxTextCtrl(panel, wxID_ANY, wxString::Format("%X", table->_offset), wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
+	_offsetCtrl->Bind(wxEVT_TEXT_ENTER, &TileSheetFrame::onLayoutChanged, this);
+
+	wxStaticText *tilesPerRowTxt = new wxStaticText(panel, wxID_ANY, "Tiles per row ");
+	_tilesPerRowCtrl = new wxSpinCtrl(panel, wxID_ANY, "16", wxDefaultPosition, wxDefaultSize, 0, 1, 256, 16);
+	_tilesPerRowCtrl->Bind(wxEVT_SPINCTRL, &TileSheetFrame::onLayoutChanged, this);
+
+	wxStaticText *arrangementTxt = new wxStaticText(panel, wxID_ANY, "Blocks ");
+	wxString arrangementChoices[4] = {"8x8", "8x16", "16x16", "Bitmap (RGB)"};
+	_arrangementCtrl = new wxChoice(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, 4, arrangementChoices);
+	_arrangementCtrl->SetSelection(kTileArrange8x8);
+	_arrangementCtrl->Bind(wxEVT_CHOICE, &TileSheetFrame::onLayoutChanged, this);
+
+	_columnMajorCtrl = new wxCheckBox(panel, wxID_ANY, "Column major");
+	_columnMajorCtrl->Bind(wxEVT_CHECKBOX, &TileSheetFrame::onLayoutChanged, this);
+
+	wxStaticText *zoomTxt = new wxStaticText(panel, wxID_ANY, "Zoom ");
+	_zoomCtrl = new wxSpinCtrl(panel, wxID_ANY, "2", wxDefaultPosition, wxDefaultSize, 0, 1, 8, 2);
+	_zoomCtrl->Bind(wxEVT_SPINCTRL, &TileSheetFrame::onLayoutChanged, this);
+
+	// Bitmaps have a second row of controls for the size of each line
+	wxBoxSizer *bitmapControls = new wxBoxSizer(wxHORIZONTAL);
+
+	wxStaticText *widthTxt = new wxStaticText(panel, wxID_ANY, "Bitmap width ");
+	_widthCtrl = new wxSpinCtrl(panel, wxID_ANY, "256", wxDefaultPosition, wxDefaultSize, 0, 1, 4096, 256);
+	_widthCtrl->Bind(wxEVT_SPINCTRL, &TileSheetFrame::onLayoutChanged, this);
+
+	wxStaticText *lineBytesTxt = new wxStaticText(panel, wxID_ANY, "Bytes per line (0 for packed) ");
+	_lineBytesCtrl = new wxSpinCtrl(panel, wxID_ANY, "0", wxDefaultPosition, wxDefaultSize, 0, 0, 65536, 0);
+	_lineBytesCtrl->Bind(wxEVT_SPINCTRL, &TileSheetFrame::onLayoutChanged, this);
+
+	bitmapControls->Add(widthTxt, 0, wxALIGN_CENTER_VERTICAL);
+	bitmapControls->Add(_widthCtrl, 0, wxRIGHT, 10);
+	bitmapControls->Add(lineBytesTxt, 0, wxALIGN_CENTER_VERTICAL);
+	bitmapControls->Add(_lineBytesCtrl);
+
+	controls->Add(offsetTxt, 0, wxALIGN_CENTER_VERTICAL);
+	controls->Add(_offsetCtrl, 0, wxRIGHT, 10);
+	controls->Add(tilesPerRowTxt, 0, wxALIGN_CENTER_VERTICAL);
+	controls->Add(_tilesPerRowCtrl, 0, wxRIGHT, 10);
+	controls->Add(arrangementTxt, 0, wxALIGN_CENTER_VERTICAL);
+	controls->Add(_arrangementCtrl, 0, wxRIGHT, 10);
+	controls->Add(_columnMajorCtrl, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 10);
+	controls->Add(zoomTxt, 0, wxALIGN_CENTER_VERTICAL);
+	controls->Add(_zoomCtrl);
+
+	wxBoxSizer *sizer = new wxBoxSizer(wxVERTICAL);
+	sizer->Add(controls, 0, wxALL, 6);
+	sizer->Add(bitmapControls, 0, wxLEFT | wxRIGHT | wxBOTTOM, 6);
+	sizer->Add(_sheet, 1, wxGROW);
+	panel->SetSizer(sizer);
+
+	Bind(wxEVT_CLOSE_WINDOW, &TileSheetFrame::onClose, this);
+}
+
+void TileSheetFrame::onLayoutChanged(wxCommandEvent &event) {
+	TileSheetLayout layout = _sheet->layout();
+
+	// If the offset isn't valid hex, the old one is put back in the box
+	unsigned int offset = 0;
+	if (sscanf(_offsetCtrl->GetValue().c_str(), "%x", &offset) == 1) {
+		layout._offset = offset;
+	} else {
+		_offsetCtrl->ChangeValue(wxString::Format("%X", layout._offset));
+	}
+
+	layout._tilesPerRow = _tilesPerRowCtrl->GetValue();
+	layout._arrangement = _arrangementCtrl->GetSelection();
+	layout._columnMajor = _columnMajorCtrl->GetValue();
+	layout._zoom = _zoomCtrl->GetValue();
+	layout._width = _widthCtrl->GetValue();
+	layout._lineBytes = _lineBytesCtrl->GetValue();
+	_sheet->setLayout(layout);
+}
+
+void TileSheetFrame::onClose(wxCloseEvent &event) {
+	if (event.CanVeto()) {
+		event.Veto();
+		Hide();
+		return;
+	}
+	event.Skip();
+}
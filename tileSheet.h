@@ -0,0 +1,123 @@
+#ifndef HEXER_TILESHEET_H
+#define HEXER_TILESHEET_H
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include <wx/wxprec.h>
+
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/vector.h>
+#include <wx/scrolwin.h>
+#include <wx/spinctrl.h>
+
+#include "rom.h"
+#include "romEditor.h"
+
+enum TileSheetArrangement {
+	kTileArrange8x8,
+	kTileArrange8x16,
+	kTileArrange16x16,
+	kTileArrangeBitmap						// Not tiles at all, but lines of direct colour pixels
+};
+
+// How the tiles of the sheet are laid out
+struct TileSheetLayout {
+	int  _offset = 0;						// Offset of the first tile
+	int  _tilesPerRow = 16;					// Rounded down to a whole number of blocks
+	int  _arrangement = kTileArrange8x8;	// The size of each block of tiles
+	bool _columnMajor = false;				// If the tiles within a block go down first instead of across
+	int  _zoom = 2;
+	int  _width = 256;						// Pixels per line of a bitmap
+	int  _lineBytes = 0;					// Bytes from one line of a bitmap to the next, or 0 if the lines are packed
+
+	bool operator==(const TileSheetLayout &other) const {
+		return (_offset == other._offset) && (_tilesPerRow == other._tilesPerRow) && (_arrangement == other._arrangement)
+			&& (_columnMajor == other._columnMajor) && (_zoom == other._zoom) && (_width == other._width) && (_lineBytes == other._lineBytes);
+	}
+};
+
+/* Hexer Tile Sheet
+ * Shows every tile from an offset to the end of the rom as one big sheet,
+ * with any number of tiles per row, grouped into 8x8, 8x16 or 16x16 blocks.
+ * Every block is laid out the same way, so the layout is turned into a map of just one
+ * block, from each position in it to the tile that goes there. Changing the layout only
+ * remakes that map, and the tile at any position of the sheet is worked out from which
+ * block it is in and where it is in the block. The visible part of the sheet is drawn into one
+ * buffer, with the tiles coming from (and going into) the same cache as the gfx view.
+ * For RGB gfx the sheet can also be a plain bitmap, for things like framebuffer dumps,
+ * where each line is decoded straight into the buffer.
+ */
+class TileSheet : public wxScrolledCanvas, public RomListener {
+public:
+	TileSheet(wxWindow *parent, RomEditorTable *table);
+	~TileSheet();
+
+	void setLayout(const TileSheetLayout &layout);
+	const TileSheetLayout &layout() { return _layout; }
+
+	void OnDraw(wxDC &dc) wxOVERRIDE;
+
+	void onRomWrite(int offset, int length) wxOVERRIDE;
+	void onRomResize(int offset, int change) wxOVERRIDE;
+
+private:
+	RomEditorTable *_table;
+	Rom *_rom;								// Kept apart from the table, since the table can be gone by the time the window is
+	TileSheetLayout _layout;
+
+	/* The map of one block, where each position has the index of its tile within the block.
+	 * For a bitmap there is no map, each position is just a pixel, and each row is a line
+	 */
+	int _stride = 0;						// Bytes per tile, or per line of a bitmap
+	int _count = 0;
+	int _columns = 0;
+	int _rows = 0;
+	int _blocksPerRow = 0;
+	int _blockWidth = 1;
+	int _blockHeight = 1;
+	int _inBlock[4];
+
+	// The buffer holds the rectangle of positions that was visible when it was drawn
+	TileKey _format;
+	wxRect _bufferTiles;
+	bool _bufferValid = false;
+	wxVector<unsigned char> _rgb;
+	wxBitmap _bitmap;
+
+	bool isBitmap() { return _layout._arrangement == kTileArrangeBitmap; }
+	 int layoutStride();
+	 int positionSize() { return isBitmap() ? _layout._zoom : (8 * _layout._zoom); }
+
+	void buildMap();
+	 int tileAt(int x, int y);				// The index of the tile at a position, or -1 past the last tile
+	void renderBuffer(const wxRect &tiles);
+	void renderBitmap(const wxRect &pixels);
+};
+
+/* Hexer Tile Sheet Frame
+ * A separate window with the sheet, and the controls for its layout.
+ * Closing it only hides it, so the layout is still there when it is opened again
+ */
+class TileSheetFrame : public wxFrame {
+public:
+	TileSheetFrame(wxWindow *parent, RomEditorTable *table);
+
+	void refreshSheet() { _sheet->Refresh(); }
+
+private:
+	TileSheet *_sheet;
+	wxTextCtrl *_offsetCtrl;
+	wxSpinCtrl *_tilesPerRowCtrl;
+	  wxChoice *_arrangementCtrl;
+	wxCheckBox *_columnMajorCtrl;
+	wxSpinCtrl *_zoomCtrl;
+	wxSpinCtrl *_widthCtrl;
+	wxSpinCtrl *_lineBytesCtrl;
+
+	void onLayoutChanged(wxCommandEvent &event);
+	void onClose(wxCloseEvent &event);
+};
+
+#endif